@@ -1,3 +1,6 @@
+#include "parallel_algorithms.hpp"
+#include "thread_pool.hpp"
+
 #include <atomic>
 #include <chrono>
 #include <cstdlib>
@@ -6,6 +9,7 @@
 #include <iostream>
 #include <numeric>
 #include <random>
+#include <ranges>
 #include <thread>
 
 /*******************************************************
@@ -179,6 +183,48 @@ namespace Futures
     }
 } // namespace Futures
 
+namespace ParallelAlgorithms
+{
+    // x and y as 31-bit fixed-point numbers from a single 64-bit draw: hit <=> x^2 + y^2 < 1.0^2
+    // (~3x faster than two uniform_real_distribution draws; a threshold table per x is not faster
+    // than the two multiplications - see benchmarks/lookup_table_bench.cpp)
+    uintmax_t calc_hits(const uintmax_t count, const uint64_t seed)
+    {
+        constexpr int coordinate_bits = 31;
+        constexpr uint64_t one_squared = uint64_t{1} << (2 * coordinate_bits);
+
+        std::mt19937_64 rnd_gen(seed);
+
+        uintmax_t hits = 0;
+        for (uintmax_t n = 0; n < count; ++n) // hot-loop
+        {
+            const uint64_t r = rnd_gen();
+            const uint64_t x = r >> (64 - coordinate_bits);
+            const uint64_t y = r & ((uint64_t{1} << coordinate_bits) - 1);
+            hits += (x * x + y * y < one_squared);
+        }
+        return hits;
+    }
+
+    // chunks instead of threads - seeded per chunk, because one worker runs many chunks
+    double multi_thread_pi(ThreadPool& pool, const uintmax_t count, const size_t no_of_chunks = 64)
+    {
+        const uintmax_t count_per_chunk = count / no_of_chunks;
+        const uintmax_t remainder = count % no_of_chunks; // first chunks take one extra sample each
+        const auto chunks = std::views::iota(size_t{0}, no_of_chunks);
+
+        const uintmax_t hits = parallel::transform_reduce(pool, chunks.begin(), chunks.end(), uintmax_t{}, std::plus<>{},
+            [=](size_t chunk) {
+                const uintmax_t chunk_count = count_per_chunk + (chunk < remainder ? 1 : 0);
+                return calc_hits(chunk_count, std::hash<size_t>{}(chunk) ^ 0x9E3779B97F4A7C15ull);
+            }, 1);
+
+        const double pi = static_cast<double>(hits) / count * 4;
+
+        return pi;
+    }
+} // namespace ParallelAlgorithms
+
 int main()
 {
     const size_t no_of_threads = std::thread::hardware_concurrency();
@@ -261,4 +307,21 @@ int main()
         cout << "Pi = " << pi << endl;
         cout << "Elapsed = " << elapsed_time << "ms" << endl;
     }
+
+    //////////////////////////////////////////////////////////////////////////////
+    // thread pool + parallel::transform_reduce
+    {
+        ThreadPool pool(no_of_threads);
+
+        cout << "ThreadPool + parallel::transform_reduce - Pi calculation started!" << endl;
+        const auto start = chrono::high_resolution_clock::now();
+
+        const double pi = ParallelAlgorithms::multi_thread_pi(pool, N);
+
+        const auto end = chrono::high_resolution_clock::now();
+        const auto elapsed_time = chrono::duration_cast<chrono::milliseconds>(end - start).count();
+
+        cout << "Pi = " << pi << endl;
+        cout << "Elapsed = " << elapsed_time << "ms" << endl;
+    }
 }
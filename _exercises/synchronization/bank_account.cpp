@@ -1,3 +1,6 @@
+#include "ordered_lock.hpp"
+#include "profiled_mutex.hpp"
+
 #include <iostream>
 #include <thread>
 #include <mutex>
@@ -6,12 +9,15 @@ class BankAccount
 {
     const int id_;
     double balance_;
-    mutable std::recursive_mutex mtx_balance_;
+
+    using Mutex = RankedMutex<ProfiledMutex<std::recursive_mutex, "BankAccount::mtx_balance_">>;
+    mutable Mutex mtx_balance_; // rank == account id - multi-account operations lock in increasing id order
 
 public:
     BankAccount(int id, double balance)
         : id_(id)
         , balance_(balance)
+        , mtx_balance_(static_cast<uint64_t>(id))
     {
     }
 
@@ -22,13 +28,7 @@ public:
 
     void transfer(BankAccount& to, double amount)
     {
-        #if __cplusplus < 201703L
-        std::unique_lock lk_from(mtx_balance_, std::defer_lock);
-        std::unique_lock lk_to(to.mtx_balance_, std::defer_lock);
-        std::lock(lk_from, lk_to);
-        #else
-        std::scoped_lock lk{mtx_balance_, to.mtx_balance_};
-        #endif  
+        OrderedLock lk{mtx_balance_, to.mtx_balance_}; // no lock-try-back-off rounds of std::scoped_lock
 
         balance_ -= amount;
         to.balance_ += amount;
@@ -57,7 +57,7 @@ public:
         return balance_;
     }
 
-    std::unique_lock<std::recursive_mutex> with_lock()
+    std::unique_lock<Mutex> with_lock()
     {
         return std::unique_lock{mtx_balance_};
     }
@@ -111,4 +111,6 @@ int main()
     std::cout << "After all threads are done: ";
     ba1.print();
     ba2.print();
+
+    LockProfiling::report(std::cout);
 }
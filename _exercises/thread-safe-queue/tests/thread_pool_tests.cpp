@@ -0,0 +1,1015 @@
+#include "arena_resource.hpp"
+#include "concurrent_hash_map.hpp"
+#include "console_sink.hpp"
+#include "elastic_thread_pool.hpp"
+#include "future_cache.hpp"
+#include "lookup_table.hpp"
+#include "numa_thread_pool.hpp"
+#include "ordered_lock.hpp"
+#include "parallel_algorithms.hpp"
+#include "pipeline.hpp"
+#include "profiled_mutex.hpp"
+#include "rcu_cell.hpp"
+#include "spin_lock.hpp"
+#include "task_context.hpp"
+#include "task_group.hpp"
+#include "thread_pool.hpp"
+#include "timer_service.hpp"
+#include "trace_recorder.hpp"
+#include "worker_team.hpp"
+
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <atomic>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <exception>
+#include <expected>
+#include <future>
+#include <latch>
+#include <mutex>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+template <typename F>
+bool eventually(F condition, chrono::milliseconds timeout = 5s)
+{
+    const auto deadline = chrono::steady_clock::now() + timeout;
+    while (!condition())
+    {
+        if (chrono::steady_clock::now() > deadline)
+            return false;
+        this_thread::sleep_for(1ms);
+    }
+    return true;
+}
+
+// of all threads of the process
+long context_switches()
+{
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_nvcsw + usage.ru_nivcsw;
+}
+
+TEST_CASE("ElasticThreadPool")
+{
+    SECTION("idle pool is not polled")
+    {
+        ElasticThreadPool pool{{.min_threads = 1, .max_threads = 2, .spawn_threshold = 2ms}};
+        pool.submit([] {}).get();
+        this_thread::sleep_for(10ms);
+
+        const auto before = context_switches();
+        this_thread::sleep_for(200ms); // 200 supervisor ticks
+        REQUIRE(context_switches() - before < 20);
+    }
+
+    SECTION("overdue tasks start workers one per tick")
+    {
+        ElasticThreadPool pool{{.min_threads = 1, .max_threads = 8, .spawn_threshold = 40ms}};
+        promise<void> release;
+        shared_future<void> released = release.get_future().share();
+
+        vector<future<void>> results;
+        for (int i = 0; i < 8; ++i)
+            results.push_back(pool.submit([released] { released.wait(); }));
+
+        REQUIRE(eventually([&pool] { return pool.thread_count() >= 2; }));
+        REQUIRE(pool.thread_count() <= 3); // the next one comes 20ms later - not all 7 at once
+
+        release.set_value();
+        for (auto& result : results)
+            result.get();
+    }
+
+    SECTION("blocked tasks get compensating workers - up to max_blocked_compensation")
+    {
+        ElasticThreadPool pool{{.min_threads = 1, .max_threads = 2, .spawn_threshold = 1ms, .max_blocked_compensation = 3}};
+        promise<void> release;
+        shared_future<void> released = release.get_future().share();
+
+        vector<future<void>> results;
+        for (int i = 0; i < 20; ++i)
+        {
+            results.push_back(pool.submit([&pool, released] {
+                auto blocking = pool.blocking_section();
+                released.wait();
+            }));
+        }
+
+        REQUIRE(eventually([&pool] { return pool.blocked_count() == 5; }));
+        this_thread::sleep_for(50ms); // the supervisor sees overdue tasks all the time
+        REQUIRE(pool.thread_count() == 5);
+        REQUIRE(pool.pending_count() == 15);
+
+        release.set_value();
+        for (auto& result : results)
+            result.get();
+    }
+}
+
+TEST_CASE("NumaThreadPool")
+{
+    const CpuTopology two_nodes{{{0}, {0}}}; // both on cpu 0 - runs on any machine
+
+    SECTION("fewer workers than nodes - every task runs")
+    {
+        NumaThreadPool pool{two_nodes, 1};
+        REQUIRE(pool.node_count() == 1);
+
+        vector<future<int>> results;
+        for (int i = 0; i < 10; ++i)
+            results.push_back(pool.submit([i] { return i; }));
+
+        for (int i = 0; i < 10; ++i)
+            REQUIRE(results[i].get() == i);
+    }
+
+    SECTION("unequal workers per node - every node's tasks run")
+    {
+        NumaThreadPool pool{two_nodes, 3};
+        REQUIRE(pool.node_count() == 2);
+
+        vector<future<int>> results;
+        for (int i = 0; i < 30; ++i)
+            results.push_back(i % 2 == 0 ? pool.submit([i] { return i; }) : pool.submit(1, [i] { return i; }));
+
+        for (int i = 0; i < 30; ++i)
+            REQUIRE(results[i].get() == i);
+    }
+
+    SECTION("unpinned - one queue")
+    {
+        NumaThreadPool pool{two_nodes, 2, WorkerPlacement::unpinned};
+        REQUIRE(pool.node_count() == 1);
+        REQUIRE(pool.pinned_count() == 0);
+        REQUIRE(pool.submit([] { return 42; }).get() == 42);
+    }
+}
+
+TEST_CASE("TimerService")
+{
+    TimerService timers;
+
+    SECTION("timer scheduled after a far one fires on time")
+    {
+        timers.schedule_after(10min, [] {});
+        promise<void> fired;
+        timers.schedule_after(20ms, [&fired] { fired.set_value(); });
+
+        REQUIRE(fired.get_future().wait_for(2s) == future_status::ready);
+    }
+
+    SECTION("timers across wheel levels fire in deadline order")
+    {
+        mutex mtx;
+        vector<int> fired;
+        promise<void> last_fired;
+        timers.schedule_after(600ms, [&] {
+            lock_guard lk{mtx};
+            fired.push_back(600);
+            last_fired.set_value();
+        });
+        for (int delay_ms : {300, 5, 70})
+        {
+            timers.schedule_after(chrono::milliseconds{delay_ms}, [&mtx, &fired, delay_ms] {
+                lock_guard lk{mtx};
+                fired.push_back(delay_ms);
+            });
+        }
+
+        REQUIRE(last_fired.get_future().wait_for(5s) == future_status::ready);
+        lock_guard lk{mtx};
+        REQUIRE(fired == vector{5, 70, 300, 600});
+    }
+
+    SECTION("timer thread sleeps until the nearest deadline - not every tick")
+    {
+        timers.schedule_after(10min, [] {});
+        this_thread::sleep_for(10ms);
+
+        const auto before = context_switches();
+        this_thread::sleep_for(200ms); // 200 ticks
+        REQUIRE(context_switches() - before < 20);
+    }
+}
+
+TEST_CASE("ProfiledMutex")
+{
+    SECTION("mutexes with the same name share one report row - any lockable type and sampling period")
+    {
+        ProfiledMutex<std::mutex, "profiled-mutex-test", 1> plain;
+        ProfiledMutex<std::recursive_mutex, "profiled-mutex-test", 1> recursive;
+        for (int i = 0; i < 2; ++i)
+        {
+            lock_guard lk1{plain};
+            lock_guard lk2{recursive};
+        }
+
+        const auto reports = LockProfiling::snapshot();
+        const auto count = ranges::count(reports, string{"profiled-mutex-test"}, &LockProfiling::LockReport::name);
+        REQUIRE(count == 1);
+        REQUIRE(ranges::find(reports, string{"profiled-mutex-test"}, &LockProfiling::LockReport::name)->acquisitions == 4);
+    }
+}
+
+TEST_CASE("Trace")
+{
+    SECTION("interned names outlive their strings")
+    {
+        const char* name;
+        {
+            const string dynamic = "stage#" + to_string(42);
+            name = Trace::intern(dynamic);
+        }
+        REQUIRE(name == string{"stage#42"});
+        REQUIRE(Trace::intern("stage#42") == name);
+    }
+
+    SECTION("pipeline stage events keep their names after the pipeline is gone")
+    {
+        Trace::Recorder::instance().enable();
+        {
+            ThreadPool pool{2};
+            int next = 0;
+            Pipeline::source({.name = "traced " + string{"source"}}, [&]() -> optional<int> {
+                if (next == 100)
+                    return nullopt;
+                return next++;
+            })
+                .sink({.name = "traced " + string{"sink"}}, [](int) {})
+                .run(pool);
+        }
+        Trace::Recorder::instance().disable();
+
+        ostringstream json;
+        Trace::Recorder::instance().write_chrome_json(json);
+        REQUIRE(json.str().find(R"("name":"traced source")") != string::npos);
+        REQUIRE(json.str().find(R"("name":"traced sink")") != string::npos);
+    }
+
+    SECTION("buffers of exited threads are reused once written")
+    {
+        auto& recorder = Trace::Recorder::instance();
+        auto traced_thread = [&recorder] {
+            recorder.enable();
+            thread{[] { Trace::Scope trace{"short-lived thread"}; }}.join();
+            recorder.disable();
+
+            ostringstream json;
+            recorder.write_chrome_json(json);
+        };
+
+        traced_thread();
+        const size_t buffer_count = recorder.buffer_count();
+        for (int i = 0; i < 10; ++i)
+            traced_thread();
+
+        REQUIRE(recorder.buffer_count() == buffer_count);
+    }
+}
+
+TEST_CASE("ArenaResource")
+{
+    ArenaResource arena;
+
+    SECTION("heap of an exited thread is taken over by the next new thread")
+    {
+        void* freed = nullptr;
+        thread{[&] {
+            freed = arena.allocate(32);
+            arena.deallocate(freed, 32);
+        }}.join();
+
+        void* reused = nullptr;
+        thread{[&] { reused = arena.allocate(32); }}.join();
+
+        REQUIRE(reused == freed);
+    }
+
+    SECTION("block freed by another thread goes back to its owner")
+    {
+        void* block = arena.allocate(32);
+        thread{[&] { arena.deallocate(block, 32); }}.join();
+
+        REQUIRE(arena.allocate(32) == block);
+    }
+
+    SECTION("threads may outlive the resource")
+    {
+        promise<void> resource_gone;
+        thread survivor;
+        {
+            ArenaResource short_lived;
+            promise<void> allocated;
+            survivor = thread{[&short_lived, &allocated, gone = resource_gone.get_future()] {
+                short_lived.deallocate(short_lived.allocate(64), 64);
+                allocated.set_value();
+                gone.wait(); // exits after the resource died
+            }};
+            allocated.get_future().wait();
+        }
+        resource_gone.set_value();
+        survivor.join();
+
+        REQUIRE(arena.allocate(64) != nullptr); // no stale heap handed to a new resource at the same address
+    }
+}
+
+TEST_CASE("ConcurrentHashMap")
+{
+    SECTION("insert_or_assign inserts or replaces, erase removes")
+    {
+        ConcurrentHashMap<string, int> map;
+
+        REQUIRE(map.insert_or_assign("one", 1) == true);
+        REQUIRE(map.insert_or_assign("one", 11) == false);
+        REQUIRE(map.insert_or_assign("two", 2) == true);
+        REQUIRE(map.size() == 2);
+        REQUIRE(map.find("one") == 11);
+        REQUIRE(map.contains("two"));
+        REQUIRE(map.find("three") == nullopt);
+
+        REQUIRE(map.erase("one") == true);
+        REQUIRE(map.erase("one") == false);
+        REQUIRE(map.find("one") == nullopt);
+        REQUIRE(map.size() == 1);
+    }
+
+    SECTION("update starts from V{} for an absent key")
+    {
+        ConcurrentHashMap<string, int> map;
+
+        REQUIRE(map.update("hits", [](int& hits) { ++hits; }) == true);
+        REQUIRE(map.update("hits", [](int& hits) { ++hits; }) == false);
+        REQUIRE(map.find("hits") == 2);
+
+        int seen = 0;
+        REQUIRE(map.visit("hits", [&seen](const int& hits) { seen = hits; }));
+        REQUIRE(seen == 2);
+        REQUIRE_FALSE(map.visit("misses", [](const int&) {}));
+    }
+
+    SECTION("concurrent updates of one key lose no increments")
+    {
+        ConcurrentHashMap<int, int> map;
+        {
+            vector<jthread> writers;
+            for (int t = 0; t < 4; ++t)
+            {
+                writers.emplace_back([&map] {
+                    for (int i = 0; i < 10'000; ++i)
+                        map.update(7, [](int& counter) { ++counter; });
+                });
+            }
+        }
+
+        REQUIRE(map.find(7) == 40'000);
+        REQUIRE(map.size() == 1);
+    }
+
+    SECTION("readers find every key while the table grows")
+    {
+        constexpr int stable_keys = 1000;
+        ConcurrentHashMap<int, int> map;
+        for (int key = 0; key < stable_keys; ++key)
+            map.insert_or_assign(key, key);
+        const size_t initial_bucket_count = map.bucket_count();
+
+        atomic<bool> writing{true};
+        atomic<int> misses{0};
+        {
+            vector<jthread> readers;
+            for (int t = 0; t < 3; ++t)
+            {
+                readers.emplace_back([&] {
+                    do
+                    {
+                        for (int key = 0; key < stable_keys; ++key)
+                        {
+                            if (map.find(key) != key)
+                                misses.fetch_add(1);
+                        }
+                    } while (writing.load());
+                });
+            }
+
+            for (int key = stable_keys; key < 64 * stable_keys; ++key)
+                map.insert_or_assign(key, key);
+            writing = false;
+        }
+
+        REQUIRE(misses.load() == 0);
+        REQUIRE(map.bucket_count() >= 32 * initial_bucket_count);
+        REQUIRE(map.size() == 64 * stable_keys);
+    }
+}
+
+TEST_CASE("ParallelAlgorithms")
+{
+    ThreadPool pool{4};
+
+    vector<int> data(100'000);
+    mt19937 rnd{42};
+    ranges::generate(data, [&rnd] { return static_cast<int>(rnd() % 1000); });
+
+    SECTION("results match the std:: algorithms")
+    {
+        vector<int> doubled = data;
+        parallel::for_each(pool, doubled.begin(), doubled.end(), [](int& x) { x *= 2; }, 64);
+        REQUIRE(ranges::equal(doubled, data | views::transform([](int x) { return 2 * x; })));
+
+        auto square = [](int x) { return int64_t{x} * x; };
+        REQUIRE(parallel::transform_reduce(pool, data.begin(), data.end(), int64_t{7}, plus<>{}, square, 64)
+            == std::transform_reduce(data.begin(), data.end(), int64_t{7}, plus<>{}, square));
+
+        vector<int> scanned(data.size());
+        vector<int> expected_scan(data.size());
+        parallel::inclusive_scan(pool, data.begin(), data.end(), scanned.begin(), plus<>{}, 1000);
+        std::inclusive_scan(data.begin(), data.end(), expected_scan.begin());
+        REQUIRE(scanned == expected_scan);
+
+        vector<int> sorted = data;
+        vector<int> expected_sort = data;
+        parallel::sort(pool, sorted.begin(), sorted.end(), greater<>{}, 1024);
+        std::sort(expected_sort.begin(), expected_sort.end(), greater<>{});
+        REQUIRE(sorted == expected_sort);
+    }
+
+    SECTION("exception from a half leaves only after every other half finished")
+    {
+        atomic<int> running{0};
+        auto visit = [&](int& x) {
+            ++running;
+            if (&x == &data.back())
+            {
+                --running;
+                throw runtime_error{"last element"};
+            }
+            this_thread::sleep_for(1us);
+            --running;
+        };
+
+        REQUIRE_THROWS_AS(parallel::for_each(pool, data.begin(), data.end(), visit, 1024), runtime_error);
+        REQUIRE(running.load() == 0); // no half is still using visit or data
+
+        auto throwing_less = [&](int a, int b) {
+            if (a == b && a == 999)
+                throw runtime_error{"compare"};
+            return a < b;
+        };
+        REQUIRE_THROWS_AS(parallel::sort(pool, data.begin(), data.end(), throwing_less, 1024), runtime_error);
+    }
+}
+
+TEST_CASE("PoolMetrics")
+{
+    using InstrumentedPool = BasicThreadPool<PoolMetrics::Enabled<>>;
+
+    SECTION("tasks run by a helping thread leave no queue depth behind")
+    {
+        InstrumentedPool pool{1};
+        InstrumentedPool other_pool{1};
+
+        promise<void> started;
+        promise<void> release;
+        auto worker_blocked = pool.submit([&started, released = release.get_future()] {
+            started.set_value();
+            released.wait();
+        });
+        started.get_future().wait();
+
+        // the only worker is blocked - every half is run by this thread, or by a worker of the other pool
+        vector<int> data(1000, 1);
+        parallel::for_each(pool, data.begin(), data.end(), [](int& x) { ++x; }, 10);
+        other_pool.submit([&pool, &data] { parallel::for_each(pool, data.begin(), data.end(), [](int& x) { ++x; }, 10); }).get();
+
+        REQUIRE(pool.metrics().queue_depth() == 0);
+        REQUIRE(other_pool.metrics().tasks_started == 1); // helping for pool is not recorded as its own work
+
+        release.set_value();
+        worker_blocked.get();
+        REQUIRE(ranges::all_of(data, [](int x) { return x == 3; }));
+    }
+}
+
+// pool whose queue is always full
+struct RejectingPool
+{
+    template <typename F>
+    future<invoke_result_t<F&>> submit(F&&)
+    {
+        throw runtime_error{"queue full"};
+    }
+
+    bool try_run_pending_task()
+    {
+        return false;
+    }
+};
+
+TEST_CASE("TaskGroup")
+{
+    ThreadPool pool{3};
+    TaskGroup group{pool};
+
+    SECTION("wait throws every failure of the group")
+    {
+        latch all_started{3};
+        for (int i = 0; i < 3; ++i)
+        {
+            group.run([&all_started, i] {
+                all_started.arrive_and_wait(); // no task is skipped - all fail
+                throw runtime_error{"task #" + to_string(i)};
+            });
+        }
+
+        try
+        {
+            group.wait();
+            FAIL("TaskGroupError expected");
+        }
+        catch (const TaskGroupError& e)
+        {
+            REQUIRE(e.exceptions().size() == 3);
+            for (const auto& eptr : e.exceptions())
+                REQUIRE_THROWS_AS(rethrow_exception(eptr), runtime_error);
+        }
+    }
+
+    SECTION("failure skips queued siblings, wait re-arms the group")
+    {
+        ThreadPool single_worker{1};
+        TaskGroup serial_group{single_worker};
+
+        promise<void> started;
+        promise<void> fail;
+        auto failing = serial_group.run([&started, failed = fail.get_future()] {
+            started.set_value();
+            failed.wait();
+            throw runtime_error{"failed"};
+        });
+        started.get_future().wait();
+
+        atomic<bool> sibling_ran{false};
+        auto sibling = serial_group.run([&sibling_ran] { sibling_ran = true; });
+
+        fail.set_value();
+        failing.wait();
+
+        REQUIRE_THROWS_AS(serial_group.wait(), TaskGroupError);
+        REQUIRE_THROWS_AS(sibling.get(), TaskCancelled);
+        REQUIRE_FALSE(sibling_ran.load());
+
+        REQUIRE(serial_group.run([] { return 42; }).get() == 42);
+        REQUIRE_NOTHROW(serial_group.wait());
+    }
+
+    SECTION("task that could not be submitted is not waited for")
+    {
+        RejectingPool rejecting_pool;
+        TaskGroup rejecting_group{rejecting_pool};
+
+        REQUIRE_THROWS_AS(rejecting_group.run([] {}), runtime_error);
+        REQUIRE(rejecting_group.pending_count() == 0);
+        REQUIRE_NOTHROW(rejecting_group.wait());
+    }
+}
+
+TEST_CASE("FutureCache")
+{
+    ThreadPool pool{2};
+
+    SECTION("request for a key in flight joins the computation")
+    {
+        FutureCache<int, int> cache;
+        promise<void> release;
+        atomic<int> computations{0};
+        auto compute = [&computations, released = release.get_future().share()] {
+            ++computations;
+            released.wait();
+            return 169;
+        };
+
+        auto first = cache.get(13, pool, compute);
+        auto second = cache.get(13, pool, compute);
+        release.set_value();
+
+        REQUIRE(first.get() == 169);
+        REQUIRE(second.get() == 169);
+        REQUIRE(computations.load() == 1);
+        REQUIRE(cache.stats().joined == 1);
+        REQUIRE(cache.get(13, [] { return 0; }).get() == 169);
+        REQUIRE(cache.stats().hits == 1);
+    }
+
+    SECTION("failures are retried or cached - as configured")
+    {
+        auto failing = []() -> int { throw runtime_error{"failed"}; };
+
+        FutureCache<int, int> retrying{{.exceptions = ExceptionPolicy::retry}};
+        REQUIRE_THROWS_AS(retrying.get(1, failing).get(), runtime_error);
+        REQUIRE(retrying.get(1, [] { return 1; }).get() == 1);
+        REQUIRE(retrying.stats().computations == 2);
+
+        FutureCache<int, int> caching{{.exceptions = ExceptionPolicy::cache}};
+        REQUIRE_THROWS_AS(caching.get(1, failing).get(), runtime_error);
+        REQUIRE_THROWS_AS(caching.get(1, [] { return 1; }).get(), runtime_error);
+        REQUIRE(caching.stats().computations == 1);
+        REQUIRE(caching.stats().failures == 1);
+    }
+
+    SECTION("eviction skips entries still in flight")
+    {
+        FutureCache<int, int> cache{{.capacity = 2}};
+        promise<void> release;
+        auto in_flight = cache.get(1, pool, [released = release.get_future()] {
+            released.wait();
+            return 1;
+        });
+        cache.get(2, [] { return 2; });
+        cache.get(3, [] { return 3; });
+
+        REQUIRE(cache.contains(1)); // least recently used, but in flight
+        REQUIRE_FALSE(cache.contains(2));
+        REQUIRE(cache.contains(3));
+        REQUIRE(cache.stats().evictions == 1);
+
+        release.set_value();
+        REQUIRE(in_flight.get() == 1);
+    }
+
+    SECTION("key whose computation could not be submitted is computed by the next request")
+    {
+        FutureCache<int, int> cache;
+        RejectingPool rejecting_pool;
+
+        REQUIRE_THROWS_AS(cache.get(1, rejecting_pool, [] { return 1; }), runtime_error);
+        REQUIRE_FALSE(cache.contains(1));
+        REQUIRE(cache.get(1, pool, [] { return 1; }).get() == 1);
+    }
+}
+
+TEST_CASE("TaskContext")
+{
+    SECTION("scope installs a context and restores the previous one")
+    {
+        REQUIRE(TaskContext::current() == nullptr);
+        {
+            ContextScope outer{TaskContext::make("outer")};
+            {
+                ContextScope inner{TaskContext::make("inner")};
+                REQUIRE(TaskContext::current()->request_id() == "inner");
+            }
+            REQUIRE(TaskContext::current()->request_id() == "outer");
+        }
+        REQUIRE(TaskContext::current() == nullptr);
+    }
+
+    SECTION("pool tasks and wrapped callables run with the submitter's context")
+    {
+        ThreadPool pool{2};
+        ContextScope scope{TaskContext::make("request#42")};
+
+        auto request_id = [] { return TaskContext::current() ? TaskContext::current()->request_id() : string{"none"}; };
+
+        REQUIRE(pool.submit(request_id).get() == "request#42");
+        REQUIRE(async(launch::async, with_current_context(request_id)).get() == "request#42");
+        REQUIRE(async(launch::async, request_id).get() == "none");
+    }
+
+    SECTION("context lives as long as a task holding it")
+    {
+        ThreadPool pool{1};
+        promise<void> release;
+        future<string> result;
+        {
+            ContextScope scope{TaskContext::make("short-lived")};
+            result = pool.submit([released = release.get_future()] {
+                released.wait();
+                return TaskContext::current()->request_id();
+            });
+        }
+        release.set_value();
+
+        REQUIRE(result.get() == "short-lived");
+    }
+}
+
+TEST_CASE("OrderedLock")
+{
+    RankedMutex<> low{1};
+    RankedMutex<> high{2};
+
+    SECTION("mutexes passed in any order are locked by rank - transfers in opposite directions do not deadlock")
+    {
+        int balance_low = 1'000'000;
+        int balance_high = 1'000'000;
+        {
+            jthread forward{[&] {
+                for (int i = 0; i < 10'000; ++i)
+                {
+                    OrderedLock lk{low, high};
+                    --balance_low;
+                    ++balance_high;
+                }
+            }};
+            for (int i = 0; i < 10'000; ++i)
+            {
+                OrderedLock lk{high, low};
+                --balance_high;
+                ++balance_low;
+            }
+        }
+
+        REQUIRE(balance_low == 1'000'000);
+        REQUIRE(balance_high == 1'000'000);
+    }
+
+    SECTION("the same mutex passed twice is locked once")
+    {
+        {
+            OrderedLock lk{low, low};
+            REQUIRE_FALSE(low.try_lock());
+        }
+        REQUIRE(low.try_lock());
+        low.unlock();
+    }
+
+#if ORDERED_LOCK_CHECKS
+    SECTION("locking a rank not above a held one is a violation - before blocking")
+    {
+        lock_guard lk_high{high};
+        REQUIRE_THROWS_AS(low.lock(), LockOrderViolation);
+
+        REQUIRE(low.try_lock()); // never blocks - any order is fine
+        low.unlock();
+    }
+#endif
+}
+
+TEST_CASE("LookupTable")
+{
+    SECTION("table holds f(i) - computed at compile time")
+    {
+        constexpr auto squares = LookupTable::make_lookup_table<5>([](size_t i) { return i * i; });
+        static_assert(squares == array<size_t, 5>{0, 1, 4, 9, 16});
+
+        constexpr auto roots = LookupTable::make_lookup_table<17, uint8_t>([](size_t i) { return LookupTable::isqrt(i); });
+        static_assert(roots[15] == 3 && roots[16] == 4);
+        REQUIRE(LookupTable::isqrt(UINT64_MAX) == UINT32_MAX);
+    }
+
+    SECTION("checked helpers report overflow")
+    {
+        REQUIRE(LookupTable::checked_add(uint8_t{200}, uint8_t{55}) == 255);
+        REQUIRE_THROWS_AS(LookupTable::checked_add(uint8_t{200}, uint8_t{56}), overflow_error);
+        REQUIRE_THROWS_AS(LookupTable::checked_mul(uint32_t{1} << 16, uint32_t{1} << 16), overflow_error);
+        REQUIRE(LookupTable::checked_shl(uint64_t{1}, 63) == uint64_t{1} << 63);
+        REQUIRE_THROWS_AS(LookupTable::checked_shl(uint64_t{1}, 64), overflow_error);
+        REQUIRE_THROWS_AS(LookupTable::checked_shl(uint64_t{3}, 63), overflow_error);
+    }
+
+    SECTION("histogram bucket bounds map back to their buckets")
+    {
+        using Histogram = PoolMetrics::LatencyHistogram;
+        for (size_t i = 0; i < Histogram::bucket_count; ++i)
+            REQUIRE(Histogram::bucket_index(Histogram::bucket_lower_bound(i)) == i);
+    }
+
+    SECTION("backoff doubles its pauses, then yields")
+    {
+        for (size_t step = 0; step < Backoff::spin_steps; ++step)
+            REQUIRE(Backoff::pauses(step) == 1u << step);
+
+        Backoff backoff;
+        for (size_t i = 0; i < 2 * Backoff::spin_steps; ++i)
+            backoff.pause();
+        backoff.reset();
+    }
+
+    SECTION("spin lock with backoff keeps increments exclusive")
+    {
+        SpinLock lock;
+        int counter = 0;
+        {
+            vector<jthread> threads;
+            for (int t = 0; t < 4; ++t)
+            {
+                threads.emplace_back([&] {
+                    for (int i = 0; i < 10'000; ++i)
+                    {
+                        lock_guard lk{lock};
+                        ++counter;
+                    }
+                });
+            }
+        }
+
+        REQUIRE(counter == 40'000);
+    }
+}
+
+TEST_CASE("RcuCell")
+{
+    SECTION("snapshot keeps its version while newer ones are published")
+    {
+        RcuCell<vector<int>> cell;
+        REQUIRE_FALSE(cell.read());
+        REQUIRE(cell.read().version() == 0);
+
+        cell.publish({1, 2, 3});
+        auto snapshot = cell.read();
+        cell.publish({4});
+
+        REQUIRE(*snapshot == vector{1, 2, 3});
+        REQUIRE(snapshot.version() == 1);
+        REQUIRE(*cell.read() == vector{4});
+        REQUIRE(cell.version() == 2);
+    }
+
+    SECTION("concurrent updates are not lost, readers see whole versions")
+    {
+        RcuCell<vector<int>> cell{vector<int>{}};
+        atomic<bool> torn{false};
+        {
+            jthread reader{[&](stop_token stop_tkn) {
+                while (!stop_tkn.stop_requested())
+                {
+                    auto snapshot = cell.read();
+                    if (!ranges::equal(*snapshot, views::iota(0, static_cast<int>(snapshot->size()))))
+                        torn = true;
+                }
+            }};
+
+            vector<jthread> writers;
+            for (int t = 0; t < 3; ++t)
+            {
+                writers.emplace_back([&cell] {
+                    for (int i = 0; i < 300; ++i)
+                        cell.update([](vector<int>& v) { v.push_back(static_cast<int>(v.size())); });
+                });
+            }
+        }
+
+        REQUIRE_FALSE(torn.load());
+        REQUIRE(cell.read()->size() == 900);
+        REQUIRE(cell.version() == 901);
+    }
+
+    SECTION("wait_for_update returns once a newer version is published")
+    {
+        RcuCell<int> cell{1};
+        const uint64_t seen = cell.version();
+
+        jthread writer{[&cell] {
+            this_thread::sleep_for(10ms);
+            cell.publish(2);
+        }};
+
+        REQUIRE(cell.wait_for_update(seen) > seen);
+        REQUIRE(*cell.read() == 2);
+    }
+}
+
+TEST_CASE("WorkerTeam")
+{
+    WorkerTeam team{4};
+
+    SECTION("reduce gives every member the rank-ordered fold")
+    {
+        vector<string> results(team.size());
+        team.run([&results](WorkerTeam::Member& member) {
+            results[member.rank()] = member.reduce(to_string(member.rank()), [](string a, const string& b) { return a + b; });
+        });
+
+        REQUIRE(ranges::all_of(results, [](const string& r) { return r == "0123"; }));
+    }
+
+    SECTION("single runs once per call, between the phases")
+    {
+        int calls = 0;
+        vector<int> seen(team.size());
+        team.run([&](WorkerTeam::Member& member) {
+            for (int i = 0; i < 10; ++i)
+                member.single([&calls] { ++calls; });
+            seen[member.rank()] = calls;
+        });
+
+        REQUIRE(calls == 10);
+        REQUIRE(ranges::all_of(seen, [](int s) { return s == 10; }));
+    }
+
+    SECTION("ranges split the work into adjacent shares differing by at most one")
+    {
+        for (size_t count : {0, 3, 4, 10, 1001})
+        {
+            size_t expected_first = 0;
+            for (size_t rank = 0; rank < team.size(); ++rank)
+            {
+                auto [first, last] = WorkerTeam::Member{team, rank}.range(count);
+                REQUIRE(first == expected_first);
+                REQUIRE(last - first >= count / team.size());
+                REQUIRE(last - first <= count / team.size() + 1);
+                expected_first = last;
+            }
+            REQUIRE(expected_first == count);
+        }
+    }
+}
+
+TEST_CASE("ThreadPool - expected results")
+{
+    ThreadPool pool{2};
+
+    SECTION("value and error are handed over by get() without throwing")
+    {
+        auto square = [](int x) -> expected<int, string> {
+            if (x < 0)
+                return unexpected{"negative"s};
+            return x * x;
+        };
+
+        REQUIRE(pool.submit([&] { return square(13); }).get() == 169);
+        REQUIRE(pool.submit([&] { return square(-1); }).get().error() == "negative");
+    }
+
+    SECTION("exception is stored as the error when the error type can hold it")
+    {
+        auto result = pool.submit([]() -> expected<int, exception_ptr> { throw runtime_error{"failed"}; }).get();
+
+        REQUIRE_FALSE(result.has_value());
+        REQUIRE_THROWS_AS(rethrow_exception(result.error()), runtime_error);
+    }
+
+    SECTION("exception goes through the future when the error type cannot hold it")
+    {
+        auto result = pool.submit([]() -> expected<int, string> { throw runtime_error{"failed"}; });
+
+        REQUIRE_THROWS_AS(result.get(), runtime_error);
+    }
+}
+
+TEST_CASE("ConsoleSink")
+{
+    ostringstream out;
+    ConsoleSink sink{out};
+
+    SECTION("lines of concurrent writers stay whole and in per-thread order")
+    {
+        constexpr int thread_count = 4;
+        constexpr int line_count = 1000;
+        {
+            vector<jthread> writers;
+            for (int t = 0; t < thread_count; ++t)
+            {
+                writers.emplace_back([&sink, t] {
+                    for (int i = 0; i < line_count; ++i)
+                        sink.line() << "thread " << t << " line " << i << " " << string(i % 50, '*') << "\n";
+                });
+            }
+        }
+        sink.flush();
+
+        vector<int> next(thread_count, 0);
+        istringstream lines{out.str()};
+        for (string text; getline(lines, text);)
+        {
+            int t = -1, i = -1;
+            istringstream fields{text};
+            fields.ignore(7) >> t;
+            fields.ignore(6) >> i;
+
+            REQUIRE(text == "thread " + to_string(t) + " line " + to_string(i) + " " + string(i % 50, '*'));
+            REQUIRE(i == next[t]++);
+        }
+        REQUIRE(ranges::all_of(next, [](int n) { return n == line_count; }));
+    }
+
+    SECTION("line left by an exception is dropped")
+    {
+        try
+        {
+            auto line = sink.line();
+            line << "half-";
+            throw runtime_error{"formatting failed"};
+        }
+        catch (const runtime_error&)
+        {
+        }
+        sink.line() << "whole\n";
+        sink.flush();
+
+        REQUIRE(out.str() == "whole\n");
+    }
+}
@@ -1,13 +1,27 @@
+#include "lock_free_queue.hpp"
+#include "lock_free_stack.hpp"
+#include "reclamation.hpp"
+#include "spsc_queue.hpp"
 #include "thread_safe_queue.hpp"
 
+#include <array>
+#include <atomic>
 #include <catch2/catch_test_macros.hpp>
 #include <chrono>
 #include <condition_variable>
+#include <deque>
 #include <functional>
 #include <queue>
 #include <thread>
 #include <iostream>
+#include <iterator>
+#include <limits>
+#include <mutex>
 #include <future>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
 
 using namespace std;
 
@@ -90,3 +104,547 @@ TEST_CASE("ThreadSafeQueue")
         REQUIRE(none_of(items.begin(), items.end(), [](int x) { return x == 0; }));
     }
 }
+
+TEST_CASE("ThreadSafeQueue - move-only items")
+{
+    ThreadSafeQueue<unique_ptr<int>> tsq;
+
+    SECTION("emplace constructs the item in place")
+    {
+        tsq.emplace(new int{42});
+
+        auto item = tsq.pop();
+
+        REQUIRE(item.has_value());
+        REQUIRE(**item == 42);
+    }
+
+    SECTION("pop moves the item out")
+    {
+        tsq.push(make_unique<int>(1));
+
+        unique_ptr<int> item;
+        REQUIRE(tsq.pop(item));
+        REQUIRE(*item == 1);
+        REQUIRE(tsq.empty());
+    }
+
+    SECTION("try_pop returns nullopt when empty")
+    {
+        REQUIRE(tsq.try_pop() == nullopt);
+    }
+}
+
+TEST_CASE("ThreadSafeQueue - close")
+{
+    ThreadSafeQueue<int> tsq;
+
+    SECTION("remaining items are drained before pop returns nullopt")
+    {
+        tsq.push({1, 2});
+        tsq.close();
+
+        REQUIRE(tsq.pop() == 1);
+        REQUIRE(tsq.pop() == 2);
+        REQUIRE(tsq.pop() == nullopt);
+    }
+
+    SECTION("wakes up waiting consumers")
+    {
+        auto consumer = async(launch::async, [&tsq] { return tsq.pop(); });
+
+        this_thread::sleep_for(50ms);
+        tsq.close();
+
+        REQUIRE(consumer.get() == nullopt);
+    }
+}
+
+// std::condition_variable counting its calls - shows which wakeups the queue asks for
+struct CountingConditionVariable
+{
+    inline static atomic<int> waits{0};
+    inline static atomic<int> notify_ones{0};
+    inline static atomic<int> notify_alls{0};
+
+    condition_variable cv;
+
+    static void reset_counters()
+    {
+        waits = 0;
+        notify_ones = 0;
+        notify_alls = 0;
+    }
+
+    void wait(unique_lock<mutex>& lk)
+    {
+        ++waits;
+        cv.wait(lk);
+    }
+
+    void notify_one()
+    {
+        ++notify_ones;
+        cv.notify_one();
+    }
+
+    void notify_all()
+    {
+        ++notify_alls;
+        cv.notify_all();
+    }
+};
+
+using CountingQueue = ThreadSafeQueue<int, mutex, deque<int>, CountingConditionVariable>;
+
+bool eventually(const function<bool()>& condition)
+{
+    for (int i = 0; i < 5000; ++i)
+    {
+        if (condition())
+            return true;
+        this_thread::sleep_for(1ms);
+    }
+    return false;
+}
+
+TEST_CASE("ThreadSafeQueue - wakeups")
+{
+    CountingConditionVariable::reset_counters();
+
+    SECTION("push notifies nobody while no consumer sleeps")
+    {
+        CountingQueue tsq{0};
+        for (int i = 0; i < 100; ++i)
+            tsq.push(i);
+        tsq.push({100, 101, 102});
+
+        int item;
+        for (int i = 0; i < 103; ++i)
+            tsq.pop(item);
+
+        REQUIRE(CountingConditionVariable::notify_ones == 0);
+        REQUIRE(CountingConditionVariable::notify_alls == 0);
+        REQUIRE(CountingConditionVariable::waits == 0);
+    }
+
+    SECTION("push wakes a sleeping consumer once")
+    {
+        CountingQueue tsq{0};
+        auto consumer = async(launch::async, [&tsq] { return tsq.pop(); });
+        REQUIRE(eventually([] { return CountingConditionVariable::waits == 1; }));
+
+        tsq.push(1);
+        REQUIRE(consumer.get() == 1);
+        tsq.push(2); // nobody sleeps any more
+
+        REQUIRE(CountingConditionVariable::notify_ones == 1);
+        REQUIRE(CountingConditionVariable::notify_alls == 0);
+    }
+
+    SECTION("batch push wakes min(items, sleeping consumers) - notify_all only when it wakes all of them")
+    {
+        CountingQueue tsq{0};
+        vector<future<optional<int>>> consumers;
+        for (int i = 0; i < 4; ++i)
+            consumers.push_back(async(launch::async, [&tsq] { return tsq.pop(); }));
+        REQUIRE(eventually([] { return CountingConditionVariable::waits == 4; }));
+
+        tsq.push({1, 2}); // 2 of 4 sleepers
+        REQUIRE(CountingConditionVariable::notify_ones == 2);
+        REQUIRE(CountingConditionVariable::notify_alls == 0);
+
+        tsq.push({3, 4, 5}); // the 2 not yet notified - all of them
+        REQUIRE(CountingConditionVariable::notify_ones == 2);
+        REQUIRE(CountingConditionVariable::notify_alls == 1);
+
+        int sum = 0;
+        for (auto& consumer : consumers)
+            sum += consumer.get().value();
+        REQUIRE(sum == 10);
+        REQUIRE(tsq.size() == 1);
+    }
+
+    SECTION("consumer spins a bounded number of times, then sleeps")
+    {
+        CountingQueue tsq{100'000};
+        auto consumer = async(launch::async, [&tsq] { return tsq.pop(); });
+        REQUIRE(eventually([] { return CountingConditionVariable::waits == 1; }));
+
+        tsq.push(7);
+        REQUIRE(consumer.get() == 7);
+        REQUIRE(CountingConditionVariable::notify_ones == 1);
+    }
+
+    SECTION("item pushed while the consumer spins is taken without sleeping")
+    {
+        CountingQueue tsq{numeric_limits<size_t>::max()}; // spins until an item comes
+        auto consumer = async(launch::async, [&tsq] { return tsq.pop(); });
+        this_thread::sleep_for(10ms);
+
+        tsq.push(7);
+        REQUIRE(consumer.get() == 7);
+        REQUIRE(CountingConditionVariable::waits == 0);
+        REQUIRE(CountingConditionVariable::notify_ones == 0);
+    }
+}
+
+TEST_CASE("ChunkedThreadSafeQueue")
+{
+    ChunkedThreadSafeQueue<string> tsq;
+
+    SECTION("keeps FIFO order across chunk boundaries")
+    {
+        const int count = 10 * default_chunk_size<string>;
+
+        for (int i = 0; i < count; ++i)
+            tsq.push(to_string(i));
+
+        for (int i = 0; i < count; ++i)
+            REQUIRE(tsq.pop() == to_string(i));
+
+        REQUIRE(tsq.empty());
+    }
+
+    SECTION("passes items between threads")
+    {
+        const int count = 100'000;
+
+        auto consumer = async(launch::async, [&tsq] {
+            long long sum = 0;
+            while (auto item = tsq.pop())
+                sum += stoi(*item);
+            return sum;
+        });
+
+        for (int i = 0; i < count; ++i)
+            tsq.emplace(to_string(i));
+        tsq.close();
+
+        REQUIRE(consumer.get() == 1LL * count * (count - 1) / 2);
+    }
+}
+
+TEST_CASE("ChunkedDeque")
+{
+    ChunkedDeque<int, 4, 2> dq;
+
+    SECTION("recycles drained chunks up to the spare limit")
+    {
+        for (int i = 0; i < 16; ++i)
+            dq.push_back(i);
+
+        for (int i = 0; i < 15; ++i)
+        {
+            REQUIRE(dq.front() == i);
+            dq.pop_front();
+        }
+
+        REQUIRE(dq.size() == 1);
+        REQUIRE(dq.back() == 15);
+        REQUIRE(dq.spare_chunks() == 2);
+    }
+
+    SECTION("destroys remaining items")
+    {
+        auto counter = make_shared<int>(0);
+        {
+            ChunkedDeque<shared_ptr<int>, 4> items;
+            for (int i = 0; i < 10; ++i)
+                items.push_back(counter);
+            REQUIRE(counter.use_count() == 11);
+        }
+        REQUIRE(counter.use_count() == 1);
+    }
+}
+
+TEST_CASE("RingBuffer")
+{
+    RingBuffer<string> ring;
+
+    SECTION("keeps FIFO order when growing a wrapped-around buffer")
+    {
+        for (int i = 0; i < 10; ++i)
+            ring.push_back(to_string(i));
+        for (int i = 0; i < 8; ++i)
+            ring.pop_front();
+        for (int i = 10; i < 40; ++i) // wraps, then grows
+            ring.push_back(to_string(i));
+
+        REQUIRE(ring.size() == 32);
+        for (int i = 8; i < 40; ++i)
+        {
+            REQUIRE(ring.front() == to_string(i));
+            ring.pop_front();
+        }
+    }
+
+    SECTION("does not grow below its high-water mark")
+    {
+        for (int round = 0; round < 100; ++round)
+        {
+            for (int i = 0; i < 20; ++i)
+                ring.emplace_back(i, 'x');
+            while (!ring.empty())
+                ring.pop_front();
+        }
+
+        REQUIRE(ring.capacity() == 32);
+    }
+}
+
+TEST_CASE("SpscQueue")
+{
+    SpscQueue<unique_ptr<int>> spsc{4};
+
+    SECTION("rejects pushes when full")
+    {
+        for (int i = 0; i < 4; ++i)
+            REQUIRE(spsc.try_push(make_unique<int>(i)));
+
+        REQUIRE(spsc.try_push(make_unique<int>(4)) == false);
+        REQUIRE(**spsc.try_pop() == 0);
+        REQUIRE(spsc.try_push(make_unique<int>(4)));
+    }
+
+    SECTION("batch operations keep FIFO order across the wrap-around")
+    {
+        vector<unique_ptr<int>> items;
+        for (int i = 0; i < 10; ++i)
+            items.push_back(make_unique<int>(i));
+
+        vector<unique_ptr<int>> received;
+        auto next = items.begin();
+        while (received.size() < items.size())
+        {
+            next = spsc.try_push_batch(next, items.end());
+            spsc.try_pop_batch(back_inserter(received), 3);
+        }
+
+        for (int i = 0; i < 10; ++i)
+            REQUIRE(*received[i] == i);
+    }
+}
+
+TEST_CASE("BlockingSpscQueue")
+{
+    BlockingSpscQueue<int> spsc{16};
+
+    SECTION("passes items between threads through a small ring")
+    {
+        const int count = 100'000;
+
+        auto consumer = async(launch::async, [&spsc] {
+            long long sum = 0;
+            int expected = 0;
+            while (auto item = spsc.pop())
+            {
+                if (*item != expected++)
+                    return -1LL;
+                sum += *item;
+            }
+            return sum;
+        });
+
+        for (int i = 0; i < count; ++i)
+            spsc.push(i);
+        spsc.close();
+
+        REQUIRE(consumer.get() == 1LL * count * (count - 1) / 2);
+    }
+
+    SECTION("pop_batch wakes up on close")
+    {
+        auto consumer = async(launch::async, [&spsc] {
+            array<int, 4> batch;
+            return spsc.pop_batch(batch.begin(), batch.size());
+        });
+
+        this_thread::sleep_for(50ms);
+        spsc.close();
+
+        REQUIRE(consumer.get() == 0);
+    }
+}
+
+namespace
+{
+    struct Tracked
+    {
+        atomic<int>& destroyed;
+
+        ~Tracked()
+        {
+            ++destroyed;
+        }
+    };
+
+    // every item pushed by the producers is popped exactly once
+    template <typename TContainer>
+    bool transfers_all_items(TContainer& container, int producers, int consumers, int items_per_producer)
+    {
+        const int total = producers * items_per_producer;
+        vector<atomic<int>> seen(total);
+        atomic<int> popped{0};
+
+        {
+            vector<jthread> threads;
+            for (int p = 0; p < producers; ++p)
+                threads.emplace_back([&, p] {
+                    for (int i = 0; i < items_per_producer; ++i)
+                        container.push(p * items_per_producer + i);
+                });
+            for (int c = 0; c < consumers; ++c)
+                threads.emplace_back([&] {
+                    while (popped.load() < total)
+                    {
+                        if (auto item = container.try_pop())
+                        {
+                            ++seen[*item];
+                            ++popped;
+                        }
+                        else
+                            this_thread::yield();
+                    }
+                });
+        }
+
+        for (const auto& count : seen)
+        {
+            if (count != 1)
+                return false;
+        }
+        return container.empty();
+    }
+} // namespace
+
+TEST_CASE("EpochDomain")
+{
+    Reclamation::EpochDomain domain;
+    atomic<int> destroyed{0};
+
+    SECTION("does not free what a pinned thread may still see")
+    {
+        auto guard = domain.pin();
+        for (int i = 0; i < 1000; ++i)
+            domain.retire(new Tracked{destroyed});
+
+        REQUIRE(destroyed == 0);
+        REQUIRE(domain.retired_count() == 1000);
+    }
+
+    SECTION("frees retired objects once readers move on")
+    {
+        for (int i = 0; i < 10; ++i)
+            domain.retire(new Tracked{destroyed});
+
+        for (int i = 0; i < 3; ++i)
+            domain.collect();
+
+        REQUIRE(destroyed == 10);
+        REQUIRE(domain.retired_count() == 0);
+    }
+
+    SECTION("frees what exited threads left behind")
+    {
+        jthread{[&] { domain.retire(new Tracked{destroyed}); }}.join();
+
+        for (int i = 0; i < 3; ++i)
+            domain.collect();
+
+        REQUIRE(destroyed == 1);
+    }
+}
+
+TEST_CASE("HazardDomain")
+{
+    Reclamation::HazardDomain domain;
+    atomic<int> destroyed{0};
+
+    SECTION("keeps a protected object alive")
+    {
+        atomic<Tracked*> shared{new Tracked{destroyed}};
+        auto guard = domain.pin();
+        Tracked* protected_object = guard.protect(shared);
+
+        shared.store(nullptr);
+        domain.retire(protected_object);
+        for (int i = 0; i < 100; ++i)
+            domain.retire(new Tracked{destroyed});
+        domain.collect();
+
+        REQUIRE(destroyed == 100);
+        REQUIRE(domain.retired_count() == 1);
+    }
+
+    SECTION("throws when a thread holds more guards than there are slots")
+    {
+        vector<Reclamation::HazardDomain::Guard> guards;
+        for (size_t i = 0; i < Reclamation::HazardDomain::slots_per_thread; ++i)
+            guards.push_back(domain.pin());
+
+        REQUIRE_THROWS_AS(domain.pin(), std::length_error);
+
+        guards.pop_back();
+        REQUIRE_NOTHROW(domain.pin());
+    }
+}
+
+TEST_CASE("LockFreeStack")
+{
+    SECTION("pops items in LIFO order")
+    {
+        LockFreeStack<unique_ptr<int>> stack;
+        for (int i = 0; i < 3; ++i)
+            stack.push(make_unique<int>(i));
+
+        REQUIRE(**stack.try_pop() == 2);
+        REQUIRE(**stack.try_pop() == 1);
+        REQUIRE(**stack.try_pop() == 0);
+        REQUIRE(stack.try_pop() == nullopt);
+    }
+
+    SECTION("passes items between threads - epoch reclamation")
+    {
+        LockFreeStack<int> stack;
+        REQUIRE(transfers_all_items(stack, 4, 4, 20'000));
+    }
+
+    SECTION("passes items between threads - hazard pointers")
+    {
+        LockFreeStack<int, Reclamation::HazardDomain> stack;
+        REQUIRE(transfers_all_items(stack, 4, 4, 20'000));
+    }
+}
+
+TEST_CASE("LockFreeQueue")
+{
+    SECTION("pops items in FIFO order")
+    {
+        LockFreeQueue<unique_ptr<int>> queue;
+        for (int i = 0; i < 3; ++i)
+            queue.push(make_unique<int>(i));
+
+        REQUIRE(**queue.try_pop() == 0);
+        REQUIRE(**queue.try_pop() == 1);
+        REQUIRE(**queue.try_pop() == 2);
+        REQUIRE(queue.try_pop() == nullopt);
+        REQUIRE(queue.empty());
+    }
+
+    SECTION("passes items between threads - epoch reclamation")
+    {
+        LockFreeQueue<int> queue;
+        REQUIRE(transfers_all_items(queue, 4, 4, 20'000));
+    }
+
+    SECTION("passes items between threads - hazard pointers")
+    {
+        Reclamation::HazardDomain domain;
+        {
+            LockFreeQueue<int, Reclamation::HazardDomain> queue{domain};
+            REQUIRE(transfers_all_items(queue, 4, 4, 20'000));
+        }
+        REQUIRE(domain.retired_count() <= 9 * (64 + Reclamation::HazardDomain::slots_per_thread)); // bounded per thread
+    }
+}
@@ -0,0 +1,92 @@
+#include "benchmark.hpp"
+#include "numa_thread_pool.hpp"
+
+#include <cstring>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+// pi kernel - compute bound, working set fits in registers
+uintmax_t calc_hits(const uintmax_t count)
+{
+    const auto seed = std::hash<std::thread::id>{}(std::this_thread::get_id());
+    std::mt19937_64 rnd_gen(seed);
+    std::uniform_real_distribution<double> rnd_distr(0.0, 1.0);
+
+    uintmax_t hits = 0;
+    for (uintmax_t n = 0; n < count; ++n)
+    {
+        double x = rnd_distr(rnd_gen);
+        double y = rnd_distr(rnd_gen);
+        if (x * x + y * y < 1)
+            ++hits;
+    }
+    return hits;
+}
+
+// memory bound - streams over the worker's node-local scratch buffer
+uint64_t sum_scratch(int passes)
+{
+    const auto scratch = NumaThreadPool::worker_scratch();
+    const auto* data = reinterpret_cast<const uint64_t*>(scratch.data());
+    const size_t count = scratch.size() / sizeof(uint64_t);
+
+    uint64_t sum = 0;
+    for (int p = 0; p < passes; ++p)
+        sum = std::accumulate(data, data + count, sum);
+    return sum;
+}
+
+template <typename F>
+void run_tasks(NumaThreadPool& pool, size_t task_count, F task)
+{
+    std::vector<std::future<decltype(task())>> results;
+    results.reserve(task_count);
+
+    for (size_t i = 0; i < task_count; ++i)
+        results.push_back(pool.submit(task));
+
+    for (auto& r : results)
+        Benchmark::do_not_optimize(r.get());
+}
+
+int main()
+{
+    const size_t no_of_cores = std::max(1u, std::thread::hardware_concurrency());
+    const CpuTopology topology = CpuTopology::detect();
+
+    std::cout << "NUMA nodes: " << topology.node_count() << "; CPUs available: " << topology.cpu_count() << "\n";
+    for (size_t node = 0; node < topology.node_count(); ++node)
+        std::cout << "  node#" << node << ": " << topology.node_cpus[node].size() << " cpus\n";
+    std::cout << "\n";
+
+    const size_t task_count = 16 * no_of_cores;
+    const uintmax_t pi_count_per_task = 2'000'000;
+    const size_t scratch_size = 32 * 1024 * 1024; // larger than LLC
+    const int passes = 4;
+
+    for (const auto placement : {WorkerPlacement::unpinned, WorkerPlacement::pinned})
+    {
+        const std::string name = placement == WorkerPlacement::pinned ? "pinned" : "unpinned";
+
+        NumaThreadPool pool(no_of_cores, placement, scratch_size);
+        if (placement == WorkerPlacement::pinned && pool.pinned_count() < no_of_cores)
+            std::cout << "(only " << pool.pinned_count() << " of " << no_of_cores << " workers could be pinned)\n";
+
+        const auto pi_elapsed = Benchmark::report("Pi kernel - " + name, [&] {
+            run_tasks(pool, task_count, [=] { return calc_hits(pi_count_per_task); });
+        });
+        std::cout << "  throughput: " << task_count * pi_count_per_task / (pi_elapsed.count() / 1'000'000.0) / 1e6 << " M samples/s\n";
+
+        const auto mem_elapsed = Benchmark::report("Memory bound - " + name, [&] {
+            run_tasks(pool, task_count, [=] { return sum_scratch(passes); });
+        });
+        const double bytes = static_cast<double>(task_count) * passes * scratch_size;
+        std::cout << "  bandwidth: " << bytes / (mem_elapsed.count() / 1'000'000.0) / (1024 * 1024 * 1024) << " GiB/s\n\n";
+    }
+}
@@ -0,0 +1,56 @@
+#include "allocation_counter.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+// global allocator hook - a translation unit of its own, so the compiler never sees (and warns about)
+// an inlined operator new paired with std::free
+
+namespace
+{
+    std::atomic<uint64_t> allocations{0};
+}
+
+uint64_t Benchmark::allocation_count()
+{
+    return allocations.load(std::memory_order_relaxed);
+}
+
+void* operator new(size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size == 0 ? 1 : size))
+        return p;
+    throw std::bad_alloc{};
+}
+
+void* operator new(size_t size, std::align_val_t alignment)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    const auto align = static_cast<size_t>(alignment);
+    if (void* p = std::aligned_alloc(align, (size + align - 1) / align * align))
+        return p;
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, size_t, std::align_val_t) noexcept
+{
+    std::free(p);
+}
@@ -0,0 +1,13 @@
+#ifndef ALLOCATION_COUNTER_HPP
+#define ALLOCATION_COUNTER_HPP
+
+#include <cstdint>
+
+namespace Benchmark
+{
+    // allocations of the whole process so far - counted by the global operator new replaced in allocation_counter.cpp
+    // (link the allocation_counter library)
+    uint64_t allocation_count();
+} // namespace Benchmark
+
+#endif // ALLOCATION_COUNTER_HPP
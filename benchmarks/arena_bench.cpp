@@ -0,0 +1,164 @@
+#include "allocation_counter.hpp"
+#include "arena_resource.hpp"
+#include "benchmark.hpp"
+#include "thread_pool.hpp"
+#include "thread_safe_queue.hpp"
+
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <thread>
+#include <vector>
+
+using ArenaString = std::basic_string<char, std::char_traits<char>, ArenaAllocator<char>>;
+
+constexpr size_t task_count = 200'000;    // submitted by the main thread
+constexpr size_t futures_in_flight = 1000; // submitted before the first result is awaited
+constexpr size_t lines_per_producer = 50'000;
+
+// "Log#<id> - Event#<event>" - too long for the small string buffer, so every line allocates
+template <typename TString>
+TString make_log_line(TString line, size_t id, size_t event)
+{
+    const auto append_number = [&line](size_t n) {
+        char digits[20];
+        auto [end, ec] = std::to_chars(digits, digits + sizeof(digits), n);
+        line.append(digits, end);
+    };
+
+    line += "Log#";
+    append_number(id);
+    line += " - Event#";
+    append_number(event);
+    return line;
+}
+
+struct Result
+{
+    std::chrono::microseconds elapsed;
+    uint64_t allocations; // by operator new
+    size_t chunks = 0;    // taken by the arena
+};
+
+template <typename F>
+Result counted(F&& f)
+{
+    const uint64_t before = Benchmark::allocation_count();
+    Result result;
+    result.elapsed = Benchmark::measure(std::forward<F>(f));
+    result.allocations = Benchmark::allocation_count() - before;
+    return result;
+}
+
+// every task builds a log line - with the arena its shared state, the task and the line come from thread caches;
+// tasks are freed by workers and shared states by the submitter, so both kinds of frees cross threads
+Result run_pool(size_t thread_count, bool use_arena)
+{
+    ArenaResource arena;
+    const ArenaAllocator<char> alloc{arena};
+    Result result;
+    {
+        ThreadPool pool{thread_count};
+        std::vector<std::future<size_t>> results;
+        results.reserve(futures_in_flight);
+
+        result = counted([&] {
+            size_t total = 0;
+            for (size_t i = 0; i < task_count; ++i)
+            {
+                if (use_arena)
+                    results.push_back(pool.submit(std::allocator_arg, alloc, [alloc, i] { return make_log_line(ArenaString{alloc}, i % 64, i).size(); }));
+                else
+                    results.push_back(pool.submit([i] { return make_log_line(std::string{}, i % 64, i).size(); }));
+
+                if (results.size() == futures_in_flight)
+                {
+                    for (auto& r : results)
+                        total += r.get();
+                    results.clear();
+                }
+            }
+            for (auto& r : results)
+                total += r.get();
+            Benchmark::do_not_optimize(total);
+        });
+    }
+    result.chunks = arena.chunk_count();
+    return result;
+}
+
+// logger: producers format lines and queue them, a single writer consumes (and frees) them
+template <typename TString, typename TQueue, typename FMakeString>
+Result run_logger(size_t producer_count, FMakeString make_string)
+{
+    TQueue lines;
+    return counted([&] {
+        std::jthread writer{[&] {
+            size_t written = 0;
+            for (size_t i = 0; i < producer_count * lines_per_producer; ++i)
+            {
+                TString line = make_string(); // same allocator as the queued line - moved, not copied
+                lines.pop(line);
+                written += line.size();
+            }
+            Benchmark::do_not_optimize(written);
+        }};
+
+        std::vector<std::jthread> producers;
+        for (size_t id = 0; id < producer_count; ++id)
+        {
+            producers.emplace_back([&, id] {
+                for (size_t event = 0; event < lines_per_producer; ++event)
+                    lines.push(make_log_line(make_string(), id, event));
+            });
+        }
+    });
+}
+
+void print_row(size_t thread_count, size_t operations, const std::vector<Result>& results)
+{
+    std::cout << std::setw(7) << thread_count;
+    for (const auto& result : results)
+    {
+        std::cout << std::fixed << std::setprecision(2) << std::setw(12) << operations / (result.elapsed.count() / 1e6) / 1e6 << " Mops/s"
+                  << std::setw(7) << std::setprecision(2) << static_cast<double>(result.allocations) / operations << " news/op";
+        if (result.chunks != 0)
+            std::cout << " (" << result.chunks << " chunks)";
+    }
+    std::cout << "\n";
+}
+
+int main()
+{
+    std::cout << "ThreadPool: " << task_count / 1000 << "K submits of a task formatting a log line, "
+              << futures_in_flight << " futures in flight\n";
+    std::cout << "workers" << std::setw(38) << "operator new" << std::setw(39) << "ArenaAllocator\n";
+    for (size_t thread_count : {1, 2, 4, 8, 16})
+    {
+        const Result plain = run_pool(thread_count, false);
+        const Result arena = run_pool(thread_count, true);
+        print_row(thread_count, task_count, {plain, arena});
+    }
+
+    std::cout << "\nLogger: " << lines_per_producer / 1000 << "K lines per producer through a ThreadSafeQueue to one writer\n";
+    std::cout << "producers" << std::setw(35) << "std::string" << std::setw(38) << "ArenaString" << std::setw(40)
+              << "std::pmr::string (arena)\n";
+    for (size_t producer_count : {1, 2, 4, 8, 16})
+    {
+        ArenaResource arena;
+        using ArenaQueue = ThreadSafeQueue<ArenaString, std::mutex, std::deque<ArenaString, ArenaAllocator<ArenaString>>>;
+
+        const Result plain = run_logger<std::string, ThreadSafeQueue<std::string>>(producer_count, [] { return std::string{}; });
+        const Result allocator = run_logger<ArenaString, ArenaQueue>(producer_count, [&arena] { return ArenaString{ArenaAllocator<char>{arena}}; });
+        const Result pmr = run_logger<std::pmr::string, ThreadSafeQueue<std::pmr::string>>(producer_count, [&arena] { return std::pmr::string{&arena}; });
+        print_row(producer_count, producer_count * lines_per_producer, {plain, allocator, pmr});
+    }
+}
@@ -0,0 +1,44 @@
+#ifndef BENCHMARK_HPP
+#define BENCHMARK_HPP
+
+#include <chrono>
+#include <iostream>
+#include <string_view>
+#include <utility>
+
+namespace Benchmark
+{
+    using Clock = std::chrono::steady_clock;
+
+    template <typename F>
+    auto measure(F&& f)
+    {
+        const auto start = Clock::now();
+        std::forward<F>(f)();
+        const auto end = Clock::now();
+
+        return std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+    }
+
+    template <typename F>
+    auto report(std::string_view name, F&& f)
+    {
+        const auto elapsed = measure(std::forward<F>(f));
+        std::cout << name << ": " << std::chrono::duration_cast<std::chrono::milliseconds>(elapsed) << std::endl;
+        return elapsed;
+    }
+
+    // prevents the optimizer from discarding a computed value
+    template <typename T>
+    void do_not_optimize(const T& value)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "r,m"(value) : "memory");
+#else
+        static const void* volatile sink;
+        sink = &value;
+#endif
+    }
+} // namespace Benchmark
+
+#endif // BENCHMARK_HPP
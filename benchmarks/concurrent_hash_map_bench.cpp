@@ -0,0 +1,114 @@
+#include "benchmark.hpp"
+#include "concurrent_hash_map.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// shared cache: every thread looks up random keys and, with the given write ratio, overwrites or erases them
+
+constexpr uint64_t key_count = 100'000;
+
+// the synchronization-locking SynchronizedValue, without the tracing
+template <typename T, typename TMutex = std::mutex>
+struct SynchronizedValue
+{
+    T value;
+    TMutex mtx_value;
+
+    template <typename F>
+    auto with_lock(F&& f)
+    {
+        std::lock_guard lk{mtx_value};
+        return f(value);
+    }
+};
+
+class SynchronizedMap
+{
+    SynchronizedValue<std::unordered_map<uint64_t, uint64_t>> map_;
+
+public:
+    std::optional<uint64_t> find(uint64_t key)
+    {
+        return map_.with_lock([key](auto& map) -> std::optional<uint64_t> {
+            auto it = map.find(key);
+            if (it == map.end())
+                return std::nullopt;
+            return it->second;
+        });
+    }
+
+    void insert_or_assign(uint64_t key, uint64_t value)
+    {
+        map_.with_lock([=](auto& map) { map.insert_or_assign(key, value); });
+    }
+
+    void erase(uint64_t key)
+    {
+        map_.with_lock([key](auto& map) { map.erase(key); });
+    }
+};
+
+template <typename TMap>
+std::chrono::microseconds run(size_t thread_count, unsigned write_percent, size_t operation_count)
+{
+    TMap map;
+    for (uint64_t key = 0; key < key_count; key += 2)
+        map.insert_or_assign(key, key);
+
+    return Benchmark::measure([&] {
+        std::vector<std::jthread> threads;
+        for (size_t t = 0; t < thread_count; ++t)
+        {
+            threads.emplace_back([&map, t, thread_count, write_percent, operation_count] {
+                std::mt19937_64 rnd{t};
+                uint64_t hits = 0;
+                for (size_t i = 0; i < operation_count / thread_count; ++i)
+                {
+                    const uint64_t r = rnd();
+                    const uint64_t key = r % key_count;
+                    if ((r >> 32) % 100 >= write_percent)
+                        hits += map.find(key).has_value();
+                    else if ((r >> 40) % 2 == 0)
+                        map.insert_or_assign(key, r);
+                    else
+                        map.erase(key);
+                }
+                Benchmark::do_not_optimize(hits);
+            });
+        }
+    });
+}
+
+int main(int argc, char* argv[])
+{
+    const size_t operation_count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 4'000'000;
+
+    std::cout << operation_count / 1'000'000.0 << "M operations on " << key_count / 1000 << "K keys per run, Mops/s\n";
+
+    for (unsigned write_percent : {10, 50})
+    {
+        std::cout << "\n" << 100 - write_percent << "% find / " << write_percent << "% insert_or_assign + erase\n";
+        std::cout << "threads  SynchronizedValue<unordered_map>  ConcurrentHashMap\n";
+        for (size_t thread_count : {1, 2, 4, 8, 16, 32, 64})
+        {
+            const auto synchronized = run<SynchronizedMap>(thread_count, write_percent, operation_count);
+            const auto concurrent = run<ConcurrentHashMap<uint64_t, uint64_t>>(thread_count, write_percent, operation_count);
+
+            std::cout << std::setw(7) << thread_count << std::fixed << std::setprecision(2) << std::setw(35)
+                      << operation_count / (synchronized.count() / 1e6) / 1e6 << std::setw(19)
+                      << operation_count / (concurrent.count() / 1e6) / 1e6 << "\n";
+        }
+    }
+}
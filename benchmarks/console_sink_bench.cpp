@@ -0,0 +1,99 @@
+#include "benchmark.hpp"
+#include "console_sink.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <syncstream>
+#include <thread>
+#include <vector>
+
+// pool tasks reporting progress: every thread formats lines like the thread-pool demo's
+// "Starting calculation for 13 in 1403..." and writes them to a shared stream (/dev/null)
+
+constexpr size_t line_count = 400'000; // split among the threads
+
+template <typename TStream>
+void write_line(TStream&& out, size_t thread, size_t i)
+{
+    out << "Starting calculation for " << i << " in thread#" << thread << " - progress " << std::fixed << std::setprecision(2)
+        << 100.0 * static_cast<double>(i) / line_count << "%\n";
+}
+
+template <typename FWriteLine>
+std::chrono::microseconds run(size_t thread_count, FWriteLine write_line)
+{
+    return Benchmark::measure([&] {
+        std::vector<std::jthread> threads;
+        for (size_t t = 0; t < thread_count; ++t)
+        {
+            threads.emplace_back([&write_line, t, thread_count] {
+                for (size_t i = 0; i < line_count / thread_count; ++i)
+                    write_line(t, i);
+            });
+        }
+    });
+}
+
+std::chrono::microseconds run_osyncstream(std::ostream& out, size_t thread_count)
+{
+    return run(thread_count, [&out](size_t thread, size_t i) { write_line(std::osyncstream{out}, thread, i); });
+}
+
+// includes draining - the time until the last line is written
+std::chrono::microseconds run_sink(std::ostream& out, size_t thread_count)
+{
+    ConsoleSink sink{out};
+    return Benchmark::measure([&] {
+        run(thread_count, [&sink](size_t thread, size_t i) { write_line(sink.line(), thread, i); });
+        sink.flush();
+    });
+}
+
+// every line complete and the lines of each thread in order
+bool lines_intact(size_t thread_count)
+{
+    std::ostringstream out;
+    {
+        ConsoleSink sink{out};
+        run(thread_count, [&sink](size_t thread, size_t i) { sink.line() << "thread#" << thread << " line#" << i << "\n"; });
+    }
+
+    std::istringstream in{out.str()};
+    std::vector<size_t> next_line(thread_count, 0);
+    std::string line;
+    size_t thread, i;
+    while (std::getline(in, line))
+    {
+        if (std::sscanf(line.c_str(), "thread#%zu line#%zu", &thread, &i) != 2 || thread >= thread_count || i != next_line[thread]++)
+            return false;
+    }
+
+    for (size_t count : next_line)
+    {
+        if (count != line_count / thread_count)
+            return false;
+    }
+    return true;
+}
+
+int main()
+{
+    std::ofstream null_out{"/dev/null"};
+
+    std::cout << line_count / 1000 << "K formatted lines to /dev/null, Mlines/s\n";
+    std::cout << "threads  osyncstream  ConsoleSink  lines intact\n";
+    for (size_t thread_count : {1, 2, 4, 8, 16, 32, 64})
+    {
+        const auto osyncstream = run_osyncstream(null_out, thread_count);
+        const auto sink = run_sink(null_out, thread_count);
+
+        std::cout << std::setw(7) << thread_count << std::fixed << std::setprecision(2) << std::setw(13)
+                  << line_count / (osyncstream.count() / 1e6) / 1e6 << std::setw(13) << line_count / (sink.count() / 1e6) / 1e6
+                  << std::setw(14) << (lines_intact(thread_count) ? "yes" : "NO") << "\n";
+    }
+}
@@ -0,0 +1,93 @@
+#include "benchmark.hpp"
+#include "task_context.hpp"
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+constexpr size_t task_count = 1'000'000;
+constexpr size_t batch_size = 10'000;
+constexpr int rounds = 5;
+
+const std::vector<std::string> request_ids = {
+    "request-0000000000000000000000001", "request-0000000000000000000000002",
+    "request-0000000000000000000000003", "request-0000000000000000000000004"};
+
+thread_local std::string request_id; // the old way - copied into every hop
+
+std::atomic<size_t> mismatches{0};
+
+template <typename FSubmit>
+std::chrono::microseconds run(FSubmit submit)
+{
+    std::vector<std::future<void>> results;
+    results.reserve(batch_size);
+
+    return Benchmark::measure([&] {
+        for (size_t submitted = 0; submitted < task_count; submitted += batch_size)
+        {
+            for (size_t i = 0; i < batch_size; ++i)
+                results.push_back(submit(request_ids[(submitted + i) / 100 % request_ids.size()]));
+
+            for (auto& r : results)
+                r.get();
+            results.clear();
+        }
+    });
+}
+
+int main()
+{
+    const size_t no_of_cores = std::max(1u, std::thread::hardware_concurrency());
+    ThreadPool pool(no_of_cores);
+
+    std::cout << "Tasks: " << task_count << "; workers: " << no_of_cores << "; best of " << rounds << " rounds\n";
+
+    auto best_none = std::chrono::microseconds::max();
+    auto best_string = std::chrono::microseconds::max();
+    auto best_context = std::chrono::microseconds::max();
+
+    std::vector<ContextPtr> contexts;
+    for (const auto& id : request_ids)
+        contexts.push_back(TaskContext::make(id));
+
+    for (int round = 0; round < rounds; ++round)
+    {
+        best_none = std::min(best_none, run([&](const std::string&) {
+            return pool.submit([] { Benchmark::do_not_optimize(TaskContext::current()); });
+        }));
+
+        best_string = std::min(best_string, run([&](const std::string& id) {
+            return pool.submit([id] {
+                request_id = id;
+                if (request_id != id)
+                    mismatches.fetch_add(1, std::memory_order_relaxed);
+            });
+        }));
+
+        best_context = std::min(best_context, run([&](const std::string& id) {
+            const auto index = std::ranges::find(request_ids, id) - request_ids.begin();
+            ContextScope scope{contexts[index]}; // request handler has its context installed
+            return pool.submit([&id] {
+                const TaskContext* context = TaskContext::current();
+                if (context == nullptr || context->request_id() != id)
+                    mismatches.fetch_add(1, std::memory_order_relaxed);
+            });
+        }));
+    }
+
+    auto report = [&](std::string_view name, std::chrono::microseconds elapsed) {
+        std::cout << name << ": " << elapsed.count() * 1000.0 / task_count << "ns per task ("
+                  << (static_cast<double>(elapsed.count()) / best_none.count() - 1.0) * 100 << "% vs no context)\n";
+    };
+
+    report("no context              ", best_none);
+    report("std::string copy per hop", best_string);
+    report("refcounted TaskContext  ", best_context);
+    std::cout << "Context mismatches: " << mismatches << "\n";
+}
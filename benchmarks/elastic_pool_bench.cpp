@@ -0,0 +1,100 @@
+#include "benchmark.hpp"
+#include "elastic_thread_pool.hpp"
+#include "thread_pool.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+using namespace std::literals;
+
+// mixed workload: short CPU bursts interleaved with I/O-like waits
+constexpr int cpu_task_count = 200;
+constexpr int io_task_count = 200;
+constexpr auto io_delay = 20ms;
+
+double cpu_work()
+{
+    double result = 0.0;
+    for (int i = 1; i < 200'000; ++i)
+        result += std::sqrt(static_cast<double>(i));
+    return result;
+}
+
+template <typename TPool, typename FIoWait>
+void run_mixed_workload(TPool& pool, FIoWait io_wait)
+{
+    std::vector<std::future<void>> results;
+    results.reserve(cpu_task_count + io_task_count);
+
+    for (int i = 0; i < std::max(cpu_task_count, io_task_count); ++i)
+    {
+        if (i < cpu_task_count)
+            results.push_back(pool.submit([] { Benchmark::do_not_optimize(cpu_work()); }));
+        if (i < io_task_count)
+            results.push_back(pool.submit(io_wait));
+    }
+
+    for (auto& r : results)
+        r.get();
+}
+
+int main()
+{
+    const size_t no_of_cores = std::max(1u, std::thread::hardware_concurrency());
+    std::cout << "No of cores: " << no_of_cores << "\n";
+    std::cout << "Workload: " << cpu_task_count << " CPU tasks + " << io_task_count << " I/O tasks (" << io_delay << " each)\n\n";
+
+    const auto total_tasks = cpu_task_count + io_task_count;
+
+    auto report_throughput = [total_tasks](std::chrono::microseconds elapsed) {
+        std::cout << "  throughput: " << total_tasks * 1'000'000.0 / elapsed.count() << " tasks/s\n\n";
+    };
+
+    {
+        ThreadPool pool(no_of_cores);
+        const auto elapsed = Benchmark::report("Fixed ThreadPool(" + std::to_string(no_of_cores) + ")", [&] {
+            run_mixed_workload(pool, [] { std::this_thread::sleep_for(io_delay); });
+        });
+        report_throughput(elapsed);
+    }
+
+    {
+        ElasticThreadPool pool{{.min_threads = no_of_cores, .max_threads = 4 * no_of_cores, .idle_timeout = 200ms}};
+
+        std::atomic<bool> sampling = true;
+        std::vector<std::tuple<std::chrono::milliseconds, size_t, size_t, size_t>> timeline;
+        std::jthread sampler{[&] {
+            const auto start = Benchmark::Clock::now();
+            while (sampling)
+            {
+                const auto t = std::chrono::duration_cast<std::chrono::milliseconds>(Benchmark::Clock::now() - start);
+                timeline.emplace_back(t, pool.thread_count(), pool.blocked_count(), pool.pending_count());
+                std::this_thread::sleep_for(50ms);
+            }
+        }};
+
+        const auto elapsed = Benchmark::report("ElasticThreadPool(" + std::to_string(no_of_cores) + ".." + std::to_string(4 * no_of_cores) + ")", [&] {
+            run_mixed_workload(pool, [&pool] {
+                auto blocking = pool.blocking_section();
+                std::this_thread::sleep_for(io_delay);
+            });
+        });
+        report_throughput(elapsed);
+
+        std::this_thread::sleep_for(500ms); // surplus workers retire after idle_timeout
+        sampling = false;
+        sampler.join();
+
+        std::cout << "  time[ms] | threads | blocked | pending\n";
+        for (const auto& [t, threads, blocked, pending] : timeline)
+            std::cout << "  " << std::setw(8) << t.count() << " | " << std::setw(7) << threads << " | " << std::setw(7) << blocked << " | " << std::setw(7) << pending << "\n";
+    }
+}
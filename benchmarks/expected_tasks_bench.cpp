@@ -0,0 +1,125 @@
+#include "benchmark.hpp"
+#include "thread_pool.hpp"
+
+#include <chrono>
+#include <exception>
+#include <expected>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// calculate_square without the delay and the printing - every failure_period-th argument fails,
+// either by throwing (the main.cpp version) or by returning the error
+
+constexpr size_t task_count = 300'000;
+constexpr size_t futures_in_flight = 1000;
+
+int calculate_square(int x, int failure_period)
+{
+    if (failure_period != 0 && x % failure_period == 0)
+        throw std::runtime_error("Error#3");
+    return x * x;
+}
+
+std::expected<int, std::string> try_calculate_square(int x, int failure_period)
+{
+    if (failure_period != 0 && x % failure_period == 0)
+        return std::unexpected(std::string{"Error#3"});
+    return x * x;
+}
+
+// exceptions thrown by the task become errors (the submit overload for E constructible from std::exception_ptr)
+std::expected<int, std::exception_ptr> guarded_calculate_square(int x, int failure_period)
+{
+    return calculate_square(x, failure_period);
+}
+
+struct Result
+{
+    std::chrono::microseconds elapsed;
+    size_t failures = 0;
+};
+
+// submits task_count tasks, keeps futures_in_flight of them pending, counts failures seen by the caller
+template <typename FSubmit, typename FCollect>
+Result run(size_t thread_count, FSubmit submit, FCollect collect)
+{
+    ThreadPool pool{thread_count};
+    Result result;
+    result.elapsed = Benchmark::measure([&] {
+        using Future = decltype(submit(pool, 0));
+        std::vector<Future> futures;
+        futures.reserve(futures_in_flight);
+
+        for (size_t i = 0; i < task_count; ++i)
+        {
+            futures.push_back(submit(pool, static_cast<int>(i)));
+            if (futures.size() == futures_in_flight || i + 1 == task_count)
+            {
+                for (auto& future : futures)
+                    result.failures += collect(future);
+                futures.clear();
+            }
+        }
+    });
+    return result;
+}
+
+Result run_throwing(size_t thread_count, int failure_period)
+{
+    return run(
+        thread_count, [=](ThreadPool& pool, int x) { return pool.submit([=] { return calculate_square(x, failure_period); }); },
+        [](std::future<int>& future) -> size_t {
+            try
+            {
+                Benchmark::do_not_optimize(future.get());
+                return 0;
+            }
+            catch (const std::runtime_error&)
+            {
+                return 1;
+            }
+        });
+}
+
+template <typename FCalculate>
+Result run_expected(size_t thread_count, int failure_period, FCalculate calculate)
+{
+    return run(
+        thread_count, [=](ThreadPool& pool, int x) { return pool.submit([=] { return calculate(x, failure_period); }); },
+        [](auto& future) -> size_t {
+            auto square = future.get();
+            if (!square)
+                return 1;
+            Benchmark::do_not_optimize(*square);
+            return 0;
+        });
+}
+
+int main()
+{
+    std::cout << task_count / 1000 << "K tasks, " << futures_in_flight << " futures in flight, ns per task (failures)\n";
+
+    for (int failure_period : {0, 3})
+    {
+        std::cout << "\n" << (failure_period == 0 ? "no failures" : "every 3rd task fails (33%)") << "\n";
+        std::cout << "threads  throw / get() rethrows  expected<int, string>  expected<int, exception_ptr> (thrown)\n";
+        for (size_t thread_count : {1, 2, 4, 8})
+        {
+            const Result throwing = run_throwing(thread_count, failure_period);
+            const Result expected = run_expected(thread_count, failure_period, try_calculate_square);
+            const Result guarded = run_expected(thread_count, failure_period, guarded_calculate_square);
+
+            std::cout << std::setw(7) << thread_count;
+            for (const Result& result : {throwing, expected, guarded})
+            {
+                std::cout << std::setw(13) << result.elapsed.count() * 1000 / task_count << " (" << std::setw(6) << result.failures
+                          << ")   ";
+            }
+            std::cout << "\n";
+        }
+    }
+}
@@ -0,0 +1,137 @@
+#include "benchmark.hpp"
+#include "future_cache.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// expensive pure computation requested by many threads with Zipf-skewed keys
+
+constexpr size_t key_count = 10'000;
+constexpr size_t thread_count = 16;
+constexpr size_t requests_per_thread = 2'000;
+constexpr auto computation_time = std::chrono::microseconds{200};
+
+// P(key k) ~ 1 / (k + 1)^skew
+class ZipfDistribution
+{
+    std::vector<double> cdf_;
+
+public:
+    ZipfDistribution(size_t n, double skew)
+        : cdf_(n)
+    {
+        double sum = 0;
+        for (size_t k = 0; k < n; ++k)
+            cdf_[k] = sum += 1.0 / std::pow(static_cast<double>(k + 1), skew);
+        for (auto& p : cdf_)
+            p /= sum;
+    }
+
+    template <typename TGenerator>
+    size_t operator()(TGenerator& generator) const
+    {
+        const double u = std::uniform_real_distribution<>{0.0, 1.0}(generator);
+        return std::min<size_t>(std::lower_bound(cdf_.begin(), cdf_.end(), u) - cdf_.begin(), cdf_.size() - 1);
+    }
+};
+
+// calculate_square without the printing - every seventh key fails
+uint64_t calculate_square(uint64_t x)
+{
+    const auto deadline = std::chrono::steady_clock::now() + computation_time;
+    while (std::chrono::steady_clock::now() < deadline)
+    {
+    }
+
+    if (x % 7 == 0)
+        throw std::runtime_error("Error#7");
+    return x * x;
+}
+
+struct Result
+{
+    std::chrono::microseconds elapsed;
+    FutureCacheStats stats;
+};
+
+template <typename TRequest>
+std::chrono::microseconds run_requests(double skew, TRequest request)
+{
+    const ZipfDistribution zipf{key_count, skew};
+
+    return Benchmark::measure([&] {
+        std::vector<std::jthread> threads;
+        for (size_t t = 0; t < thread_count; ++t)
+        {
+            threads.emplace_back([&, t] {
+                std::mt19937_64 rnd{t};
+                uint64_t sum = 0;
+                for (size_t i = 0; i < requests_per_thread; ++i)
+                {
+                    try
+                    {
+                        sum += request(zipf(rnd));
+                    }
+                    catch (const std::runtime_error&)
+                    {
+                    }
+                }
+                Benchmark::do_not_optimize(sum);
+            });
+        }
+    });
+}
+
+Result run_cached(double skew, FutureCacheConfig config)
+{
+    FutureCache<uint64_t, uint64_t> cache{config};
+    Result result;
+    result.elapsed = run_requests(skew, [&cache](uint64_t key) { return cache.get(key, [key] { return calculate_square(key); }).get(); });
+    result.stats = cache.stats();
+    return result;
+}
+
+void print(std::string_view name, const Result& result, std::chrono::microseconds uncached)
+{
+    const auto& stats = result.stats;
+    std::cout << std::left << std::setw(33) << name << std::right << ": " << std::setw(6) << result.elapsed.count() / 1000 << " ms (" << std::fixed << std::setprecision(1)
+              << std::setw(5) << static_cast<double>(uncached.count()) / result.elapsed.count() << "x), hit rate " << std::setw(5)
+              << 100 * stats.hit_rate() << "%, computations " << std::setw(5) << stats.computations << ", shared in flight "
+              << std::setw(4) << stats.joined << ", failures " << std::setw(4) << stats.failures << ", evictions " << stats.evictions
+              << "\n";
+}
+
+int main()
+{
+    std::cout << thread_count << " threads x " << requests_per_thread << " requests over " << key_count << " keys, "
+              << computation_time.count() << " us per computation, every 7th key throws\n";
+
+    for (double skew : {0.8, 1.0, 1.2})
+    {
+        std::cout << "\nZipf skew " << skew << "\n";
+
+        const auto uncached = run_requests(skew, [](uint64_t key) { return calculate_square(key); });
+        std::cout << std::left << std::setw(33) << "no cache" << std::right << ": " << std::setw(6) << uncached.count() / 1000 << " ms, computations "
+                  << thread_count * requests_per_thread << "\n";
+
+        for (size_t capacity : {100, 1000})
+        {
+            for (auto policy : {ExceptionPolicy::retry, ExceptionPolicy::cache})
+            {
+                const std::string name = "capacity " + std::to_string(capacity) + ", exceptions "
+                    + (policy == ExceptionPolicy::retry ? "retried" : "cached");
+                print(name, run_cached(skew, {.capacity = capacity, .exceptions = policy}), uncached);
+            }
+        }
+    }
+}
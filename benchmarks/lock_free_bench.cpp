@@ -0,0 +1,136 @@
+#include "benchmark.hpp"
+#include "lock_free_queue.hpp"
+#include "lock_free_stack.hpp"
+#include "reclamation.hpp"
+#include "thread_safe_queue.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// every thread alternates push and try_pop on one shared container - throughput plus the peak number of
+// nodes retired but not yet freed (the memory the reclamation scheme holds back)
+
+constexpr size_t total_operations = 4'000'000;
+constexpr size_t prefill = 1024;
+
+struct NoDomain
+{
+    size_t retired_count() const
+    {
+        return 0;
+    }
+};
+
+struct Result
+{
+    std::chrono::microseconds elapsed;
+    size_t peak_retired = 0;
+};
+
+// stalled_reader - one extra thread holds a guard for the whole run
+template <typename TContainer, typename TDomain>
+Result run(TContainer& container, TDomain& domain, size_t thread_count, bool stalled_reader = false)
+{
+    for (size_t i = 0; i < prefill; ++i)
+        container.push(i);
+
+    Result result;
+    std::atomic<bool> done{false};
+    std::jthread monitor{[&] {
+        while (!done.load(std::memory_order_relaxed))
+        {
+            result.peak_retired = std::max(result.peak_retired, domain.retired_count());
+            std::this_thread::sleep_for(std::chrono::microseconds{200});
+        }
+    }};
+
+    std::jthread staller;
+    std::atomic<bool> pinned{false};
+    if constexpr (!std::is_same_v<TDomain, NoDomain>)
+    {
+        if (stalled_reader)
+        {
+            staller = std::jthread{[&] {
+                auto guard = domain.pin();
+                pinned = true;
+                while (!done.load(std::memory_order_relaxed))
+                    std::this_thread::sleep_for(std::chrono::milliseconds{1});
+            }};
+            while (!pinned)
+                std::this_thread::yield();
+        }
+    }
+
+    result.elapsed = Benchmark::measure([&] {
+        std::vector<std::jthread> threads;
+        for (size_t t = 0; t < thread_count; ++t)
+        {
+            threads.emplace_back([&container, thread_count] {
+                uint64_t sum = 0;
+                for (size_t i = 0; i < total_operations / thread_count / 2; ++i)
+                {
+                    container.push(i);
+                    if (auto item = container.try_pop())
+                        sum += *item;
+                }
+                Benchmark::do_not_optimize(sum);
+            });
+        }
+    });
+
+    done = true;
+    return result;
+}
+
+template <typename TContainer, typename TDomain>
+void report(std::string_view name, size_t thread_count, bool stalled_reader = false)
+{
+    TDomain domain;
+    Result result;
+    if constexpr (std::is_same_v<TDomain, NoDomain>)
+    {
+        TContainer container;
+        result = run(container, domain, thread_count);
+    }
+    else
+    {
+        TContainer container{domain};
+        result = run(container, domain, thread_count, stalled_reader);
+    }
+
+    std::cout << name << " " << std::setw(2) << thread_count << " threads: " << std::fixed << std::setprecision(2) << std::setw(6)
+              << total_operations / (result.elapsed.count() / 1e6) / 1e6 << "M ops/s, peak retired " << result.peak_retired << "\n";
+}
+
+int main()
+{
+    using Reclamation::EpochDomain;
+    using Reclamation::HazardDomain;
+
+    std::cout << total_operations / 1'000'000 << "M operations (push + try_pop pairs) per run\n";
+
+    for (size_t thread_count : {1, 2, 4, 8, 16, 32, 64})
+    {
+        report<ThreadSafeQueue<uint64_t>, NoDomain>("ThreadSafeQueue             ", thread_count);
+        report<LockFreeQueue<uint64_t, EpochDomain>, EpochDomain>("LockFreeQueue  (epoch)      ", thread_count);
+        report<LockFreeQueue<uint64_t, HazardDomain>, HazardDomain>("LockFreeQueue  (hazard)     ", thread_count);
+        report<LockFreeStack<uint64_t, EpochDomain>, EpochDomain>("LockFreeStack  (epoch)      ", thread_count);
+        report<LockFreeStack<uint64_t, HazardDomain>, HazardDomain>("LockFreeStack  (hazard)     ", thread_count);
+        std::cout << "\n";
+    }
+
+    std::cout << "memory bound - one more thread holds a guard during the whole run\n";
+    for (size_t thread_count : {4, 64})
+    {
+        report<LockFreeQueue<uint64_t, EpochDomain>, EpochDomain>("LockFreeQueue  (epoch)      ", thread_count, true);
+        report<LockFreeQueue<uint64_t, HazardDomain>, HazardDomain>("LockFreeQueue  (hazard)     ", thread_count, true);
+    }
+}
@@ -0,0 +1,231 @@
+#include "benchmark.hpp"
+#include "lookup_table.hpp"
+#include "pool_metrics.hpp"
+#include "spin_lock.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+using namespace LookupTable;
+
+constexpr int rounds = 3;
+
+template <typename F>
+std::chrono::microseconds best_of(F f)
+{
+    auto best = std::chrono::microseconds::max();
+    for (int round = 0; round < rounds; ++round)
+        best = std::min(best, Benchmark::measure(f));
+    return best;
+}
+
+void report(std::string_view name, std::chrono::microseconds runtime, std::chrono::microseconds table)
+{
+    std::cout << name << ": computed " << runtime << ", table " << table << " ("
+              << static_cast<double>(runtime.count()) / table.count() << "x)\n";
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// factorial - as in synchronization-locking
+
+constexpr uint64_t factorial(uint64_t n)
+{
+    return n <= 1 ? 1 : checked_mul(n, factorial(n - 1));
+}
+
+constexpr auto factorial_table = make_lookup_table<21>(factorial);
+
+void factorial_bench()
+{
+    constexpr uint64_t count = 100'000'000;
+    volatile uint64_t n_max = 20; // keeps the compiler from folding the computed variant
+
+    const auto computed = best_of([&] {
+        uint64_t sum = 0;
+        for (uint64_t i = 0; i < count; ++i)
+            sum += factorial(i % (n_max + 1));
+        Benchmark::do_not_optimize(sum);
+    });
+
+    const auto table = best_of([&] {
+        uint64_t sum = 0;
+        for (uint64_t i = 0; i < count; ++i)
+            sum += factorial_table[i % (n_max + 1)];
+        Benchmark::do_not_optimize(sum);
+    });
+
+    report("factorial(n), 100M calls              ", computed, table);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// histogram bucket bounds - percentile queries of PoolMetrics::HistogramSnapshot
+
+uint64_t computed_lower_bound(size_t index)
+{
+    using H = PoolMetrics::LatencyHistogram;
+    if (index < H::sub_bucket_count)
+        return index;
+
+    const size_t shift = index / H::sub_bucket_count - 1;
+    return (H::sub_bucket_count + index % H::sub_bucket_count) << shift;
+}
+
+void histogram_bench()
+{
+    using H = PoolMetrics::LatencyHistogram;
+    constexpr size_t count = 100'000'000;
+    volatile size_t bucket_count = H::bucket_count;
+
+    const auto computed = best_of([&] {
+        uint64_t sum = 0;
+        for (size_t i = 0; i < count; ++i)
+            sum += computed_lower_bound(i % bucket_count);
+        Benchmark::do_not_optimize(sum);
+    });
+
+    const auto table = best_of([&] {
+        uint64_t sum = 0;
+        for (size_t i = 0; i < count; ++i)
+            sum += H::bucket_lower_bound(i % bucket_count);
+        Benchmark::do_not_optimize(sum);
+    });
+
+    report("histogram bucket bound, 100M lookups  ", computed, table);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// pi kernel - acceptance thresholds per x cell vs x^2 + y^2 < 1 in fixed point
+
+namespace Pi
+{
+    constexpr int coordinate_bits = 31;
+    constexpr int cell_bits = 12;
+    constexpr uint64_t one_squared = uint64_t{1} << (2 * coordinate_bits);
+
+    // y below accept[cell] is a hit for every x of the cell, y at or above reject[cell] a miss for every x
+    constexpr auto accept = make_lookup_table<size_t{1} << cell_bits, uint32_t>([](size_t cell) {
+        const uint64_t x = checked_shl(uint64_t{cell + 1}, coordinate_bits - cell_bits); // right edge
+        return isqrt(one_squared - x * x);
+    });
+
+    constexpr auto reject = make_lookup_table<size_t{1} << cell_bits, uint32_t>([](size_t cell) {
+        const uint64_t x = checked_shl(uint64_t{cell}, coordinate_bits - cell_bits); // left edge
+        const uint64_t y_squared = one_squared - x * x;
+        const uint64_t y = isqrt(y_squared);
+        return y + (y * y != y_squared); // rounded up
+    });
+
+    uint64_t floating_point(uint64_t count)
+    {
+        std::mt19937_64 rnd_gen(42);
+        std::uniform_real_distribution<double> rnd_distr(0.0, 1.0);
+
+        uint64_t hits = 0;
+        for (uint64_t n = 0; n < count; ++n)
+        {
+            double x = rnd_distr(rnd_gen);
+            double y = rnd_distr(rnd_gen);
+            if (x * x + y * y < 1)
+                ++hits;
+        }
+        return hits;
+    }
+
+    uint64_t fixed_point(uint64_t count)
+    {
+        std::mt19937_64 rnd_gen(42);
+
+        uint64_t hits = 0;
+        for (uint64_t n = 0; n < count; ++n)
+        {
+            const uint64_t r = rnd_gen();
+            const uint64_t x = r >> (64 - coordinate_bits);
+            const uint64_t y = r & ((uint64_t{1} << coordinate_bits) - 1);
+            hits += (x * x + y * y < one_squared);
+        }
+        return hits;
+    }
+
+    uint64_t thresholds(uint64_t count)
+    {
+        std::mt19937_64 rnd_gen(42);
+
+        uint64_t hits = 0;
+        for (uint64_t n = 0; n < count; ++n)
+        {
+            const uint64_t r = rnd_gen();
+            const uint64_t x = r >> (64 - coordinate_bits);
+            const uint64_t y = r & ((uint64_t{1} << coordinate_bits) - 1);
+            const size_t cell = x >> (coordinate_bits - cell_bits);
+            hits += (y < accept[cell]) | ((y < reject[cell]) & (x * x + y * y < one_squared));
+        }
+        return hits;
+    }
+} // namespace Pi
+
+void pi_bench()
+{
+    constexpr uint64_t count = 100'000'000;
+    uint64_t hits_fp = 0, hits_fixed = 0, hits_table = 0;
+
+    const auto fp = best_of([&] { hits_fp = Pi::floating_point(count); });
+    const auto fixed = best_of([&] { hits_fixed = Pi::fixed_point(count); });
+    const auto table = best_of([&] { hits_table = Pi::thresholds(count); });
+
+    if (hits_fixed != hits_table)
+        std::cout << "!!! threshold table differs from the exact test\n";
+    Benchmark::do_not_optimize(hits_fp);
+
+    std::cout << "pi kernel, 100M points: double " << fp << ", fixed point " << fixed << ", threshold table " << table
+              << " (pi ~ " << 4.0 * hits_table / count << ")\n";
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// spin lock with the precomputed backoff schedule
+
+template <typename TMutex>
+std::chrono::microseconds increments(size_t thread_count)
+{
+    constexpr size_t count = 10'000'000;
+    TMutex mtx;
+    uint64_t counter = 0;
+
+    return best_of([&] {
+        std::vector<std::jthread> threads;
+        for (size_t i = 0; i < thread_count; ++i)
+        {
+            threads.emplace_back([&] {
+                for (size_t n = 0; n < count / thread_count; ++n)
+                {
+                    std::lock_guard lk{mtx};
+                    ++counter;
+                }
+            });
+        }
+    });
+}
+
+int main()
+{
+    std::cout << "Compile-time lookup tables vs runtime computation (best of " << rounds << " rounds)\n";
+
+    factorial_bench();
+    histogram_bench();
+    pi_bench();
+
+    std::cout << "backoff schedule:";
+    for (size_t step = 0; step < Backoff::spin_steps; ++step)
+        std::cout << " " << Backoff::pauses(step);
+    std::cout << " pauses, then yield\n";
+
+    for (size_t thread_count : {1, 2, 4})
+        std::cout << "10M lock/unlock, " << thread_count << " thread(s): std::mutex " << increments<std::mutex>(thread_count)
+                  << ", SpinLock " << increments<SpinLock>(thread_count) << "\n";
+}
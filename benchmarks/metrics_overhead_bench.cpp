@@ -0,0 +1,78 @@
+#include "benchmark.hpp"
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std::literals;
+
+// calibrated busy loop - ~1us of work per task
+uint64_t spin(uint64_t iterations)
+{
+    uint64_t x = 0x9E3779B97F4A7C15ull;
+    for (uint64_t i = 0; i < iterations; ++i)
+        x ^= x * 6364136223846793005ull + i;
+    return x;
+}
+
+uint64_t iterations_per_microsecond()
+{
+    const uint64_t probe = 10'000'000;
+    const auto elapsed = Benchmark::measure([=] { Benchmark::do_not_optimize(spin(probe)); });
+    return std::max<uint64_t>(1, probe / std::max<int64_t>(1, elapsed.count()));
+}
+
+template <typename TPool>
+std::chrono::microseconds run_tasks(TPool& pool, size_t task_count, uint64_t iterations)
+{
+    constexpr size_t batch_size = 10'000;
+    std::vector<std::future<void>> results;
+    results.reserve(batch_size);
+
+    return Benchmark::measure([&] {
+        for (size_t submitted = 0; submitted < task_count; submitted += batch_size)
+        {
+            for (size_t i = 0; i < batch_size; ++i)
+                results.push_back(pool.submit([iterations] { Benchmark::do_not_optimize(spin(iterations)); }));
+
+            for (auto& r : results)
+                r.get();
+            results.clear();
+        }
+    });
+}
+
+int main()
+{
+    const size_t no_of_cores = std::max(1u, std::thread::hardware_concurrency());
+    const size_t task_count = 1'000'000;
+    const int rounds = 5;
+    const uint64_t iterations = iterations_per_microsecond();
+
+    std::cout << "Tasks: " << task_count << " x ~1us; workers: " << no_of_cores << "; best of " << rounds << " rounds\n";
+
+    ThreadPool plain_pool(no_of_cores);
+    InstrumentedThreadPool instrumented_pool(no_of_cores);
+
+    auto best_plain = std::chrono::microseconds::max();
+    auto best_instrumented = std::chrono::microseconds::max();
+
+    for (int round = 0; round < rounds; ++round) // interleaved to cancel out frequency drift
+    {
+        best_plain = std::min(best_plain, run_tasks(plain_pool, task_count, iterations));
+        best_instrumented = std::min(best_instrumented, run_tasks(instrumented_pool, task_count, iterations));
+    }
+
+    const double overhead = (static_cast<double>(best_instrumented.count()) / best_plain.count() - 1.0) * 100.0;
+
+    std::cout << "ThreadPool (metrics disabled): " << std::chrono::duration_cast<std::chrono::milliseconds>(best_plain) << "\n";
+    std::cout << "InstrumentedThreadPool:        " << std::chrono::duration_cast<std::chrono::milliseconds>(best_instrumented) << "\n";
+    std::cout << "Overhead: " << overhead << "% (budget: 2%) - " << (overhead < 2.0 ? "OK" : "OVER BUDGET") << "\n\n";
+
+    std::cout << instrumented_pool.metrics();
+}
@@ -0,0 +1,99 @@
+#include "benchmark.hpp"
+#include "ordered_lock.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+constexpr int transfer_count = 2'000'000; // per thread
+constexpr int rounds = 5;
+
+// BankAccount from _exercises/synchronization reduced to the transfer
+struct ScopedLockAccount
+{
+    double balance = 0;
+    std::recursive_mutex mtx;
+
+    ScopedLockAccount(uint64_t /*id*/) { }
+
+    void transfer(ScopedLockAccount& to, double amount)
+    {
+        std::scoped_lock lk{mtx, to.mtx};
+        balance -= amount;
+        to.balance += amount;
+    }
+};
+
+struct OrderedLockAccount
+{
+    double balance = 0;
+    RankedMutex<std::recursive_mutex> mtx;
+
+    OrderedLockAccount(uint64_t id)
+        : mtx{id}
+    {
+    }
+
+    void transfer(OrderedLockAccount& to, double amount)
+    {
+        OrderedLock lk{mtx, to.mtx};
+        balance -= amount;
+        to.balance += amount;
+    }
+};
+
+// pairs of threads transferring in opposite directions between the same two accounts (thd3/thd4)
+template <typename TAccount>
+double transfers_per_second(size_t thread_pairs)
+{
+    auto best = std::chrono::microseconds::max();
+
+    for (int round = 0; round < rounds; ++round)
+    {
+        TAccount ba1{1}, ba2{2};
+
+        best = std::min(best, Benchmark::measure([&] {
+            std::vector<std::jthread> threads;
+            for (size_t i = 0; i < thread_pairs; ++i)
+            {
+                threads.emplace_back([&] { for (int n = 0; n < transfer_count; ++n) ba1.transfer(ba2, 1.0); });
+                threads.emplace_back([&] { for (int n = 0; n < transfer_count; ++n) ba2.transfer(ba1, 1.0); });
+            }
+        }));
+
+        if (ba1.balance != 0 || ba2.balance != 0)
+            std::cout << "!!! balances do not match\n";
+    }
+
+    return 2.0 * thread_pairs * transfer_count / (best.count() / 1e6);
+}
+
+int main()
+{
+    std::cout << "Two-way transfer storm, " << transfer_count << " transfers per thread (best of " << rounds << " rounds)";
+    std::cout << (ORDERED_LOCK_CHECKS ? " - order checks ON\n" : "\n");
+
+    for (size_t pairs : {1, 2, 4})
+    {
+        const double scoped = transfers_per_second<ScopedLockAccount>(pairs);
+        const double ordered = transfers_per_second<OrderedLockAccount>(pairs);
+        std::cout << 2 * pairs << " threads: scoped_lock " << scoped / 1e6 << "M/s, OrderedLock " << ordered / 1e6 << "M/s ("
+                  << ordered / scoped << "x)\n";
+    }
+
+    // debug mode catches an inverted order even when it does not deadlock
+    RankedMutex<std::mutex> low{1}, high{2};
+    std::lock_guard lk_high{high};
+    try
+    {
+        if (ORDERED_LOCK_CHECKS)
+            std::lock_guard lk_low{low};
+    }
+    catch (const LockOrderViolation& e)
+    {
+        std::cout << "LockOrderViolation: " << e.what() << "\n";
+    }
+}
@@ -0,0 +1,102 @@
+#include "benchmark.hpp"
+#include "parallel_algorithms.hpp"
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(HAS_STD_EXECUTION_PAR) || defined(_MSC_VER)
+#include <execution>
+#define BENCHMARK_STD_PAR 1
+#endif
+
+constexpr size_t size = 10'000'000;
+
+std::vector<double> random_data()
+{
+    std::mt19937_64 rnd_gen{42};
+    std::uniform_real_distribution<double> rnd_distr(0.0, 1000.0);
+
+    std::vector<double> data(size);
+    std::ranges::generate(data, [&] { return rnd_distr(rnd_gen); });
+    return data;
+}
+
+void check(bool ok, std::string_view what)
+{
+    if (!ok)
+        std::cout << "  !!! " << what << " - results differ\n";
+}
+
+int main()
+{
+    const size_t no_of_cores = std::max(1u, std::thread::hardware_concurrency());
+    ThreadPool pool(no_of_cores);
+
+    std::cout << "Elements: " << size << "; workers: " << no_of_cores << "\n";
+#ifndef BENCHMARK_STD_PAR
+    std::cout << "std::execution::par not available (configure with TBB)\n";
+#endif
+
+    const std::vector<double> input = random_data();
+    auto heavy = [](double& x) { x = std::sqrt(x) * std::log1p(x); };
+    auto square = [](double x) { return x * x; };
+
+    std::cout << "\n--- for_each\n";
+    {
+        auto serial = input, par = input;
+        Benchmark::report("serial", [&] { std::for_each(serial.begin(), serial.end(), heavy); });
+        Benchmark::report("parallel::for_each", [&] { parallel::for_each(pool, par.begin(), par.end(), heavy); });
+        check(serial == par, "for_each");
+#ifdef BENCHMARK_STD_PAR
+        auto std_par = input;
+        Benchmark::report("std::execution::par", [&] { std::for_each(std::execution::par, std_par.begin(), std_par.end(), heavy); });
+#endif
+    }
+
+    std::cout << "\n--- transform_reduce\n";
+    {
+        double serial{}, par{};
+        Benchmark::report("serial", [&] { serial = std::transform_reduce(input.begin(), input.end(), 0.0, std::plus<>{}, square); });
+        Benchmark::report("parallel::transform_reduce", [&] { par = parallel::transform_reduce(pool, input.begin(), input.end(), 0.0, std::plus<>{}, square); });
+        check(std::abs(serial - par) <= 1e-9 * std::abs(serial), "transform_reduce");
+#ifdef BENCHMARK_STD_PAR
+        double std_par{};
+        Benchmark::report("std::execution::par", [&] { std_par = std::transform_reduce(std::execution::par, input.begin(), input.end(), 0.0, std::plus<>{}, square); });
+        Benchmark::do_not_optimize(std_par);
+#endif
+    }
+
+    std::cout << "\n--- inclusive_scan\n";
+    {
+        std::vector<long> values(size);
+        std::iota(values.begin(), values.end(), 0L);
+        std::vector<long> serial(size), par(size);
+        Benchmark::report("serial", [&] { std::inclusive_scan(values.begin(), values.end(), serial.begin()); });
+        Benchmark::report("parallel::inclusive_scan", [&] { parallel::inclusive_scan(pool, values.begin(), values.end(), par.begin()); });
+        check(serial == par, "inclusive_scan");
+#ifdef BENCHMARK_STD_PAR
+        std::vector<long> std_par(size);
+        Benchmark::report("std::execution::par", [&] { std::inclusive_scan(std::execution::par, values.begin(), values.end(), std_par.begin()); });
+#endif
+    }
+
+    std::cout << "\n--- sort\n";
+    {
+        auto serial = input, par = input;
+        Benchmark::report("serial", [&] { std::sort(serial.begin(), serial.end()); });
+        Benchmark::report("parallel::sort", [&] { parallel::sort(pool, par.begin(), par.end()); });
+        check(serial == par, "sort");
+#ifdef BENCHMARK_STD_PAR
+        auto std_par = input;
+        Benchmark::report("std::execution::par", [&] { std::sort(std::execution::par, std_par.begin(), std_par.end()); });
+#endif
+    }
+}
@@ -0,0 +1,90 @@
+#include "benchmark.hpp"
+#include "pipeline.hpp"
+#include "thread_pool.hpp"
+
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <system_error>
+
+// pipeline_bench [count] - streams count integers (default 100M) as text through parse -> filter -> sum
+
+// the ingest side: decimal text, as read from a socket or a file
+class TextSource
+{
+    uint64_t next_ = 0;
+    const uint64_t count_;
+
+public:
+    explicit TextSource(uint64_t count)
+        : count_{count}
+    {
+    }
+
+    std::optional<std::string> operator()()
+    {
+        if (next_ == count_)
+            return std::nullopt;
+
+        char buffer[24];
+        const auto [end, ec] = std::to_chars(buffer, buffer + sizeof(buffer), next_++);
+        return std::string(buffer, end);
+    }
+};
+
+uint64_t parse(const std::string& text)
+{
+    uint64_t value = 0;
+    std::from_chars(text.data(), text.data() + text.size(), value);
+    return value;
+}
+
+bool is_selected(uint64_t value)
+{
+    return value % 3 != 0;
+}
+
+void run_pipeline(ThreadPool& pool, uint64_t count, size_t parse_parallelism, Pipeline::Order order, uint64_t expected)
+{
+    std::atomic<uint64_t> sum{0};
+
+    // summing a batch locally would be faster - the per-item atomic keeps the sink honest about its cost
+    const auto report = Pipeline::source({.name = "read", .batch_size = 1024}, TextSource{count})
+                            .map({.name = "parse", .parallelism = parse_parallelism, .order = order}, [](std::string&& text) { return parse(text); })
+                            .filter({.name = "filter", .order = order}, is_selected)
+                            .sink({.name = "sum", .order = order}, [&sum](uint64_t value) { sum.fetch_add(value, std::memory_order_relaxed); })
+                            .run(pool);
+
+    std::cout << "parse x" << parse_parallelism << (order == Pipeline::Order::preserved ? ", ordered" : ", unordered")
+              << (sum == expected ? "" : " !!! wrong sum") << " - " << report;
+}
+
+int main(int argc, char* argv[])
+{
+    const uint64_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100'000'000;
+    std::cout << "Pipeline: " << count / 1'000'000 << "M integers, read -> parse -> filter -> sum\n\n";
+
+    uint64_t expected = 0;
+    const auto sequential = Benchmark::measure([&] {
+        TextSource source{count};
+        uint64_t sum = 0;
+        while (auto text = source())
+        {
+            const auto value = parse(*text);
+            if (is_selected(value))
+                sum += value;
+        }
+        expected = sum;
+    });
+    std::cout << "single loop: " << std::chrono::duration_cast<std::chrono::milliseconds>(sequential) << "\n\n";
+
+    ThreadPool pool{8};
+    run_pipeline(pool, count, 1, Pipeline::Order::preserved, expected);
+    run_pipeline(pool, count, 4, Pipeline::Order::preserved, expected);
+    run_pipeline(pool, count, 4, Pipeline::Order::unordered, expected);
+}
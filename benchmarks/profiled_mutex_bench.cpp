@@ -0,0 +1,72 @@
+#include "benchmark.hpp"
+#include "profiled_mutex.hpp"
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <iostream>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+constexpr size_t operation_count = 10'000'000;
+constexpr int rounds = 5;
+
+template <typename TMutex>
+std::chrono::microseconds increments(size_t thread_count)
+{
+    TMutex mtx;
+    uint64_t counter = 0;
+
+    auto best = std::chrono::microseconds::max();
+    for (int round = 0; round < rounds; ++round)
+    {
+        best = std::min(best, Benchmark::measure([&] {
+            std::vector<std::jthread> threads;
+            for (size_t i = 0; i < thread_count; ++i)
+            {
+                threads.emplace_back([&] {
+                    for (size_t n = 0; n < operation_count / thread_count; ++n)
+                    {
+                        std::lock_guard lk{mtx};
+                        ++counter;
+                    }
+                });
+            }
+        }));
+    }
+
+    Benchmark::do_not_optimize(counter);
+    return best;
+}
+
+void compare(size_t thread_count)
+{
+    const auto plain = increments<std::mutex>(thread_count);
+    const auto profiled = increments<ProfiledMutex<std::mutex, "bench counter">>(thread_count);
+
+    std::cout << thread_count << " thread(s): std::mutex " << plain.count() * 1000.0 / operation_count << "ns/op, ProfiledMutex "
+              << profiled.count() * 1000.0 / operation_count << "ns/op\n";
+}
+
+int main()
+{
+    std::cout << "Lock/unlock of a shared counter, " << operation_count << " operations (best of " << rounds << " rounds)\n";
+    for (size_t thread_count : {1, 2, 4})
+        compare(thread_count);
+
+    // the instrumented pool profiles its queue lock
+    {
+        InstrumentedThreadPool pool(std::max(1u, std::thread::hardware_concurrency()));
+        std::vector<std::future<void>> results;
+        for (size_t i = 0; i < 200'000; ++i)
+            results.push_back(pool.submit([i] { Benchmark::do_not_optimize(i); }));
+        for (auto& r : results)
+            r.get();
+    }
+
+    std::cout << "\n";
+    LockProfiling::report(std::cout);
+}
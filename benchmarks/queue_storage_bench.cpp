@@ -0,0 +1,135 @@
+#include "allocation_counter.hpp"
+#include "benchmark.hpp"
+#include "pool_metrics.hpp"
+#include "thread_safe_queue.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string_view>
+#include <thread>
+
+// what the thread pools queue - the captures fit into the small buffer, so the task itself never allocates
+using Task = std::move_only_function<void()>;
+
+constexpr size_t burst = 1000; // queue depth oscillates between 0 and burst
+constexpr size_t bursts = 1000;
+
+uint64_t now_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+Task make_task(uint64_t& sink, size_t i)
+{
+    return [&sink, i] { sink += i; };
+}
+
+void print_percentiles(std::string_view name, const PoolMetrics::HistogramSnapshot& h)
+{
+    std::cout << "    " << name << " p50 " << h.percentile(50) << ", p99 " << h.percentile(99) << ", p99.9 " << h.percentile(99.9)
+              << ", p99.99 " << h.percentile(99.99) << "\n";
+}
+
+// single thread: push a burst, pop it - per-call latency of push and pop
+template <typename TQueue>
+void oscillating(std::string_view name)
+{
+    TQueue queue;
+    uint64_t sink = 0;
+
+    auto run_bursts = [&](PoolMetrics::LatencyHistogram* push_latency, PoolMetrics::LatencyHistogram* pop_latency) {
+        for (size_t b = 0; b < bursts; ++b)
+        {
+            for (size_t i = 0; i < burst; ++i)
+            {
+                Task task = make_task(sink, i);
+                const auto start = now_ns();
+                queue.push(std::move(task));
+                if (push_latency)
+                    push_latency->record(now_ns() - start);
+            }
+
+            for (size_t i = 0; i < burst; ++i)
+            {
+                const auto start = now_ns();
+                Task task;
+                queue.try_pop(task);
+                if (pop_latency)
+                    pop_latency->record(now_ns() - start);
+                task();
+            }
+        }
+    };
+
+    run_bursts(nullptr, nullptr); // warm-up: reach the high-water mark
+
+    PoolMetrics::LatencyHistogram push_latency, pop_latency;
+    const auto allocations_before = Benchmark::allocation_count();
+    const auto elapsed = Benchmark::measure([&] { run_bursts(&push_latency, &pop_latency); });
+    const auto allocations = Benchmark::allocation_count() - allocations_before;
+    Benchmark::do_not_optimize(sink);
+
+    const double ops = 2.0 * burst * bursts;
+    std::cout << name << ": " << std::fixed << std::setprecision(1) << allocations * 1e6 / ops << " allocations / 1M ops, "
+              << elapsed.count() * 1e3 / ops << " ns/op (incl. timing)\n";
+
+    PoolMetrics::HistogramSnapshot push_snapshot, pop_snapshot;
+    push_snapshot.merge(push_latency);
+    pop_snapshot.merge(pop_latency);
+    print_percentiles("push", push_snapshot);
+    print_percentiles("pop ", pop_snapshot);
+}
+
+// one producer, one consumer - allocations in a steady stream
+template <typename TQueue>
+void streaming(std::string_view name)
+{
+    constexpr size_t count = 2'000'000;
+
+    TQueue queue;
+    uint64_t sink = 0;
+    uint64_t allocations = 0;
+
+    const auto elapsed = Benchmark::measure([&] {
+        std::jthread consumer{[&] {
+            Task task;
+            for (size_t i = 0; i < count; ++i)
+            {
+                queue.pop(task);
+                task();
+            }
+        }};
+
+        // thread start-up allocates - measure from here on
+        const auto allocations_before = Benchmark::allocation_count();
+        for (size_t i = 0; i < count; ++i)
+            queue.push(make_task(sink, i));
+
+        while (!queue.empty())
+            std::this_thread::yield();
+        allocations = Benchmark::allocation_count() - allocations_before;
+    });
+    Benchmark::do_not_optimize(sink);
+
+    std::cout << name << ": " << std::fixed << std::setprecision(1) << allocations * 1e6 / (2.0 * count)
+              << " allocations / 1M ops, " << elapsed.count() * 1e3 / (2.0 * count) << " ns/op\n";
+}
+
+int main()
+{
+    std::cout << "ThreadSafeQueue<std::move_only_function<void()>> storage (sizeof(Task) = " << sizeof(Task) << ")\n\n";
+
+    std::cout << "single thread, queue depth oscillating 0.." << burst << ":\n";
+    oscillating<ThreadSafeQueue<Task>>("std::deque  ");
+    oscillating<ChunkedThreadSafeQueue<Task>>("ChunkedDeque");
+    oscillating<RingThreadSafeQueue<Task>>("RingBuffer  ");
+
+    std::cout << "\n1 producer / 1 consumer, 2M tasks:\n";
+    streaming<ThreadSafeQueue<Task>>("std::deque  ");
+    streaming<ChunkedThreadSafeQueue<Task>>("ChunkedDeque");
+    streaming<RingThreadSafeQueue<Task>>("RingBuffer  ");
+}
@@ -0,0 +1,228 @@
+#include "benchmark.hpp"
+#include "thread_safe_queue.hpp"
+
+#include <linux/perf_event.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// ThreadSafeQueue before waiter-aware wakeups - notifies on every push, wakes everybody for a batch
+template <typename T>
+class AlwaysNotifyQueue
+{
+    std::queue<T> q_;
+    bool closed_ = false;
+    std::mutex mtx_q_;
+    std::condition_variable cv_q_not_empty_;
+
+public:
+    void push(const T& item)
+    {
+        {
+            std::lock_guard lk{mtx_q_};
+            q_.push(item);
+        }
+        cv_q_not_empty_.notify_one();
+    }
+
+    void push(std::initializer_list<T> items)
+    {
+        {
+            std::lock_guard lk{mtx_q_};
+            for (const auto& item : items)
+                q_.push(item);
+        }
+        cv_q_not_empty_.notify_all();
+    }
+
+    std::optional<T> pop()
+    {
+        std::unique_lock lk{mtx_q_};
+        cv_q_not_empty_.wait(lk, [this] { return !q_.empty() || closed_; });
+        if (q_.empty())
+            return std::nullopt;
+        T item = q_.front();
+        q_.pop();
+        return item;
+    }
+
+    void close()
+    {
+        {
+            std::lock_guard lk{mtx_q_};
+            closed_ = true;
+        }
+        cv_q_not_empty_.notify_all();
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// perf stat-style counters - software events of this process, including threads started after the counter
+
+class SoftwareCounter
+{
+    int fd_;
+
+public:
+    explicit SoftwareCounter(uint64_t event)
+    {
+        perf_event_attr attr{};
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_SOFTWARE;
+        attr.config = event;
+        attr.inherit = 1;
+        fd_ = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+
+    SoftwareCounter(const SoftwareCounter&) = delete;
+    SoftwareCounter& operator=(const SoftwareCounter&) = delete;
+
+    ~SoftwareCounter()
+    {
+        if (fd_ >= 0)
+            close(fd_);
+    }
+
+    bool valid() const
+    {
+        return fd_ >= 0;
+    }
+
+    // counts of threads are added when they exit - join them first
+    uint64_t value() const
+    {
+        uint64_t count = 0;
+        if (fd_ < 0 || read(fd_, &count, sizeof(count)) != sizeof(count))
+            return 0;
+        return count;
+    }
+};
+
+// without perf events (perf_event_paranoid, containers) - context switches of exited threads from getrusage
+uint64_t rusage_context_switches()
+{
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_nvcsw + usage.ru_nivcsw;
+}
+
+struct Result
+{
+    std::chrono::microseconds elapsed;
+    uint64_t context_switches;
+    uint64_t task_clock_ns; // cpu time of all threads
+};
+
+template <typename F>
+Result counted(F&& f)
+{
+    SoftwareCounter context_switches{PERF_COUNT_SW_CONTEXT_SWITCHES};
+    SoftwareCounter task_clock{PERF_COUNT_SW_TASK_CLOCK};
+    const uint64_t rusage_before = rusage_context_switches();
+
+    Result result;
+    result.elapsed = Benchmark::measure(std::forward<F>(f));
+    result.context_switches = context_switches.valid() ? context_switches.value() : rusage_context_switches() - rusage_before;
+    result.task_clock_ns = task_clock.value();
+    return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+constexpr size_t item_count = 400'000;
+constexpr int rounds = 3; // the fastest one is reported
+
+// producers push single items (batch == 1) or initializer_list batches of four; consumers pop until closed
+template <typename TQueue, typename... TArgs>
+Result run_once(size_t producer_count, size_t consumer_count, size_t batch, TArgs... queue_args)
+{
+    TQueue queue{queue_args...};
+    return counted([&] {
+        std::vector<std::jthread> consumers;
+        for (size_t c = 0; c < consumer_count; ++c)
+        {
+            consumers.emplace_back([&queue] {
+                uint64_t sum = 0;
+                while (auto item = queue.pop())
+                    sum += *item;
+                Benchmark::do_not_optimize(sum);
+            });
+        }
+
+        {
+            std::vector<std::jthread> producers;
+            for (size_t p = 0; p < producer_count; ++p)
+            {
+                producers.emplace_back([&queue, producer_count, batch] {
+                    for (uint64_t i = 0; i < item_count / producer_count; i += batch)
+                    {
+                        if (batch == 1)
+                            queue.push(i);
+                        else
+                            queue.push({i, i + 1, i + 2, i + 3});
+                    }
+                });
+            }
+        }
+        queue.close();
+    });
+}
+
+template <typename TQueue, typename... TArgs>
+Result run(size_t producer_count, size_t consumer_count, size_t batch, TArgs... queue_args)
+{
+    Result best = run_once<TQueue>(producer_count, consumer_count, batch, queue_args...);
+    for (int round = 1; round < rounds; ++round)
+    {
+        const Result result = run_once<TQueue>(producer_count, consumer_count, batch, queue_args...);
+        if (result.elapsed < best.elapsed)
+            best = result;
+    }
+    return best;
+}
+
+void print(std::string_view name, const Result& result)
+{
+    std::cout << "  " << std::left << std::setw(36) << name << std::right << std::setw(6) << result.elapsed.count() / 1000 << " ms"
+              << std::fixed << std::setprecision(3) << std::setw(10) << static_cast<double>(result.context_switches) / item_count
+              << " cs/item" << std::setprecision(0) << std::setw(9) << static_cast<double>(result.task_clock_ns) / item_count
+              << " cpu ns/item\n";
+}
+
+int main()
+{
+    std::cout << item_count / 1000 << "K items per scenario, best of " << rounds << "; cs - context switches (a consumer that went to sleep and was woken), "
+              << std::thread::hardware_concurrency() << " cpu(s)\n";
+    if (!SoftwareCounter{PERF_COUNT_SW_CONTEXT_SWITCHES}.valid())
+        std::cout << "(perf events not available - context switches from getrusage, no cpu time)\n";
+
+    struct Scenario
+    {
+        std::string_view name;
+        size_t producers;
+        size_t consumers;
+        size_t batch;
+    };
+
+    for (const auto& scenario : {Scenario{"1 producer, 1 consumer", 1, 1, 1}, Scenario{"4 producers, 4 consumers", 4, 4, 1},
+             Scenario{"1 producer, 8 consumers, push({...}) of 4", 1, 8, 4}})
+    {
+        std::cout << "\n" << scenario.name << "\n";
+        print("notify per push, notify_all per batch", run<AlwaysNotifyQueue<uint64_t>>(scenario.producers, scenario.consumers, scenario.batch));
+        print("waiter-aware, no spinning", run<ThreadSafeQueue<uint64_t>>(scenario.producers, scenario.consumers, scenario.batch, size_t{0}));
+        print("waiter-aware, spin 256", run<ThreadSafeQueue<uint64_t>>(scenario.producers, scenario.consumers, scenario.batch, size_t{256}));
+        print("waiter-aware, spin 4096", run<ThreadSafeQueue<uint64_t>>(scenario.producers, scenario.consumers, scenario.batch, size_t{4096}));
+    }
+}
@@ -0,0 +1,191 @@
+#include "benchmark.hpp"
+#include "rcu_cell.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <numeric>
+#include <shared_mutex>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// readers sum the current dataset while one writer keeps republishing it
+
+constexpr size_t element_count = 1000;
+constexpr auto run_duration = std::chrono::milliseconds{1000};
+
+std::vector<int> make_version(uint64_t number)
+{
+    return std::vector<int>(element_count, static_cast<int>(number));
+}
+
+// the event-synchronization Data: a mutex guards the vector, a condvar announces new versions
+class MutexData
+{
+    std::vector<int> data_ = make_version(0);
+    uint64_t version_ = 0;
+    std::mutex mtx_data_;
+    std::condition_variable cv_data_ready_;
+
+public:
+    void publish(uint64_t number)
+    {
+        auto data = make_version(number);
+        {
+            std::lock_guard lk{mtx_data_};
+            data_.swap(data);
+            version_ = number;
+        }
+        cv_data_ready_.notify_all();
+    }
+
+    // returns false when the version was torn
+    bool read(long& sum)
+    {
+        std::lock_guard lk{mtx_data_};
+        sum = std::accumulate(data_.begin(), data_.end(), 0L);
+        return sum == static_cast<long>(version_ * element_count);
+    }
+
+    size_t retired() const
+    {
+        return 0;
+    }
+};
+
+class SharedMutexData
+{
+    std::vector<int> data_ = make_version(0);
+    uint64_t version_ = 0;
+    std::shared_mutex mtx_data_;
+
+public:
+    void publish(uint64_t number)
+    {
+        auto data = make_version(number);
+        std::lock_guard lk{mtx_data_};
+        data_.swap(data);
+        version_ = number;
+    }
+
+    bool read(long& sum)
+    {
+        std::shared_lock lk{mtx_data_};
+        sum = std::accumulate(data_.begin(), data_.end(), 0L);
+        return sum == static_cast<long>(version_ * element_count);
+    }
+
+    size_t retired() const
+    {
+        return 0;
+    }
+};
+
+class RcuData
+{
+    Reclamation::EpochDomain domain_;
+    RcuCell<std::vector<int>> data_{make_version(0), domain_};
+
+public:
+    void publish(uint64_t number)
+    {
+        data_.publish(make_version(number));
+    }
+
+    bool read(long& sum)
+    {
+        auto snapshot = data_.read();
+        sum = std::accumulate(snapshot->begin(), snapshot->end(), 0L);
+        return sum == static_cast<long>((snapshot.version() - 1) * element_count);
+    }
+
+    size_t retired() const
+    {
+        return domain_.retired_count();
+    }
+};
+
+struct Result
+{
+    uint64_t reads = 0;
+    uint64_t publications = 0;
+    uint64_t torn = 0;
+    size_t peak_retired = 0;
+};
+
+template <typename TData>
+Result run(size_t reader_count)
+{
+    TData data;
+    Result result;
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> reads{0};
+    std::atomic<uint64_t> torn{0};
+
+    {
+        std::vector<std::jthread> readers;
+        for (size_t i = 0; i < reader_count; ++i)
+        {
+            readers.emplace_back([&] {
+                uint64_t local_reads = 0;
+                uint64_t local_torn = 0;
+                long sum = 0;
+                while (!stop.load(std::memory_order_relaxed))
+                {
+                    if (!data.read(sum))
+                        ++local_torn;
+                    Benchmark::do_not_optimize(sum);
+                    ++local_reads;
+                }
+                reads += local_reads;
+                torn += local_torn;
+            });
+        }
+
+        std::jthread writer{[&] {
+            while (!stop.load(std::memory_order_relaxed))
+            {
+                data.publish(++result.publications);
+                result.peak_retired = std::max(result.peak_retired, data.retired());
+            }
+        }};
+
+        std::this_thread::sleep_for(run_duration);
+        stop = true;
+    }
+
+    result.reads = reads;
+    result.torn = torn;
+    return result;
+}
+
+template <typename TData>
+void report(std::string_view name, size_t reader_count)
+{
+    const Result result = run<TData>(reader_count);
+    const double seconds = std::chrono::duration<double>(run_duration).count();
+
+    std::cout << name << " " << std::setw(2) << reader_count << " readers: " << std::fixed << std::setprecision(2) << std::setw(6)
+              << result.reads / seconds / 1e6 << "M reads/s, " << std::setw(6) << result.publications / seconds / 1e3
+              << "K publications/s, peak retired " << result.peak_retired;
+    if (result.torn != 0)
+        std::cout << " !!! " << result.torn << " torn reads";
+    std::cout << "\n";
+}
+
+int main()
+{
+    std::cout << "1 writer republishing a vector<int>(" << element_count << ") continuously, " << run_duration << " per run\n";
+
+    for (size_t reader_count : {1, 2, 4, 8})
+    {
+        report<MutexData>("mutex + condvar", reader_count);
+        report<SharedMutexData>("shared_mutex   ", reader_count);
+        report<RcuData>("RcuCell        ", reader_count);
+    }
+}
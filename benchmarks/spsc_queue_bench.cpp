@@ -0,0 +1,144 @@
+#include "benchmark.hpp"
+#include "pool_metrics.hpp"
+#include "spsc_queue.hpp"
+#include "thread_safe_queue.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string_view>
+#include <thread>
+
+// two-stage pipeline: one producer hands messages to one consumer
+
+struct Message
+{
+    uint64_t sequence = 0;
+    uint64_t sent_ns = 0;
+};
+
+constexpr size_t message_count = 5'000'000;
+constexpr size_t ring_capacity = 1024;
+constexpr size_t batch_size = 64;
+
+uint64_t now_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+struct Report
+{
+    std::chrono::microseconds elapsed;
+    PoolMetrics::HistogramSnapshot latency;
+    uint64_t checksum = 0;
+};
+
+void print(std::string_view name, const Report& report)
+{
+    std::cout << name << ": " << std::fixed << std::setprecision(1) << message_count / (report.elapsed.count() / 1e6) / 1e6
+              << "M msgs/s, latency p50 " << report.latency.percentile(50) << ", p99 " << report.latency.percentile(99)
+              << ", p99.9 " << report.latency.percentile(99.9);
+    if (report.checksum != message_count * (message_count - 1) / 2)
+        std::cout << " !!! lost messages";
+    std::cout << "\n";
+}
+
+// TProduce(queue, message), TConsume(queue, on_message) - returns false at the end of the stream
+template <typename TQueue, typename TProduce, typename TConsume>
+Report run(TQueue& queue, TProduce produce, TConsume consume)
+{
+    Report report;
+    PoolMetrics::LatencyHistogram latency;
+
+    report.elapsed = Benchmark::measure([&] {
+        std::jthread consumer{[&] {
+            size_t received = 0;
+            while (received < message_count)
+            {
+                consume(queue, [&](const Message& message) {
+                    latency.record(now_ns() - message.sent_ns);
+                    report.checksum += message.sequence;
+                    ++received;
+                });
+            }
+        }};
+
+        for (size_t i = 0; i < message_count; ++i)
+            produce(queue, Message{i, now_ns()});
+    });
+
+    report.latency.merge(latency);
+    return report;
+}
+
+// producer side of the batched variant - messages are stamped when the batch is committed
+class Batcher
+{
+    std::array<Message, batch_size> batch_;
+    size_t size_ = 0;
+
+public:
+    template <typename TQueue>
+    void add(TQueue& queue, const Message& message)
+    {
+        batch_[size_++] = message;
+        if (size_ == batch_size || message.sequence == message_count - 1)
+        {
+            const auto now = now_ns();
+            for (size_t i = 0; i < size_; ++i)
+                batch_[i].sent_ns = now;
+            queue.push_batch(batch_.begin(), batch_.begin() + size_);
+            size_ = 0;
+        }
+    }
+};
+
+int main()
+{
+    std::cout << "1 producer -> 1 consumer, " << message_count / 1'000'000 << "M messages, ring capacity " << ring_capacity << "\n";
+
+    {
+        ThreadSafeQueue<Message> queue;
+        print("ThreadSafeQueue            ",
+            run(queue, [](auto& q, const Message& m) { q.push(m); },
+                [](auto& q, auto on_message) { on_message(*q.pop()); }));
+    }
+
+    {
+        SpscQueue<Message> queue{ring_capacity};
+        print("SpscQueue (spin + yield)   ",
+            run(queue,
+                [](auto& q, const Message& m) {
+                    while (!q.try_push(m))
+                        std::this_thread::yield();
+                },
+                [](auto& q, auto on_message) {
+                    Message m;
+                    while (!q.try_pop(m))
+                        std::this_thread::yield();
+                    on_message(m);
+                }));
+    }
+
+    {
+        BlockingSpscQueue<Message> queue{ring_capacity};
+        print("BlockingSpscQueue          ",
+            run(queue, [](auto& q, const Message& m) { q.push(m); },
+                [](auto& q, auto on_message) { on_message(*q.pop()); }));
+    }
+
+    {
+        BlockingSpscQueue<Message> queue{ring_capacity};
+        Batcher batcher;
+        print("BlockingSpscQueue, batch 64",
+            run(queue, [&batcher](auto& q, const Message& m) { batcher.add(q, m); },
+                [](auto& q, auto on_message) {
+                    std::array<Message, batch_size> batch;
+                    const size_t count = q.pop_batch(batch.begin(), batch.size());
+                    for (size_t i = 0; i < count; ++i)
+                        on_message(batch[i]);
+                }));
+    }
+}
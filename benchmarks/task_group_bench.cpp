@@ -0,0 +1,109 @@
+#include "benchmark.hpp"
+#include "task_group.hpp"
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <array>
+#include <exception>
+#include <future>
+#include <iostream>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+constexpr size_t job_count = 10'000;
+constexpr int rounds = 5;
+
+int small_job(size_t id)
+{
+    std::array<int, 64> values{};
+    std::iota(values.begin(), values.end(), static_cast<int>(id));
+    return std::accumulate(values.begin(), values.end(), 0);
+}
+
+// the pattern from threads-exceptions before TaskGroup: one jthread per job,
+// default constructed result slot + exception_ptr, explicit join loop
+long jthread_per_job()
+{
+    struct Result
+    {
+        int value{};
+        std::exception_ptr exception;
+    };
+
+    std::vector<Result> results(job_count);
+    std::vector<std::jthread> threads(job_count);
+
+    for (size_t i = 0; i < job_count; ++i)
+    {
+        threads[i] = std::jthread{[i, &results] {
+            try
+            {
+                results[i].value = small_job(i);
+            }
+            catch (...)
+            {
+                results[i].exception = std::current_exception();
+            }
+        }};
+    }
+
+    for (auto& thd : threads)
+        thd.join();
+
+    long sum = 0;
+    for (auto& r : results)
+    {
+        if (r.exception)
+            std::rethrow_exception(r.exception);
+        sum += r.value;
+    }
+    return sum;
+}
+
+long task_group(ThreadPool& pool)
+{
+    TaskGroup group{pool};
+
+    std::vector<std::future<int>> results;
+    results.reserve(job_count);
+
+    for (size_t i = 0; i < job_count; ++i)
+        results.push_back(group.run([i] { return small_job(i); }));
+
+    group.wait();
+
+    long sum = 0;
+    for (auto& r : results)
+        sum += r.get();
+    return sum;
+}
+
+int main()
+{
+    const size_t no_of_cores = std::max(1u, std::thread::hardware_concurrency());
+    ThreadPool pool(no_of_cores);
+
+    std::cout << "Fan-out/fan-in of " << job_count << " small jobs; best of " << rounds << " rounds\n";
+
+    auto best_threads = std::chrono::microseconds::max();
+    auto best_group = std::chrono::microseconds::max();
+    long sum_threads = 0, sum_group = 0;
+
+    for (int round = 0; round < rounds; ++round)
+    {
+        best_threads = std::min(best_threads, Benchmark::measure([&] { sum_threads = jthread_per_job(); }));
+        best_group = std::min(best_group, Benchmark::measure([&] { sum_group = task_group(pool); }));
+    }
+
+    if (sum_threads != sum_group)
+        std::cout << "!!! results differ\n";
+
+    auto report = [](std::string_view name, std::chrono::microseconds elapsed) {
+        std::cout << name << ": " << elapsed.count() << "us (" << elapsed.count() * 1000.0 / job_count << "ns per job)\n";
+    };
+
+    report("jthread per job     ", best_threads);
+    report("TaskGroup on a pool ", best_group);
+    std::cout << "Speedup: " << static_cast<double>(best_threads.count()) / best_group.count() << "x\n";
+}
@@ -0,0 +1,109 @@
+#include "benchmark.hpp"
+#include "thread_safe_queue.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+
+constexpr int rounds = 3;
+
+// the exercise queue before the headers were unified - copies items in and out
+template <typename T>
+class CopyingQueue
+{
+    std::queue<T> q_;
+    std::mutex mtx_q_;
+    std::condition_variable cv_q_not_empty_;
+
+public:
+    void push(const T& item)
+    {
+        {
+            std::lock_guard lk{mtx_q_};
+            q_.push(item);
+        }
+        cv_q_not_empty_.notify_one();
+    }
+
+    void pop(T& item)
+    {
+        std::unique_lock lk{mtx_q_};
+        cv_q_not_empty_.wait(lk, [this] { return !q_.empty(); });
+        item = q_.front();
+        q_.pop();
+    }
+};
+
+template <typename F>
+std::chrono::microseconds best_of(F f)
+{
+    auto best = std::chrono::microseconds::max();
+    for (int round = 0; round < rounds; ++round)
+        best = std::min(best, Benchmark::measure(f));
+    return best;
+}
+
+// one producer, one consumer
+template <typename TQueue, typename TMake>
+std::chrono::microseconds transfer(size_t count, TMake make_item)
+{
+    return best_of([&] {
+        TQueue queue;
+        using T = decltype(make_item(size_t{}));
+
+        std::jthread consumer{[&] {
+            T item{};
+            size_t checksum = 0;
+            for (size_t i = 0; i < count; ++i)
+            {
+                queue.pop(item);
+                checksum += sizeof(item);
+            }
+            Benchmark::do_not_optimize(checksum);
+        }};
+
+        for (size_t i = 0; i < count; ++i)
+            queue.push(make_item(i)); // the copying queue binds the temporary to const T&
+    });
+}
+
+template <typename TMake>
+void compare(std::string_view payload, size_t count, TMake make_item)
+{
+    using T = decltype(make_item(size_t{}));
+
+    std::cout << payload << " x " << count / 1000 << "K:";
+    if constexpr (std::is_copy_constructible_v<T>)
+        std::cout << " copying " << transfer<CopyingQueue<T>>(count, make_item) << ",";
+    std::cout << " ThreadSafeQueue " << transfer<ThreadSafeQueue<T>>(count, make_item) << ", ChunkedThreadSafeQueue "
+              << transfer<ChunkedThreadSafeQueue<T>>(count, make_item) << "\n";
+}
+
+int main()
+{
+    std::cout << "ThreadSafeQueue - 1 producer / 1 consumer (best of " << rounds << " rounds)\n";
+
+    compare("int", 2'000'000, [](size_t i) { return static_cast<int>(i); });
+
+    compare("std::unique_ptr<int> (move-only)", 1'000'000, [](size_t i) { return std::make_unique<int>(static_cast<int>(i)); });
+
+    // heap payload: copy = allocation + memcpy, move = three pointers
+    compare("std::string(256)", 1'000'000, [](size_t i) { return std::string(256, static_cast<char>('a' + i % 26)); });
+
+    // inline payload: copy == move, only the storage differs
+    compare("std::array<std::byte, 1024>", 500'000, [](size_t i) {
+        std::array<std::byte, 1024> item{};
+        item[0] = static_cast<std::byte>(i);
+        return item;
+    });
+}
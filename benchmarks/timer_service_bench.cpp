@@ -0,0 +1,104 @@
+#include "benchmark.hpp"
+#include "thread_pool.hpp"
+#include "timer_service.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <stop_token>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+using namespace std::literals;
+
+constexpr size_t sleeper_count = 64;
+constexpr size_t timer_count = 10'000;
+constexpr auto delay = 50ms;
+
+// the pattern from threads.cpp before TimerService: stop is checked between plain sleeps
+void polling_sleeper(std::stop_token stop_tkn)
+{
+    while (!stop_tkn.stop_requested())
+        std::this_thread::sleep_for(delay);
+}
+
+void timer_sleeper(TimerService& timers, std::stop_token stop_tkn)
+{
+    while (timers.sleep_for(stop_tkn, delay))
+        ;
+}
+
+// time from request_stop() until each sleeper has noticed it
+template <typename TSleeper>
+std::vector<std::chrono::microseconds> cancellation_latencies(TSleeper sleeper)
+{
+    std::stop_source stop_src;
+    std::vector<Benchmark::Clock::time_point> finished(sleeper_count);
+    std::vector<std::jthread> threads;
+
+    for (size_t i = 0; i < sleeper_count; ++i)
+    {
+        threads.emplace_back([&, i] {
+            sleeper(stop_src.get_token());
+            finished[i] = Benchmark::Clock::now();
+        });
+    }
+
+    std::this_thread::sleep_for(3 * delay + 7ms); // stop in the middle of a sleep
+    const auto stop_requested = Benchmark::Clock::now();
+    stop_src.request_stop();
+
+    for (auto& thd : threads)
+        thd.join();
+
+    std::vector<std::chrono::microseconds> latencies;
+    for (auto tp : finished)
+        latencies.push_back(std::chrono::duration_cast<std::chrono::microseconds>(tp - stop_requested));
+    std::ranges::sort(latencies);
+
+    return latencies;
+}
+
+void report(std::string_view name, const std::vector<std::chrono::microseconds>& latencies)
+{
+    auto at = [&](double p) { return latencies[static_cast<size_t>(p / 100.0 * (latencies.size() - 1))]; };
+    std::cout << name << ": p50=" << at(50) << " p99=" << at(99) << " max=" << latencies.back() << "\n";
+}
+
+int main()
+{
+    TimerService timers;
+
+    std::cout << "Cancellation latency of " << sleeper_count << " sleeping threads (delay " << delay << ")\n";
+    report("sleep_for + stop_requested() ", cancellation_latencies(polling_sleeper));
+    report("TimerService::sleep_for      ", cancellation_latencies([&](std::stop_token stop_tkn) { timer_sleeper(timers, stop_tkn); }));
+
+    // many delayed jobs, one timer thread - half of them cancelled before they are due
+    ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()));
+    std::atomic<size_t> executed{0};
+    std::vector<TimerService::TimerId> ids;
+    ids.reserve(timer_count);
+
+    std::cout << "\n" << timer_count << " delayed jobs on one timer thread\n";
+
+    Benchmark::report("schedule", [&] {
+        const auto now = TimerService::Clock::now();
+        for (size_t i = 0; i < timer_count; ++i)
+            ids.push_back(timers.schedule_on(pool, now + 10ms + (i % 500) * 1ms, [&executed] { ++executed; }));
+    });
+
+    size_t cancelled = 0;
+    const auto cancel_time = Benchmark::measure([&] {
+        for (size_t i = 0; i < ids.size(); i += 2)
+            cancelled += timers.cancel(ids[i]);
+    });
+    std::cout << "cancel: " << cancel_time.count() * 1000.0 / cancelled << "ns per timer\n";
+
+    while (timers.pending_count() > 0)
+        std::this_thread::sleep_for(10ms);
+    std::this_thread::sleep_for(10ms); // last jobs handed over to the pool
+
+    std::cout << "executed=" << executed << " cancelled=" << cancelled << "\n";
+}
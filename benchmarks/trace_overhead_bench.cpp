@@ -0,0 +1,89 @@
+#include "benchmark.hpp"
+#include "thread_pool.hpp"
+#include "trace_recorder.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+constexpr size_t event_count = 10'000'000;
+constexpr size_t task_count = 500'000;
+constexpr int rounds = 5;
+
+// ns per recorded event (a Scope records two)
+double scope_cost()
+{
+    auto best = std::chrono::microseconds::max();
+    for (int round = 0; round < rounds; ++round)
+    {
+        best = std::min(best, Benchmark::measure([] {
+            for (size_t i = 0; i < event_count / 2; ++i)
+            {
+                Trace::Scope trace{"event"};
+                Benchmark::do_not_optimize(i);
+            }
+        }));
+    }
+    return best.count() * 1000.0 / event_count;
+}
+
+// traced lock acquisition as in SynchronizedValue - uncontended
+double lock_cost(std::mutex& mtx)
+{
+    auto best = std::chrono::microseconds::max();
+    for (int round = 0; round < rounds; ++round)
+    {
+        best = std::min(best, Benchmark::measure([&] {
+            for (size_t i = 0; i < event_count / 2; ++i)
+            {
+                std::unique_lock lk{mtx, std::defer_lock};
+                {
+                    Trace::Scope trace{"lock acquisition"};
+                    lk.lock();
+                }
+                Benchmark::do_not_optimize(i);
+            }
+        }));
+    }
+    return best.count() * 1000.0 / (event_count / 2);
+}
+
+std::chrono::microseconds pool_tasks(ThreadPool& pool)
+{
+    std::vector<std::future<void>> results;
+    results.reserve(task_count);
+
+    return Benchmark::measure([&] {
+        for (size_t i = 0; i < task_count; ++i)
+            results.push_back(pool.submit([i] { Benchmark::do_not_optimize(i); }));
+        for (auto& r : results)
+            r.get();
+    });
+}
+
+int main()
+{
+    std::mutex mtx;
+    ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()));
+
+    const double disabled_event = scope_cost();
+    const double disabled_lock = lock_cost(mtx);
+    const auto disabled_pool = pool_tasks(pool);
+
+    Trace::Recorder::instance().enable();
+    const double enabled_event = scope_cost();
+    const double enabled_lock = lock_cost(mtx);
+    const auto enabled_pool = pool_tasks(pool);
+    Trace::Recorder::instance().disable();
+
+    std::cout << "Trace event cost (best of " << rounds << " rounds)\n";
+    std::cout << "event:                     disabled " << disabled_event << "ns, enabled " << enabled_event << "ns\n";
+    std::cout << "lock acquisition (2 events): disabled " << disabled_lock << "ns, enabled " << enabled_lock << "ns\n";
+    // queue wait + task scopes; on an oversubscribed machine this also includes extra context switches
+    std::cout << task_count << " pool tasks (4 events each): disabled " << disabled_pool << ", enabled " << enabled_pool
+              << " (+" << (enabled_pool - disabled_pool).count() * 1000.0 / task_count << "ns per task)\n";
+}
@@ -0,0 +1,155 @@
+#include "benchmark.hpp"
+#include "worker_team.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// 1D three-point stencil (Jacobi relaxation with fixed ends) - every iteration needs the previous one finished,
+// and the largest change of a cell is reduced over all threads after each of them
+
+constexpr size_t iteration_count = 10'000;
+
+struct Result
+{
+    std::chrono::microseconds elapsed;
+    double checksum; // both versions must compute the same cells
+};
+
+std::vector<double> initial_cells(size_t cell_count)
+{
+    std::vector<double> cells(cell_count, 0.0);
+    cells.front() = 100.0;
+    cells.back() = -100.0;
+    return cells;
+}
+
+// cells [first, last) of next from current - the largest change
+double relax(const std::vector<double>& current, std::vector<double>& next, size_t first, size_t last)
+{
+    first = std::max<size_t>(first, 1);
+    last = std::min(last, current.size() - 1);
+
+    double delta = 0.0;
+    for (size_t i = first; i < last; ++i)
+    {
+        next[i] = 0.25 * current[i - 1] + 0.5 * current[i] + 0.25 * current[i + 1];
+        delta = std::max(delta, std::abs(next[i] - current[i]));
+    }
+    return delta;
+}
+
+std::pair<size_t, size_t> share_of(size_t index, size_t thread_count, size_t count)
+{
+    const size_t share = count / thread_count;
+    const size_t rest = count % thread_count;
+    const size_t first = index * share + std::min(index, rest);
+    return {first, first + share + (index < rest ? 1 : 0)};
+}
+
+double checksum(const std::vector<double>& cells, double delta)
+{
+    double sum = delta;
+    for (double cell : cells)
+        sum += cell;
+    return sum;
+}
+
+// multi_thread_pi style - threads are spawned for every iteration and joined to synchronize
+Result run_respawning(size_t thread_count, size_t cell_count)
+{
+    std::vector<double> current = initial_cells(cell_count);
+    std::vector<double> next = current;
+    double delta = 0.0;
+
+    Result result;
+    result.elapsed = Benchmark::measure([&] {
+        struct alignas(cache_line_size) Partial
+        {
+            double delta;
+        };
+        std::vector<Partial> partials(thread_count);
+
+        for (size_t iteration = 0; iteration < iteration_count; ++iteration)
+        {
+            {
+                std::vector<std::jthread> threads;
+                threads.reserve(thread_count);
+                for (size_t t = 0; t < thread_count; ++t)
+                {
+                    threads.emplace_back([&, t] {
+                        const auto [first, last] = share_of(t, thread_count, cell_count);
+                        partials[t].delta = relax(current, next, first, last);
+                    });
+                }
+            }
+
+            delta = 0.0;
+            for (const auto& partial : partials)
+                delta = std::max(delta, partial.delta);
+            std::swap(current, next);
+        }
+    });
+    result.checksum = checksum(current, delta);
+    return result;
+}
+
+Result run_team(WorkerTeam& team, size_t cell_count)
+{
+    std::vector<double> current = initial_cells(cell_count);
+    std::vector<double> next = current;
+    double delta = 0.0;
+
+    Result result;
+    result.elapsed = Benchmark::measure([&] {
+        team.run([&](WorkerTeam::Member& member) {
+            const auto [first, last] = member.range(cell_count);
+            for (size_t iteration = 0; iteration < iteration_count; ++iteration)
+            {
+                const double local_delta = relax(current, next, first, last);
+                const double max_delta = member.reduce(local_delta, [](double a, double b) { return std::max(a, b); });
+                member.single([&] {
+                    delta = max_delta;
+                    std::swap(current, next);
+                });
+            }
+        });
+    });
+    result.checksum = checksum(current, delta);
+    return result;
+}
+
+int main(int argc, char* argv[])
+{
+    const size_t max_threads = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 8;
+
+    std::cout << iteration_count / 1000 << "K iterations of a 3-point stencil, max |change| reduced every iteration\n";
+    for (size_t cell_count : {1'024, 65'536})
+    {
+        std::cout << "\n" << cell_count << " cells\n";
+        std::cout << "threads  respawned jthreads [ms]  WorkerTeam [ms]  speedup  us/iteration (team)\n";
+        for (size_t thread_count = 1; thread_count <= max_threads; thread_count *= 2)
+        {
+            const Result respawning = run_respawning(thread_count, cell_count);
+            WorkerTeam team{thread_count}; // started outside of the measurement, like a pool
+            const Result persistent = run_team(team, cell_count);
+
+            if (respawning.checksum != persistent.checksum)
+            {
+                std::cerr << "Results differ: " << respawning.checksum << " vs " << persistent.checksum << "\n";
+                return 1;
+            }
+
+            std::cout << std::setw(7) << thread_count << std::setw(25) << respawning.elapsed.count() / 1000 << std::setw(17)
+                      << persistent.elapsed.count() / 1000 << std::fixed << std::setprecision(1) << std::setw(8)
+                      << static_cast<double>(respawning.elapsed.count()) / persistent.elapsed.count() << "x" << std::setw(21)
+                      << static_cast<double>(persistent.elapsed.count()) / iteration_count << "\n";
+        }
+    }
+}
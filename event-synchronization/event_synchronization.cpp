@@ -1,9 +1,16 @@
+#include "parallel_algorithms.hpp"
+#include "pipeline.hpp"
+#include "rcu_cell.hpp"
+#include "spsc_queue.hpp"
+#include "thread_pool.hpp"
+
 #include <cassert>
 #include <chrono>
 #include <condition_variable>
 #include <functional>
 #include <iostream>
 #include <numeric>
+#include <optional>
 #include <random>
 #include <string>
 #include <syncstream>
@@ -118,7 +125,7 @@ public:
         is_ready_.store(true, std::memory_order_release);
     }
 
-    void process(int id)
+    void process(int id, ThreadPool& pool)
     {
         while (!is_ready_.load(std::memory_order_acquire))
         /////////////////////////////////////////////////////////
@@ -126,11 +133,109 @@ public:
             // std::this_thread::yield();
         }
 
-        long sum = std::accumulate(begin(data_), end(data_), 0L);
+        long sum = parallel::reduce(pool, begin(data_), end(data_), 0L);
         std::osyncstream(std::cout) << "Id: " << id << "; Sum: " << sum << std::endl;
     }
 };
 
+// periodically refreshed dataset - readers pin the current version without locks while new ones get published
+namespace RcuPublication
+{
+    class Data
+    {
+        RcuCell<std::vector<int>> data_;
+
+    public:
+        void read(uint64_t version_count, std::chrono::milliseconds period)
+        {
+            std::random_device rnd;
+            for (uint64_t i = 0; i < version_count; ++i)
+            {
+                std::vector<int> data(100); // built off to the side...
+                std::generate(begin(data), end(data), [&rnd] { return rnd() % 1000; });
+                data_.publish(std::move(data)); // ...and swapped in atomically
+                std::this_thread::sleep_for(period);
+            }
+        }
+
+        void process(int id, uint64_t version_count)
+        {
+            for (uint64_t seen = 0; seen < version_count;)
+            {
+                seen = data_.wait_for_update(seen);
+
+                auto snapshot = data_.read(); // may be newer than seen - intermediate versions are skipped
+                long sum = std::accumulate(snapshot->begin(), snapshot->end(), 0L);
+                seen = snapshot.version();
+                std::osyncstream(std::cout) << "Id: " << id << "; Version: " << seen << "; Sum: " << sum << std::endl;
+            }
+        }
+    };
+} // namespace RcuPublication
+
+// strict one-to-one handoff - the reader streams batches to a single consumer through a wait-free ring
+namespace SpscHandoff
+{
+    class Data
+    {
+        BlockingSpscQueue<std::vector<int>> batches_{8};
+
+    public:
+        void read(int batch_count)
+        {
+            std::random_device rnd;
+            for (int i = 0; i < batch_count; ++i)
+            {
+                std::vector<int> batch(100);
+                std::generate(begin(batch), end(batch), [&rnd] { return rnd() % 1000; });
+                batches_.push(std::move(batch));
+            }
+            batches_.close();
+        }
+
+        void process()
+        {
+            long sum = 0;
+            int batch_count = 0;
+            while (auto batch = batches_.pop())
+            {
+                sum += std::accumulate(begin(*batch), end(*batch), 0L);
+                ++batch_count;
+            }
+            std::osyncstream(std::cout) << "Batches: " << batch_count << "; Sum: " << sum << std::endl;
+        }
+    };
+} // namespace SpscHandoff
+
+// continuous ingest -> transform -> aggregate instead of a one-shot read/notify/sum
+namespace Streaming
+{
+    void process_readings(int reading_count)
+    {
+        ThreadPool pool(5); // a worker per stage, two for calibrate
+        std::mt19937 rnd{42};
+        int produced = 0;
+        long sum = 0;
+        int accepted = 0;
+
+        const auto report = Pipeline::source({.name = "read", .batch_size = 100},
+                                [&]() -> std::optional<int> {
+                                    if (produced++ == reading_count)
+                                        return std::nullopt;
+                                    return static_cast<int>(rnd() % 1000);
+                                })
+                                .map({.name = "calibrate", .parallelism = 2}, [](int raw) { return raw * 2 - 50; })
+                                .filter({.name = "in range"}, [](int value) { return value >= 0; })
+                                .sink({.name = "sum"}, [&](int value) {
+                                    sum += value;
+                                    ++accepted;
+                                })
+                                .run(pool);
+
+        std::osyncstream(std::cout) << "Readings: " << accepted << "/" << reading_count << "; Sum: " << sum << "\n" << report;
+    }
+} // namespace Streaming
+
 namespace Atomics
 {
     class SpinLockMutex
@@ -158,18 +263,34 @@ int main()
 {
     std::osyncstream(std::cout) << "Start of main..." << std::endl;
     {
+        ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()));
         Data data;
 
         std::jthread thd_producer{[&data] { data.read(); }};
 
         std::stop_source stop_src;
 
-        std::jthread thd_consumer_1{[&] { data.process(1); }};
-        std::jthread thd_consumer_2{[&] { data.process(2); }};
+        std::jthread thd_consumer_1{[&] { data.process(1, pool); }};
+        std::jthread thd_consumer_2{[&] { data.process(2, pool); }};
 
         std::this_thread::sleep_for(3s);
         stop_src.request_stop();
     }
 
+    {
+        SpscHandoff::Data data;
+        std::jthread thd_producer{[&data] { data.read(1000); }};
+        std::jthread thd_consumer{[&data] { data.process(); }};
+    }
+
+    {
+        RcuPublication::Data data;
+        std::jthread thd_producer{[&data] { data.read(5, 100ms); }};
+        std::jthread thd_consumer_1{[&data] { data.process(1, 5); }};
+        std::jthread thd_consumer_2{[&data] { data.process(2, 5); }};
+    }
+
+    Streaming::process_readings(100'000);
+
     std::osyncstream(std::cout) << "END of main..." << std::endl;
 }
@@ -1,3 +1,5 @@
+#include "console_sink.hpp"
+
 #include <cassert>
 #include <chrono>
 #include <functional>
@@ -7,13 +9,13 @@
 #include <string>
 #include <thread>
 #include <vector>
-#include <syncstream>
 
 using namespace std::literals;
 
-std::osyncstream sync_cout()
+// lines from many threads without a global lock - formatted per thread, written by the sink's writer thread
+ConsoleSink::Line sync_cout()
 {
-    return std::osyncstream{std::cout};
+    return ConsoleSink::console().line();
 }
 
 
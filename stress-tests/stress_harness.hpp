@@ -0,0 +1,254 @@
+#ifndef STRESS_HARNESS_HPP
+#define STRESS_HARNESS_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+// N producers / M consumers hammering a queue or a pool. Every item carries (producer, sequence number),
+// so the harness can tell lost, duplicated and - for FIFO queues - reordered items apart.
+// Randomized yields between operations shake up interleavings; a run is reproducible up to
+// the OS scheduler through the seed.
+namespace Stress
+{
+    struct Config
+    {
+        size_t producers = 4;
+        size_t consumers = 4;
+        size_t items_per_producer = 250'000;
+        unsigned yield_per_mille = 0; // probability of a yield after each operation
+        uint64_t seed = 42;
+    };
+
+    struct Result
+    {
+        std::string name;
+        uint64_t expected = 0;
+        uint64_t received = 0;
+        uint64_t lost = 0;
+        uint64_t duplicated = 0;
+        uint64_t reordered = 0; // per producer, as seen by a single consumer
+        std::chrono::microseconds elapsed{0};
+
+        bool passed() const
+        {
+            return lost == 0 && duplicated == 0 && reordered == 0 && received == expected;
+        }
+
+        double ops_per_second() const
+        {
+            return elapsed.count() ? received * 1e6 / elapsed.count() : 0.0;
+        }
+    };
+
+    inline std::ostream& operator<<(std::ostream& out, const Result& r)
+    {
+        out << (r.passed() ? "[  OK  ] " : "[FAILED] ") << r.name << ": " << r.received << "/" << r.expected << " items, "
+            << r.ops_per_second() / 1e6 << "M ops/s";
+        if (!r.passed())
+            out << " - lost=" << r.lost << " duplicated=" << r.duplicated << " reordered=" << r.reordered;
+        return out;
+    }
+
+    // item: producer id in the upper 24 bits, sequence number in the lower 40
+    constexpr int sequence_bits = 40;
+    constexpr uint64_t end_of_stream = std::numeric_limits<uint64_t>::max();
+
+    constexpr uint64_t make_item(uint64_t producer, uint64_t sequence)
+    {
+        return (producer << sequence_bits) | sequence;
+    }
+
+    constexpr uint64_t producer_of(uint64_t item)
+    {
+        return item >> sequence_bits;
+    }
+
+    constexpr uint64_t sequence_of(uint64_t item)
+    {
+        return item & ((uint64_t{1} << sequence_bits) - 1);
+    }
+
+    // xorshift - cheap enough not to dominate the measured operations
+    class YieldInjector
+    {
+        uint64_t state_;
+        const uint64_t threshold_;
+
+    public:
+        YieldInjector(uint64_t seed, unsigned yield_per_mille)
+            : state_{seed | 1}
+            , threshold_{std::numeric_limits<uint64_t>::max() / 1000 * yield_per_mille}
+        {
+        }
+
+        void operator()()
+        {
+            if (threshold_ == 0)
+                return;
+
+            state_ ^= state_ << 13;
+            state_ ^= state_ >> 7;
+            state_ ^= state_ << 17;
+            if (state_ < threshold_)
+                std::this_thread::yield();
+        }
+    };
+
+    // marks every (producer, sequence) once - any second mark is a duplicate
+    class Ledger
+    {
+        const Config config_;
+        std::unique_ptr<std::atomic<uint8_t>[]> seen_;
+        std::atomic<uint64_t> received_{0};
+        std::atomic<uint64_t> duplicated_{0};
+        std::atomic<uint64_t> reordered_{0};
+
+    public:
+        explicit Ledger(const Config& config)
+            : config_{config}
+            , seen_{new std::atomic<uint8_t>[config.producers * config.items_per_producer]{}}
+        {
+        }
+
+        void record(uint64_t item)
+        {
+            const uint64_t index = producer_of(item) * config_.items_per_producer + sequence_of(item);
+            if (seen_[index].exchange(1, std::memory_order_relaxed) != 0)
+                duplicated_.fetch_add(1, std::memory_order_relaxed);
+            received_.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        void add_reordered(uint64_t count)
+        {
+            reordered_.fetch_add(count, std::memory_order_relaxed);
+        }
+
+        uint64_t received() const
+        {
+            return received_.load(std::memory_order_acquire);
+        }
+
+        Result result(std::string name, std::chrono::microseconds elapsed) const
+        {
+            Result r;
+            r.name = std::move(name);
+            r.expected = config_.producers * config_.items_per_producer;
+            r.received = received_.load();
+            r.duplicated = duplicated_.load();
+            r.reordered = reordered_.load();
+            r.elapsed = elapsed;
+            for (uint64_t i = 0; i < r.expected; ++i)
+                r.lost += seen_[i].load(std::memory_order_relaxed) == 0;
+            return r;
+        }
+    };
+
+    // TQueue: push(uint64_t) and pop(uint64_t&) blocking until an item is available
+    template <typename TQueue>
+    Result run_queue(std::string name, const Config& config, bool fifo = true)
+    {
+        TQueue queue;
+        Ledger ledger{config};
+
+        const auto start = std::chrono::steady_clock::now();
+        {
+            std::vector<std::jthread> consumers;
+            for (size_t c = 0; c < config.consumers; ++c)
+            {
+                consumers.emplace_back([&, c] {
+                    YieldInjector maybe_yield{config.seed * 7919 + c, config.yield_per_mille};
+                    std::vector<int64_t> last_sequence(config.producers, -1);
+                    uint64_t reordered = 0;
+
+                    for (uint64_t item{};;)
+                    {
+                        queue.pop(item);
+                        if (item == end_of_stream)
+                            break;
+
+                        ledger.record(item);
+
+                        auto& last = last_sequence[producer_of(item)];
+                        const auto sequence = static_cast<int64_t>(sequence_of(item));
+                        reordered += fifo && sequence <= last;
+                        last = sequence;
+
+                        maybe_yield();
+                    }
+
+                    ledger.add_reordered(reordered);
+                });
+            }
+
+            {
+                std::vector<std::jthread> producers;
+                for (size_t p = 0; p < config.producers; ++p)
+                {
+                    producers.emplace_back([&, p] {
+                        YieldInjector maybe_yield{config.seed * 104729 + p, config.yield_per_mille};
+                        for (uint64_t s = 0; s < config.items_per_producer; ++s)
+                        {
+                            queue.push(make_item(p, s));
+                            maybe_yield();
+                        }
+                    });
+                }
+            }
+
+            for (size_t c = 0; c < config.consumers; ++c)
+                queue.push(end_of_stream);
+        }
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+
+        return ledger.result(std::move(name), std::chrono::duration_cast<std::chrono::microseconds>(elapsed));
+    }
+
+    // TPool: constructible from a thread count, submit(callable); consumers are the pool's workers.
+    // Pools give no ordering guarantee - only loss and duplication are checked.
+    template <typename TPool, typename... TPoolArgs>
+    Result run_pool(std::string name, const Config& config, TPoolArgs&&... pool_args)
+    {
+        Ledger ledger{config};
+        const uint64_t expected = config.producers * config.items_per_producer;
+        std::chrono::steady_clock::duration elapsed{};
+
+        {
+            TPool pool(config.consumers, std::forward<TPoolArgs>(pool_args)...);
+            const auto start = std::chrono::steady_clock::now();
+
+            {
+                std::vector<std::jthread> producers;
+                for (size_t p = 0; p < config.producers; ++p)
+                {
+                    producers.emplace_back([&, p] {
+                        YieldInjector maybe_yield{config.seed * 104729 + p, config.yield_per_mille};
+                        for (uint64_t s = 0; s < config.items_per_producer; ++s)
+                        {
+                            pool.submit([&ledger, item = make_item(p, s)] { ledger.record(item); });
+                            maybe_yield();
+                        }
+                    });
+                }
+            }
+
+            // lost tasks would never arrive - give up after a generous timeout
+            const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{60};
+            while (ledger.received() < expected && std::chrono::steady_clock::now() < deadline)
+                std::this_thread::sleep_for(std::chrono::microseconds{100});
+
+            elapsed = std::chrono::steady_clock::now() - start;
+        }
+
+        return ledger.result(std::move(name), std::chrono::duration_cast<std::chrono::microseconds>(elapsed));
+    }
+} // namespace Stress
+
+#endif // STRESS_HARNESS_HPP
@@ -0,0 +1,141 @@
+#include "stress_harness.hpp"
+
+#include "elastic_thread_pool.hpp"
+#include "numa_thread_pool.hpp"
+#include "pipeline.hpp"
+#include "profiled_mutex.hpp"
+#include "spin_lock.hpp"
+#include "thread_pool.hpp"
+#include "thread_safe_queue.hpp"
+
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+// stress_tests [scale] - scale multiplies the number of items (default 1: ~2M queue ops, ~0.5M pool tasks per scenario)
+
+struct ElasticPool : ElasticThreadPool
+{
+    explicit ElasticPool(size_t thread_count)
+        : ElasticThreadPool{{.min_threads = thread_count, .max_threads = 2 * thread_count}}
+    {
+    }
+};
+
+struct Scenario
+{
+    size_t producers;
+    size_t consumers;
+    unsigned yield_per_mille;
+};
+
+constexpr Scenario scenarios[] = {
+    {1, 1, 0},
+    {4, 4, 0},
+    {8, 2, 0},
+    {2, 8, 0},
+    {4, 4, 50}, // randomized yields - different interleavings on every run
+};
+
+Stress::Config make_config(const Scenario& scenario, size_t total_items)
+{
+    return Stress::Config{
+        .producers = scenario.producers,
+        .consumers = scenario.consumers,
+        .items_per_producer = total_items / scenario.producers,
+        .yield_per_mille = scenario.yield_per_mille};
+}
+
+std::string describe(const std::string& name, const Scenario& scenario)
+{
+    return name + " " + std::to_string(scenario.producers) + "P/" + std::to_string(scenario.consumers) + "C"
+        + (scenario.yield_per_mille ? " +yield" : "");
+}
+
+// source -> map (consumers workers) -> sink; with Order::preserved the sink must see the source's order
+Stress::Result run_pipeline(std::string name, const Scenario& scenario, size_t total_items, Pipeline::Order order)
+{
+    const Stress::Config config{.producers = 1, .consumers = scenario.consumers, .items_per_producer = total_items};
+    Stress::Ledger ledger{config};
+    uint64_t next = 0;
+    int64_t last_sequence = -1;
+    uint64_t reordered = 0;
+
+    ThreadPool pool(config.consumers + 2);
+    const auto report = Pipeline::source({.name = "source", .batch_size = 64},
+                            [&]() -> std::optional<uint64_t> {
+                                if (next == config.items_per_producer)
+                                    return std::nullopt;
+                                return Stress::make_item(0, next++);
+                            })
+                            .map({.name = "map", .parallelism = config.consumers, .order = order, .queue_capacity = 4},
+                                [](uint64_t item) { return item; })
+                            .sink({.name = "sink", .order = order}, [&](uint64_t item) {
+                                ledger.record(item);
+                                const auto sequence = static_cast<int64_t>(Stress::sequence_of(item));
+                                reordered += order == Pipeline::Order::preserved && sequence <= last_sequence;
+                                last_sequence = sequence;
+                            })
+                            .run(pool);
+
+    ledger.add_reordered(reordered);
+    return ledger.result(std::move(name), std::chrono::duration_cast<std::chrono::microseconds>(report.elapsed));
+}
+
+int main(int argc, char* argv[])
+{
+    const double scale = argc > 1 ? std::atof(argv[1]) : 1.0;
+    const auto queue_items = static_cast<size_t>(2'000'000 * scale);
+    const auto pool_items = static_cast<size_t>(500'000 * scale);
+
+    std::vector<Stress::Result> results;
+    auto run = [&results](Stress::Result result) {
+        std::cout << result << std::endl;
+        results.push_back(std::move(result));
+    };
+
+    for (const auto& scenario : scenarios)
+    {
+        const auto config = make_config(scenario, queue_items);
+
+        run(Stress::run_queue<ThreadSafeQueue<uint64_t>>(describe("ThreadSafeQueue<std::mutex>", scenario), config));
+        run(Stress::run_queue<ThreadSafeQueue<uint64_t, ProfiledMutex<std::mutex, "stress queue">>>(
+            describe("ThreadSafeQueue<ProfiledMutex>", scenario), config));
+        run(Stress::run_queue<ThreadSafeQueue<uint64_t, SpinLock>>(describe("ThreadSafeQueue<SpinLock>", scenario), config));
+        run(Stress::run_queue<ChunkedThreadSafeQueue<uint64_t>>(describe("ChunkedThreadSafeQueue", scenario), config));
+        run(Stress::run_queue<RingThreadSafeQueue<uint64_t>>(describe("RingThreadSafeQueue", scenario), config));
+    }
+
+    for (const auto& scenario : scenarios)
+    {
+        const auto config = make_config(scenario, pool_items);
+
+        run(Stress::run_pool<ver_1::ThreadPool>(describe("ver_1::ThreadPool", scenario), config));
+        run(Stress::run_pool<ThreadPool>(describe("ThreadPool", scenario), config));
+        run(Stress::run_pool<InstrumentedThreadPool>(describe("InstrumentedThreadPool", scenario), config));
+        run(Stress::run_pool<ElasticPool>(describe("ElasticThreadPool", scenario), config));
+        run(Stress::run_pool<NumaThreadPool>(describe("NumaThreadPool (unpinned)", scenario), config, WorkerPlacement::unpinned));
+        run(Stress::run_pool<NumaThreadPool>(describe("NumaThreadPool (pinned)", scenario), config, WorkerPlacement::pinned));
+    }
+
+    for (const auto& scenario : scenarios)
+    {
+        if (scenario.yield_per_mille != 0)
+            continue;
+
+        const auto map_workers = " map x" + std::to_string(scenario.consumers);
+        run(run_pipeline("Pipeline (ordered)" + map_workers, scenario, queue_items, Pipeline::Order::preserved));
+        run(run_pipeline("Pipeline (unordered)" + map_workers, scenario, queue_items, Pipeline::Order::unordered));
+    }
+
+    size_t failed = 0;
+    for (const auto& r : results)
+        failed += !r.passed();
+
+    std::cout << "\n" << results.size() - failed << "/" << results.size() << " passed\n";
+
+    return failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
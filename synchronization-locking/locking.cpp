@@ -1,5 +1,11 @@
+#include "concurrent_hash_map.hpp"
+#include "lookup_table.hpp"
+#include "profiled_mutex.hpp"
+#include "trace_recorder.hpp"
+
 #include <cassert>
 #include <chrono>
+#include <cstdlib>
 #include <functional>
 #include <iostream>
 #include <mutex>
@@ -23,27 +29,33 @@ void may_throw()
     throw std::runtime_error("ERROR#13");
 }
 
-template <typename T>
+template <typename T, typename TMutex = std::mutex>
 struct SynchronizedValue
 {
     T value;
-    std::mutex mtx_value;
+    TMutex mtx_value;
 
     [[nodiscard("Must be assigned to start critical section")]]
-    std::unique_lock<std::mutex> lock()
+    std::unique_lock<TMutex> lock()
     {
+        Trace::Scope trace{"lock acquisition"};
         return std::unique_lock{mtx_value};
     }
 
     template <typename F>
     void with_lock(F&& f)
     {
-        std::lock_guard lk{mtx_value};
+        std::unique_lock lk{mtx_value, std::defer_lock};
+        {
+            Trace::Scope trace{"lock acquisition"};
+            lk.lock();
+        }
         f(value);
     }
 };
 
-void run(SynchronizedValue<int>& counter)
+template <typename TMutex>
+void run(SynchronizedValue<int, TMutex>& counter)
 {
     for (int i = 0; i < 10'000'000; ++i)
     {
@@ -75,37 +87,45 @@ void run(std::atomic<int>& value)
     }
 }
 
+// counters spread over many keys - writers of different keys rarely share a lock
+void run(ConcurrentHashMap<int, int>& counters)
+{
+    for (int i = 0; i < 1'000'000; ++i)
+    {
+        counters.update(i % 1000, [](int& v) { ++v; });
+    }
+}
+
 constexpr uintmax_t factorial(uintmax_t n)
 {
     if (n <= 1)
         return 1;
-    return n * factorial(n - 1);
+    return LookupTable::checked_mul(n, factorial(n - 1)); // 21! does not fit - compile error in a table
 }
 
 template <size_t N>
 constexpr auto create_factorial_lookup_table()
 {
-    std::array<uintmax_t, N> results{};
-
-    for (size_t i = 0; i < N; ++i)
-        results[i] = factorial(i);
-
-    return results;
+    return LookupTable::make_lookup_table<N>(factorial);
 }
 
 void test_lookup_table()
 {
     // constexpr int test_r = hardening_code();
-    constexpr auto lookup_factorial = create_factorial_lookup_table<13>();
+    constexpr auto lookup_factorial = create_factorial_lookup_table<21>();
+    static_assert(lookup_factorial[20] == 2'432'902'008'176'640'000);
+    // constexpr auto too_large = create_factorial_lookup_table<22>(); // error: multiplication overflows
+
+    std::cout << "20! = " << lookup_factorial[20] << "\n";
 }
 
 void timed_mutex_demo()
 {
-    std::timed_mutex mutex;
+    ProfiledMutex<std::timed_mutex, "timed_mutex_demo"> mutex;
 
     auto work_1 = [&]() {
         std::cout << "START#1" << std::endl;
-        std::unique_lock<std::timed_mutex> lock(mutex, std::try_to_lock);
+        std::unique_lock lock(mutex, std::try_to_lock);
         if (!lock.owns_lock())
         {
             do
@@ -134,6 +154,8 @@ void timed_mutex_demo()
 
 int main()
 {
+    Trace::Session trace{std::getenv("TRACE_FILE")}; // e.g. TRACE_FILE=locking.json - open in ui.perfetto.dev
+
     std::cout << "Main thread starts..." << std::endl;
 
     // {
@@ -173,6 +195,24 @@ int main()
 
     std::cout << "-------------\n";
 
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+
+        SynchronizedValue<int, ProfiledMutex<std::mutex, "SynchronizedValue<int>">> counter{};
+
+        {
+            std::jthread thd_1{[&counter] { run(counter); }};
+            std::jthread thd_2{[&counter] { run(counter); }};
+        }
+
+        auto end = std::chrono::high_resolution_clock::now();
+
+        std::cout << "counter: " << counter.value << "\n";
+        std::cout << "time:" << std::chrono::duration_cast<std::chrono::milliseconds>(end - start) << "\n";
+    }
+
+    std::cout << "-------------\n";
+
     {
         auto start = std::chrono::high_resolution_clock::now();
 
@@ -188,7 +228,29 @@ int main()
         std::cout << "time:" << std::chrono::duration_cast<std::chrono::milliseconds>(end - start) << "\n";
     }
 
+    std::cout << "-------------\n";
+
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+
+        ConcurrentHashMap<int, int> counters;
+        {
+            std::jthread thd_1{[&counters] { run(counters); }};
+            std::jthread thd_2{[&counters] { run(counters); }};
+        }
+
+        auto end = std::chrono::high_resolution_clock::now();
+
+        std::cout << "counters: " << counters.size() << " x " << *counters.find(0) << "\n";
+        std::cout << "time:" << std::chrono::duration_cast<std::chrono::milliseconds>(end - start) << "\n";
+    }
+
     std::cout << "Main thread ends..." << std::endl;
 
     timed_mutex_demo();
+
+    std::cout << "-------------\n";
+    LockProfiling::report(std::cout);
+
+    test_lookup_table();
 }
@@ -0,0 +1,263 @@
+#ifndef ARENA_RESOURCE_HPP
+#define ARENA_RESOURCE_HPP
+
+#include "cache_line.hpp"
+#include "thread_slots.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory_resource>
+#include <new>
+#include <utility>
+
+// Thread-caching allocator for small, short-lived objects (tasks, shared states, queue nodes, log lines).
+// Every thread allocates from its own heap without any synchronization: blocks of one size class are carved
+// from 64 KiB chunks and recycled through per-thread free lists. A block freed by another thread goes back to
+// the heap it came from through a lock-free list that the owner drains when it runs out of blocks.
+// Requests above max_block_size (or over-aligned ones) go to the upstream resource.
+//
+//   ArenaResource arena;
+//   std::pmr::vector<int> v{&arena};                          // as a memory resource
+//   std::deque<Task, ArenaAllocator<Task>> tasks{ArenaAllocator<Task>{arena}}; // as an allocator
+//
+// Memory is returned to the system only when the resource dies - it must outlive everything allocated from it.
+// A heap of an exited thread (with its free blocks) is taken over by the next new thread.
+class ArenaResource : public std::pmr::memory_resource
+{
+public:
+    static constexpr size_t min_block_size = 16;
+    static constexpr size_t max_block_size = 4096;
+    static constexpr size_t chunk_size = 64 * 1024; // chunks are aligned to their size - a block finds its chunk by masking
+
+private:
+    static constexpr size_t class_count = std::countr_zero(max_block_size) - std::countr_zero(min_block_size) + 1;
+    static constexpr size_t max_alignment = 64; // blocks start at a multiple of min(block size, chunk header size)
+
+    struct FreeBlock
+    {
+        FreeBlock* next;
+    };
+
+    struct ThreadHeap;
+
+    struct alignas(max_alignment) Chunk
+    {
+        ThreadHeap* owner;
+        size_t size_class;
+        Chunk* next; // all chunks of the resource
+    };
+
+    struct ThreadHeap : ThreadSlot
+    {
+        std::array<FreeBlock*, class_count> free{}; // owner only
+        std::array<char*, class_count> carve{};     // owner only - next unused block in the class's current chunk
+        std::array<char*, class_count> carve_end{}; // owner only
+
+        alignas(cache_line_size) std::atomic<FreeBlock*> remote_free{nullptr}; // pushed by other threads
+    };
+
+    std::pmr::memory_resource* upstream_;
+    ThreadSlots<ThreadHeap> heaps_;
+    std::atomic<Chunk*> chunks_{nullptr};
+    std::atomic<size_t> chunk_count_{0};
+
+public:
+    explicit ArenaResource(std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+        : upstream_{upstream}
+    {
+    }
+
+    ArenaResource(const ArenaResource&) = delete;
+    ArenaResource& operator=(const ArenaResource&) = delete;
+
+    ~ArenaResource() override
+    {
+        for (Chunk* chunk = chunks_.load(std::memory_order_acquire); chunk != nullptr;)
+            ::operator delete(std::exchange(chunk, chunk->next), std::align_val_t{chunk_size});
+    }
+
+    // process-wide instance - never destroyed, so objects with static storage may use it safely
+    static ArenaResource& global()
+    {
+        static auto* resource = new ArenaResource;
+        return *resource;
+    }
+
+    // chunks taken from the system so far
+    size_t chunk_count() const
+    {
+        return chunk_count_.load(std::memory_order_relaxed);
+    }
+
+protected:
+    void* do_allocate(size_t bytes, size_t alignment) override
+    {
+        if (!is_small(bytes, alignment))
+            return upstream_->allocate(bytes, alignment);
+
+        const size_t size_class = size_class_of(bytes, alignment);
+        ThreadHeap& heap = heaps_.local();
+
+        FreeBlock* block = heap.free[size_class];
+        if (block == nullptr)
+        {
+            reclaim_remote_frees(heap);
+            block = heap.free[size_class];
+            if (block == nullptr)
+                return carve(heap, size_class);
+        }
+
+        heap.free[size_class] = block->next;
+        return block;
+    }
+
+    void do_deallocate(void* ptr, size_t bytes, size_t alignment) override
+    {
+        if (!is_small(bytes, alignment))
+            return upstream_->deallocate(ptr, bytes, alignment);
+
+        auto* block = static_cast<FreeBlock*>(ptr);
+        Chunk& chunk = chunk_of(ptr);
+        ThreadHeap& heap = heaps_.local();
+        if (chunk.owner == &heap)
+        {
+            block->next = heap.free[chunk.size_class];
+            heap.free[chunk.size_class] = block;
+            return;
+        }
+
+        // another thread's block - it goes back to its owner
+        block->next = chunk.owner->remote_free.load(std::memory_order_relaxed);
+        while (!chunk.owner->remote_free.compare_exchange_weak(block->next, block, std::memory_order_release, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+
+private:
+    static bool is_small(size_t bytes, size_t alignment)
+    {
+        return bytes <= max_block_size && alignment <= max_alignment;
+    }
+
+    // power-of-two classes from min_block_size - a block is aligned to its size (up to max_alignment)
+    static size_t size_class_of(size_t bytes, size_t alignment)
+    {
+        const size_t block_size = std::bit_ceil(std::max({bytes, alignment, min_block_size}));
+        return std::countr_zero(block_size) - std::countr_zero(min_block_size);
+    }
+
+    static size_t block_size_of(size_t size_class)
+    {
+        return min_block_size << size_class;
+    }
+
+    static Chunk& chunk_of(void* ptr)
+    {
+        return *reinterpret_cast<Chunk*>(reinterpret_cast<uintptr_t>(ptr) & ~(uintptr_t{chunk_size} - 1));
+    }
+
+    void* carve(ThreadHeap& heap, size_t size_class)
+    {
+        const size_t block_size = block_size_of(size_class);
+        if (heap.carve[size_class] == heap.carve_end[size_class])
+        {
+            char* chunk = new_chunk(heap, size_class);
+            heap.carve[size_class] = chunk + std::max(sizeof(Chunk), block_size);
+            heap.carve_end[size_class] = chunk + chunk_size;
+        }
+
+        void* block = heap.carve[size_class];
+        heap.carve[size_class] += block_size;
+        return block;
+    }
+
+    char* new_chunk(ThreadHeap& heap, size_t size_class)
+    {
+        auto* chunk = static_cast<Chunk*>(::operator new(chunk_size, std::align_val_t{chunk_size}));
+        chunk->owner = &heap;
+        chunk->size_class = size_class;
+        chunk->next = chunks_.load(std::memory_order_relaxed);
+        while (!chunks_.compare_exchange_weak(chunk->next, chunk, std::memory_order_release, std::memory_order_relaxed))
+        {
+        }
+        chunk_count_.fetch_add(1, std::memory_order_relaxed);
+        return reinterpret_cast<char*>(chunk);
+    }
+
+    void reclaim_remote_frees(ThreadHeap& heap)
+    {
+        for (FreeBlock* block = heap.remote_free.exchange(nullptr, std::memory_order_acquire); block != nullptr;)
+        {
+            FreeBlock* next = block->next;
+            const size_t size_class = chunk_of(block).size_class;
+            block->next = heap.free[size_class];
+            heap.free[size_class] = block;
+            block = next;
+        }
+    }
+};
+
+// standard allocator over an ArenaResource - default-constructed ones use ArenaResource::global(),
+// so containers that never pass an allocator (ThreadSafeQueue's std::queue, std::basic_string) can use it too
+template <typename T>
+class ArenaAllocator
+{
+    ArenaResource* resource_;
+
+    template <typename U>
+    friend class ArenaAllocator;
+
+public:
+    using value_type = T;
+
+    ArenaAllocator() noexcept
+        : resource_{&ArenaResource::global()}
+    {
+    }
+
+    explicit ArenaAllocator(ArenaResource& resource) noexcept
+        : resource_{&resource}
+    {
+    }
+
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept
+        : resource_{other.resource_}
+    {
+    }
+
+    T* allocate(size_t n)
+    {
+        if (n > std::numeric_limits<size_t>::max() / sizeof(T))
+            throw std::bad_array_new_length{};
+        return static_cast<T*>(resource_->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* ptr, size_t n) noexcept
+    {
+        resource_->deallocate(ptr, n * sizeof(T), alignof(T));
+    }
+
+    ArenaResource& resource() const noexcept
+    {
+        return *resource_;
+    }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>& other) const noexcept
+    {
+        return resource_ == other.resource_;
+    }
+};
+
+#endif // ARENA_RESOURCE_HPP
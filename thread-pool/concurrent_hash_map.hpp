@@ -0,0 +1,286 @@
+#ifndef CONCURRENT_HASH_MAP_HPP
+#define CONCURRENT_HASH_MAP_HPP
+
+#include "cache_line.hpp"
+#include "reclamation.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+// Hash map for shared state that is read far more often than written.
+// Readers never lock: they pin the epoch domain and walk the bucket chains, whose nodes are immutable -
+// a write links in a new node and retires the one it replaces.
+// Writers lock only the stripe their bucket belongs to, so writers of different stripes run in parallel.
+// Resizing does not block readers: growing copies the entries into a table twice the size and swaps it in
+// while readers keep using the old one. Writers do wait - grow() holds every stripe for the whole copy.
+//
+//   ConcurrentHashMap<std::string, Response> cache;
+//   cache.insert_or_assign(url, response);
+//   if (auto response = cache.find(url)) ...
+//   cache.update(url, [](Response& r) { ++r.hits; });
+template <typename K, typename V, typename THash = std::hash<K>, typename TKeyEqual = std::equal_to<K>>
+class ConcurrentHashMap
+{
+    static constexpr size_t stripe_count = 64;   // power of two - the table never has fewer buckets
+    static constexpr size_t max_load_factor = 1; // entries per bucket before the table grows
+
+    struct Node
+    {
+        const K key;
+        const V value;
+        std::atomic<Node*> next;
+
+        Node(K key, V value, Node* next)
+            : key{std::move(key)}
+            , value{std::move(value)}
+            , next{next}
+        {
+        }
+    };
+
+    struct Table
+    {
+        const size_t mask;
+        std::unique_ptr<std::atomic<Node*>[]> buckets;
+
+        explicit Table(size_t bucket_count)
+            : mask{bucket_count - 1}
+            , buckets{std::make_unique<std::atomic<Node*>[]>(bucket_count)}
+        {
+        }
+
+        // nodes still linked belong to the table - unlinked ones were retired on their own
+        ~Table()
+        {
+            for (size_t i = 0; i <= mask; ++i)
+            {
+                for (Node* node = buckets[i].load(std::memory_order_relaxed); node != nullptr;)
+                    delete std::exchange(node, node->next.load(std::memory_order_relaxed));
+            }
+        }
+
+        size_t bucket_count() const
+        {
+            return mask + 1;
+        }
+    };
+
+    struct alignas(cache_line_size) Stripe
+    {
+        std::mutex mtx;
+    };
+
+    std::atomic<Table*> table_;
+    std::atomic<size_t> size_{0};
+    std::unique_ptr<Stripe[]> stripes_{std::make_unique<Stripe[]>(stripe_count)};
+    THash hash_;
+    TKeyEqual equal_;
+    Reclamation::EpochDomain& domain_;
+
+public:
+    explicit ConcurrentHashMap(size_t bucket_count = stripe_count, Reclamation::EpochDomain& domain = Reclamation::EpochDomain::global())
+        : table_{new Table{std::bit_ceil(std::max(bucket_count, stripe_count))}}
+        , domain_{domain}
+    {
+    }
+
+    ConcurrentHashMap(const ConcurrentHashMap&) = delete;
+    ConcurrentHashMap& operator=(const ConcurrentHashMap&) = delete;
+
+    // no other thread may use the map any more
+    ~ConcurrentHashMap()
+    {
+        delete table_.load(std::memory_order_acquire);
+    }
+
+    // a snapshot
+    size_t size() const
+    {
+        return size_.load(std::memory_order_relaxed);
+    }
+
+    bool empty() const
+    {
+        return size() == 0;
+    }
+
+    size_t bucket_count() const
+    {
+        auto guard = domain_.pin();
+        return table_.load(std::memory_order_acquire)->bucket_count();
+    }
+
+    // lock-free - a copy of the value
+    std::optional<V> find(const K& key) const
+    {
+        auto guard = domain_.pin();
+        if (const Node* node = find_node(*table_.load(std::memory_order_acquire), key))
+            return node->value;
+        return std::nullopt;
+    }
+
+    bool contains(const K& key) const
+    {
+        auto guard = domain_.pin();
+        return find_node(*table_.load(std::memory_order_acquire), key) != nullptr;
+    }
+
+    // lock-free - visitor(const V&) runs while the entry is pinned; false when the key is absent
+    template <typename F>
+    bool visit(const K& key, F visitor) const
+    {
+        auto guard = domain_.pin();
+        if (const Node* node = find_node(*table_.load(std::memory_order_acquire), key))
+        {
+            visitor(node->value);
+            return true;
+        }
+        return false;
+    }
+
+    // true when the key was inserted, false when its value was replaced
+    bool insert_or_assign(const K& key, V value)
+    {
+        return write(key, [&](const Node*) -> std::optional<V> { return std::move(value); });
+    }
+
+    // true when the key was present
+    bool erase(const K& key)
+    {
+        bool erased = false;
+        write(key, [&](const Node* node) -> std::optional<V> {
+            erased = node != nullptr;
+            return std::nullopt;
+        });
+        return erased;
+    }
+
+    // modify(V&) runs on a copy of the current value (V{} when the key is absent), which then replaces it;
+    // updates of one key are serialized, so none of them is lost. True when the key was inserted.
+    template <typename F>
+    bool update(const K& key, F modify)
+    {
+        return write(key, [&](const Node* node) -> std::optional<V> {
+            V value = node != nullptr ? node->value : V{};
+            modify(value);
+            return value;
+        });
+    }
+
+private:
+    size_t hash(const K& key) const
+    {
+        // std::hash of integers is the identity - mix all bits into the low ones used for masking (murmur3 finalizer)
+        auto h = static_cast<uint64_t>(hash_(key));
+        h = (h ^ (h >> 33)) * 0xff51afd7ed558ccdull;
+        h = (h ^ (h >> 33)) * 0xc4ceb9fe1a85ec53ull;
+        return static_cast<size_t>(h ^ (h >> 33));
+    }
+
+    const Node* find_node(const Table& table, const K& key) const
+    {
+        for (const Node* node = table.buckets[hash(key) & table.mask].load(std::memory_order_acquire); node != nullptr;
+             node = node->next.load(std::memory_order_acquire))
+        {
+            if (equal_(node->key, key))
+                return node;
+        }
+        return nullptr;
+    }
+
+    // tables have at least stripe_count buckets (both powers of two), so a key keeps its stripe when the table grows
+    Stripe& stripe_of(size_t hash_value)
+    {
+        return stripes_[hash_value & (stripe_count - 1)];
+    }
+
+    // next_value(const Node* current) - the new value, or nullopt to remove the entry; true when the key was inserted
+    template <typename F>
+    bool write(const K& key, F next_value)
+    {
+        const size_t hash_value = hash(key);
+        bool inserted = false;
+        Node* unlinked = nullptr;
+        size_t bucket_count;
+        {
+            // no resize can start while the stripe is held and the chain's nodes are unlinked only under it
+            std::lock_guard lk{stripe_of(hash_value).mtx};
+            Table& table = *table_.load(std::memory_order_acquire);
+            std::atomic<Node*>* link = &table.buckets[hash_value & table.mask];
+            Node* node = link->load(std::memory_order_relaxed);
+            while (node != nullptr && !equal_(node->key, key))
+            {
+                link = &node->next;
+                node = link->load(std::memory_order_relaxed);
+            }
+
+            std::optional<V> value = next_value(node);
+            Node* next = node != nullptr ? node->next.load(std::memory_order_relaxed) : nullptr;
+            if (value)
+            {
+                Node* replacement = new Node{key, std::move(*value), next};
+                link->store(replacement, std::memory_order_release);
+                inserted = node == nullptr;
+            }
+            else if (node != nullptr)
+            {
+                link->store(next, std::memory_order_release);
+            }
+
+            unlinked = node;
+            if (inserted)
+                size_.fetch_add(1, std::memory_order_relaxed);
+            else if (node != nullptr && !value)
+                size_.fetch_sub(1, std::memory_order_relaxed);
+
+            bucket_count = table.bucket_count();
+        }
+
+        if (unlinked != nullptr)
+            domain_.retire(unlinked); // outside the stripe - readers still on it keep walking through its next
+        if (inserted && size() > bucket_count * max_load_factor)
+            grow(bucket_count);
+        return inserted;
+    }
+
+    // locks every stripe in order - writers wait, readers go on with the old table until the swap
+    void grow(size_t seen_bucket_count)
+    {
+        Table* old_table;
+        {
+            std::array<std::unique_lock<std::mutex>, stripe_count> locks;
+            for (size_t i = 0; i < stripe_count; ++i)
+                locks[i] = std::unique_lock{stripes_[i].mtx};
+
+            old_table = table_.load(std::memory_order_acquire);
+            if (old_table->bucket_count() != seen_bucket_count)
+                return; // another writer has grown it already
+
+            auto* new_table = new Table{2 * old_table->bucket_count()};
+            for (size_t i = 0; i <= old_table->mask; ++i)
+            {
+                for (const Node* node = old_table->buckets[i].load(std::memory_order_relaxed); node != nullptr;
+                     node = node->next.load(std::memory_order_relaxed))
+                {
+                    auto& bucket = new_table->buckets[hash(node->key) & new_table->mask];
+                    bucket.store(new Node{node->key, node->value, bucket.load(std::memory_order_relaxed)}, std::memory_order_relaxed);
+                }
+            }
+
+            table_.store(new_table, std::memory_order_release);
+        }
+
+        domain_.retire(old_table); // outside the stripes - retiring may collect and free a lot
+    }
+};
+
+#endif // CONCURRENT_HASH_MAP_HPP
@@ -0,0 +1,290 @@
+#ifndef CONSOLE_SINK_HPP
+#define CONSOLE_SINK_HPP
+
+#include "arena_resource.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <thread>
+
+// Line output for many threads without a global lock - a replacement for std::osyncstream in hot paths.
+// A thread formats a line in its own reusable buffer and publishes the complete line to a lock-free
+// list; a single writer thread takes all published lines at once and writes them to the stream.
+// Lines never interleave and the lines of one thread keep their order.
+//
+//   ConsoleSink::console().line() << "Result for " << n << ": " << result << "\n";
+//   ConsoleSink::console().flush(); // before writing to the stream directly
+//
+// Like with std::osyncstream, a line is the text collected by one line() - add "\n" (or std::endl) yourself.
+// A line left by an exception is dropped instead of being printed half-formatted.
+class ConsoleSink
+{
+    enum class NodeKind : unsigned char
+    {
+        line,  // text follows the node
+        flush, // everything before it is to be written - size is the flush ticket
+        stop   // last node - the writer exits
+    };
+
+    struct Node
+    {
+        Node* next;
+        size_t size;
+        NodeKind kind;
+
+        char* text()
+        {
+            return reinterpret_cast<char*>(this + 1);
+        }
+    };
+
+    // keeps its capacity from line to line
+    class LineBuffer : public std::streambuf
+    {
+        std::string text_;
+
+    public:
+        std::string_view text() const
+        {
+            return text_;
+        }
+
+        void clear()
+        {
+            text_.clear();
+        }
+
+    protected:
+        int_type overflow(int_type ch) override
+        {
+            if (!traits_type::eq_int_type(ch, traits_type::eof()))
+                text_.push_back(traits_type::to_char_type(ch));
+            return traits_type::not_eof(ch);
+        }
+
+        std::streamsize xsputn(const char* s, std::streamsize count) override
+        {
+            text_.append(s, static_cast<size_t>(count));
+            return count;
+        }
+    };
+
+    struct LineStream
+    {
+        LineBuffer buffer;
+        std::ostream stream{&buffer};
+        bool in_use = false;
+
+        // format flags of a fresh stream - std::hex & co. must not leak into the next line
+        void reset()
+        {
+            buffer.clear();
+            stream.flags(std::ios_base::skipws | std::ios_base::dec);
+            stream.precision(6);
+            stream.width(0);
+            stream.fill(' ');
+            stream.clear();
+        }
+    };
+
+public:
+    // collects one line - published when destroyed
+    class Line
+    {
+        ConsoleSink& sink_;
+        std::unique_ptr<LineStream> own_stream_; // only when the thread formats two lines at once
+        LineStream& line_stream_;
+        const int uncaught_exceptions_;
+
+    public:
+        explicit Line(ConsoleSink& sink)
+            : sink_{sink}
+            , own_stream_{thread_stream().in_use ? std::make_unique<LineStream>() : nullptr}
+            , line_stream_{own_stream_ ? *own_stream_ : thread_stream()}
+            , uncaught_exceptions_{std::uncaught_exceptions()}
+        {
+            line_stream_.in_use = true;
+        }
+
+        Line(const Line&) = delete;
+        Line& operator=(const Line&) = delete;
+
+        ~Line()
+        {
+            if (std::uncaught_exceptions() == uncaught_exceptions_)
+                sink_.publish(line_stream_.buffer.text());
+            line_stream_.reset();
+            line_stream_.in_use = false;
+        }
+
+        template <typename T>
+        Line& operator<<(const T& value)
+        {
+            line_stream_.stream << value;
+            return *this;
+        }
+
+        // std::endl, std::hex, ...
+        Line& operator<<(std::ostream& (*manipulator)(std::ostream&))
+        {
+            line_stream_.stream << manipulator;
+            return *this;
+        }
+
+        Line& operator<<(std::ios_base& (*manipulator)(std::ios_base&))
+        {
+            line_stream_.stream << manipulator;
+            return *this;
+        }
+
+        std::ostream& stream()
+        {
+            return line_stream_.stream;
+        }
+    };
+
+    explicit ConsoleSink(std::ostream& out)
+        : out_{out}
+        , writer_{[this] { write_lines(); }}
+    {
+    }
+
+    ConsoleSink(const ConsoleSink&) = delete;
+    ConsoleSink& operator=(const ConsoleSink&) = delete;
+
+    // writes all published lines - no other thread may use the sink any more
+    ~ConsoleSink()
+    {
+        Node stop{nullptr, 0, NodeKind::stop};
+        push(&stop);
+        writer_.join();
+    }
+
+    // std::cout - drained when the program exits
+    static ConsoleSink& console()
+    {
+        static ConsoleSink sink{std::cout};
+        return sink;
+    }
+
+    Line line()
+    {
+        return Line{*this};
+    }
+
+    // publishes text as one line
+    void write(std::string_view text)
+    {
+        publish(text);
+    }
+
+    // returns when everything published so far (by any thread) is written and the stream flushed
+    void flush()
+    {
+        std::lock_guard lk{mtx_flush_}; // one marker at a time - tickets are written in the order they are taken
+        Node marker{nullptr, ++flush_ticket_, NodeKind::flush};
+        push(&marker);
+        for (size_t flushed = flushed_.load(std::memory_order_acquire); flushed < marker.size; flushed = flushed_.load(std::memory_order_acquire))
+            flushed_.wait(flushed, std::memory_order_acquire);
+    }
+
+private:
+    std::ostream& out_;
+    ArenaResource arena_; // nodes are freed by the writer - back to the thread caches of their producers
+    std::atomic<Node*> published_{nullptr}; // newest first
+    std::mutex mtx_flush_;
+    size_t flush_ticket_ = 0;
+    std::atomic<size_t> flushed_{0}; // the marker itself lives on the stack of flush() - only the ticket is signalled
+    std::thread writer_;
+
+    static LineStream& thread_stream()
+    {
+        thread_local LineStream line_stream;
+        return line_stream;
+    }
+
+    void publish(std::string_view text)
+    {
+        if (text.empty())
+            return;
+
+        void* memory = arena_.allocate(sizeof(Node) + text.size(), alignof(Node));
+        auto* node = new (memory) Node{nullptr, text.size(), NodeKind::line};
+        std::memcpy(node->text(), text.data(), text.size());
+        push(node);
+    }
+
+    // node belongs to the writer as soon as it is published - not touched afterwards
+    void push(Node* node)
+    {
+        Node* newest = published_.load(std::memory_order_relaxed);
+        do
+        {
+            node->next = newest;
+        } while (!published_.compare_exchange_weak(newest, node, std::memory_order_release, std::memory_order_relaxed));
+
+        if (newest == nullptr)
+            published_.notify_one(); // the writer may sleep only on an empty list
+    }
+
+    void write_lines()
+    {
+        std::string chunk; // lines of one batch - written with a single call
+
+        while (true)
+        {
+            Node* newest = published_.exchange(nullptr, std::memory_order_acquire);
+            if (newest == nullptr)
+            {
+                published_.wait(nullptr, std::memory_order_acquire);
+                continue;
+            }
+
+            Node* oldest = nullptr;
+            while (newest != nullptr)
+                oldest = std::exchange(newest, std::exchange(newest->next, oldest));
+
+            for (Node* node = oldest; node != nullptr;)
+            {
+                Node* next = node->next;
+                switch (node->kind)
+                {
+                case NodeKind::line:
+                    chunk.append(node->text(), node->size);
+                    arena_.deallocate(node, sizeof(Node) + node->size, alignof(Node));
+                    break;
+                case NodeKind::flush:
+                    write_chunk(chunk);
+                    flushed_.store(node->size, std::memory_order_release);
+                    flushed_.notify_all();
+                    break;
+                case NodeKind::stop:
+                    write_chunk(chunk);
+                    return;
+                }
+                node = next;
+            }
+            write_chunk(chunk);
+        }
+    }
+
+    void write_chunk(std::string& chunk)
+    {
+        if (chunk.empty())
+            return;
+        out_.write(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+        out_.flush();
+        chunk.clear();
+    }
+};
+
+#endif // CONSOLE_SINK_HPP
@@ -0,0 +1,278 @@
+#ifndef ELASTIC_THREAD_POOL_HPP
+#define ELASTIC_THREAD_POOL_HPP
+
+#include "task_context.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <map>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <utility>
+#include <vector>
+
+struct ElasticPoolConfig
+{
+    size_t min_threads = 1;
+    size_t max_threads = 4 * std::max(1u, std::thread::hardware_concurrency());
+    std::chrono::milliseconds spawn_threshold{5}; // task waiting longer than this gets a new worker
+    std::chrono::milliseconds idle_timeout{500}; // idle worker above min_threads retires after this
+    size_t max_blocked_compensation = 4 * std::max(1u, std::thread::hardware_concurrency()); // extra workers for blocked tasks - on top of max_threads
+};
+
+class ElasticThreadPool
+{
+public:
+    using Task = std::move_only_function<void()>;
+    using Clock = std::chrono::steady_clock;
+
+    // RAII hint - a task that is about to block (I/O, sleep) lends its core to a compensating worker
+    class BlockingSection
+    {
+        ElasticThreadPool* pool_;
+
+    public:
+        explicit BlockingSection(ElasticThreadPool& pool)
+            : pool_{&pool}
+        {
+            pool_->enter_blocking_section();
+        }
+
+        BlockingSection(const BlockingSection&) = delete;
+        BlockingSection& operator=(const BlockingSection&) = delete;
+
+        ~BlockingSection()
+        {
+            pool_->leave_blocking_section();
+        }
+    };
+
+    explicit ElasticThreadPool(ElasticPoolConfig config = {})
+        : config_{config}
+    {
+        assert(config_.min_threads > 0 && "Pool needs at least one worker");
+        assert(config_.min_threads <= config_.max_threads);
+
+        std::lock_guard lk{mtx_};
+        for (size_t i = 0; i < config_.min_threads; ++i)
+            spawn_worker();
+
+        supervisor_ = std::jthread{[this](std::stop_token stop_tkn) { supervise(stop_tkn); }};
+    }
+
+    ElasticThreadPool(const ElasticThreadPool&) = delete;
+    ElasticThreadPool& operator=(const ElasticThreadPool&) = delete;
+
+    ~ElasticThreadPool()
+    {
+        {
+            std::lock_guard lk{mtx_};
+            end_of_work_ = true;
+        }
+        cv_tasks_.notify_all();
+
+        supervisor_.request_stop();
+        supervisor_.join();
+
+        // no worker is spawned or retired after end_of_work_ is set
+        for (auto& [id, thd] : workers_)
+            thd.join();
+
+        for (auto& thd : retired_)
+            thd.join();
+    }
+
+    template <typename FunctionTask>
+    auto submit(FunctionTask&& ftask)
+    {
+        using TResult = decltype(ftask());
+        std::packaged_task<TResult()> pt{std::forward<FunctionTask>(ftask)};
+        std::future<TResult> f_result = pt.get_future();
+
+        bool was_empty;
+        {
+            std::lock_guard lk{mtx_};
+            auto task = [pt = std::move(pt), context = TaskContext::capture()]() mutable {
+                ContextScope scope{std::move(context)};
+                pt();
+            };
+            was_empty = tasks_.empty();
+            tasks_.push_back(QueuedTask{std::move(task), Clock::now()});
+        }
+        cv_tasks_.notify_one();
+        if (was_empty) // supervisor sleeps on an empty queue - it tracks the oldest task only
+            cv_supervisor_.notify_one();
+
+        return f_result;
+    }
+
+    [[nodiscard("Blocking section ends when the guard is destroyed")]]
+    BlockingSection blocking_section()
+    {
+        return BlockingSection{*this};
+    }
+
+    size_t thread_count() const
+    {
+        std::lock_guard lk{mtx_};
+        return workers_.size();
+    }
+
+    size_t idle_count() const
+    {
+        std::lock_guard lk{mtx_};
+        return idle_count_;
+    }
+
+    size_t blocked_count() const
+    {
+        std::lock_guard lk{mtx_};
+        return blocked_count_;
+    }
+
+    size_t pending_count() const
+    {
+        std::lock_guard lk{mtx_};
+        return tasks_.size();
+    }
+
+private:
+    struct QueuedTask
+    {
+        Task task;
+        Clock::time_point enqueued_at;
+    };
+
+    const ElasticPoolConfig config_;
+    mutable std::mutex mtx_;
+    std::condition_variable cv_tasks_;
+    std::condition_variable_any cv_supervisor_; // first task queued, task blocked, worker retired
+    std::deque<QueuedTask> tasks_;
+    std::map<size_t, std::thread> workers_;
+    std::vector<std::thread> retired_;
+    size_t next_worker_id_ = 0;
+    size_t idle_count_ = 0;
+    size_t blocked_count_ = 0;
+    bool end_of_work_ = false;
+    std::jthread supervisor_;
+
+    // blocked workers do not occupy a core, so they do not count against max_threads - up to max_blocked_compensation of them
+    bool can_grow() const // mtx_ must be held
+    {
+        return !end_of_work_ && workers_.size() < config_.max_threads + std::min(blocked_count_, config_.max_blocked_compensation);
+    }
+
+    void spawn_worker() // mtx_ must be held
+    {
+        const size_t id = next_worker_id_++;
+        workers_.emplace(id, std::thread{[this, id] { run(id); }});
+    }
+
+    void run(size_t id)
+    {
+        std::unique_lock lk{mtx_};
+
+        while (true)
+        {
+            ++idle_count_;
+            cv_tasks_.wait_for(lk, config_.idle_timeout, [this] { return end_of_work_ || !tasks_.empty(); });
+            --idle_count_;
+
+            if (!tasks_.empty()) // queue is drained before the pool shuts down
+            {
+                Task task = std::move(tasks_.front().task);
+                tasks_.pop_front();
+
+                lk.unlock();
+                task(); // execution of task
+                task = nullptr;
+                lk.lock();
+
+                continue;
+            }
+
+            if (end_of_work_)
+                return;
+
+            if (workers_.size() > config_.min_threads) // idle timeout - retire
+            {
+                auto node = workers_.extract(id);
+                retired_.push_back(std::move(node.mapped()));
+                cv_supervisor_.notify_one();
+                return;
+            }
+        }
+    }
+
+    // sleeps until the oldest task becomes overdue (or a change of the queue/worker set) - an idle pool is not polled;
+    // spawns at most one worker per tick, so a burst of overdue tasks does not start a worker for each of them
+    void supervise(std::stop_token stop_tkn)
+    {
+        const auto tick = std::max(config_.spawn_threshold / 2, std::chrono::milliseconds{1});
+        auto has_retired = [this] { return !retired_.empty(); };
+
+        std::unique_lock lk{mtx_};
+        while (!stop_tkn.stop_requested())
+        {
+            if (!retired_.empty())
+            {
+                std::vector<std::thread> retired = std::exchange(retired_, {});
+                lk.unlock();
+                for (auto& thd : retired)
+                    thd.join();
+                lk.lock();
+                continue;
+            }
+
+            if (tasks_.empty())
+            {
+                cv_supervisor_.wait(lk, stop_tkn, [&] { return !tasks_.empty() || has_retired(); });
+                continue;
+            }
+
+            // tasks_ is FIFO - the front one is the oldest
+            const auto overdue_at = tasks_.front().enqueued_at + config_.spawn_threshold;
+            if (Clock::now() < overdue_at)
+            {
+                cv_supervisor_.wait_until(lk, stop_tkn, overdue_at, has_retired);
+            }
+            else if (idle_count_ > 0) // a worker is about to take it
+            {
+                cv_supervisor_.wait_for(lk, stop_tkn, tick, has_retired);
+            }
+            else if (!can_grow())
+            {
+                cv_supervisor_.wait(lk, stop_tkn, [&] { return can_grow() || has_retired(); });
+            }
+            else
+            {
+                spawn_worker();
+                cv_supervisor_.wait_for(lk, stop_tkn, tick, has_retired);
+            }
+        }
+    }
+
+    void enter_blocking_section()
+    {
+        std::lock_guard lk{mtx_};
+        ++blocked_count_;
+
+        if (idle_count_ == 0 && can_grow())
+            spawn_worker();
+        cv_supervisor_.notify_one(); // may grow again for tasks still waiting
+    }
+
+    void leave_blocking_section()
+    {
+        std::lock_guard lk{mtx_};
+        --blocked_count_; // surplus worker retires after idle_timeout
+    }
+};
+
+#endif // ELASTIC_THREAD_POOL_HPP
@@ -0,0 +1,236 @@
+#ifndef FUTURE_CACHE_HPP
+#define FUTURE_CACHE_HPP
+
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+
+enum class ExceptionPolicy
+{
+    cache, // a failed computation is remembered like a result - later requests rethrow it
+    retry  // a failed computation is forgotten once it completes - the next request computes again
+};
+
+struct FutureCacheConfig
+{
+    size_t capacity = 1024; // entries kept - the least recently used completed one is evicted first
+                            // (computations in flight are never evicted and may exceed it for a while)
+    ExceptionPolicy exceptions = ExceptionPolicy::retry;
+};
+
+struct FutureCacheStats
+{
+    uint64_t hits = 0;         // result was already there
+    uint64_t joined = 0;       // computation was in flight - the request waited for it instead of starting another one
+    uint64_t computations = 0; // misses
+    uint64_t failures = 0;     // computations that threw
+    uint64_t evictions = 0;
+
+    uint64_t requests() const
+    {
+        return hits + joined + computations;
+    }
+
+    double hit_rate() const
+    {
+        return requests() ? static_cast<double>(hits + joined) / requests() : 0.0;
+    }
+};
+
+// Memoization of expensive pure computations: concurrent requests for one key share a single computation
+// (every caller gets the same shared_future), completed results are kept in an LRU of bounded size.
+//
+//   FutureCache<int, int> squares{{.capacity = 100}};
+//   auto result = squares.get(13, [] { return calculate_square(13); });      // computed by the caller
+//   auto result = squares.get(13, pool, [] { return calculate_square(13); }); // computed as a pool task
+//   result.get();
+template <typename K, typename V, typename THash = std::hash<K>>
+class FutureCache
+{
+    struct Entry
+    {
+        std::shared_future<V> result;
+        typename std::list<K>::iterator lru_position;
+        uint64_t id; // tells a recomputed entry from the failed one it replaced
+    };
+
+    // the computation the caller has to start - empty on a hit
+    struct Reservation
+    {
+        std::shared_future<V> result;
+        std::optional<std::promise<V>> promise;
+        uint64_t id = 0;
+    };
+
+    const FutureCacheConfig config_;
+    std::unordered_map<K, Entry, THash> entries_;
+    std::list<K> lru_; // most recently used first
+    uint64_t next_id_ = 0;
+    FutureCacheStats stats_;
+    mutable std::mutex mtx_entries_;
+
+public:
+    explicit FutureCache(FutureCacheConfig config = {})
+        : config_{config}
+    {
+        assert(config_.capacity > 0 && "Cache needs room for at least one entry");
+    }
+
+    FutureCache(const FutureCache&) = delete;
+    FutureCache& operator=(const FutureCache&) = delete;
+
+    // compute() runs on the calling thread when the key is missing - concurrent callers wait for its result
+    template <typename F>
+    std::shared_future<V> get(const K& key, F compute)
+    {
+        Reservation reservation = reserve(key);
+        if (reservation.promise)
+            fulfill(key, reservation, compute);
+        return reservation.result;
+    }
+
+    // compute() runs as an executor task (executor.submit(callable)) when the key is missing;
+    // if submit() throws, the key is forgotten (callers that joined meanwhile see broken_promise) and the exception is rethrown
+    template <typename TExecutor, typename F>
+    std::shared_future<V> get(const K& key, TExecutor& executor, F compute)
+    {
+        Reservation reservation = reserve(key);
+        if (reservation.promise)
+        {
+            auto result = reservation.result;
+            const uint64_t id = reservation.id;
+            try
+            {
+                executor.submit([this, key, reservation = std::move(reservation), compute = std::move(compute)]() mutable {
+                    fulfill(key, reservation, compute);
+                });
+            }
+            catch (...)
+            {
+                std::lock_guard lk{mtx_entries_};
+                forget(key, id);
+                throw;
+            }
+            return result;
+        }
+        return reservation.result;
+    }
+
+    // cached or in flight
+    bool contains(const K& key) const
+    {
+        std::lock_guard lk{mtx_entries_};
+        return entries_.contains(key);
+    }
+
+    void erase(const K& key)
+    {
+        std::lock_guard lk{mtx_entries_};
+        if (auto it = entries_.find(key); it != entries_.end())
+            remove(it);
+    }
+
+    size_t size() const
+    {
+        std::lock_guard lk{mtx_entries_};
+        return entries_.size();
+    }
+
+    FutureCacheStats stats() const
+    {
+        std::lock_guard lk{mtx_entries_};
+        return stats_;
+    }
+
+private:
+    Reservation reserve(const K& key)
+    {
+        std::lock_guard lk{mtx_entries_};
+
+        if (auto it = entries_.find(key); it != entries_.end())
+        {
+            Entry& entry = it->second;
+            lru_.splice(lru_.begin(), lru_, entry.lru_position);
+            if (is_ready(entry.result))
+                ++stats_.hits;
+            else
+                ++stats_.joined;
+            return Reservation{entry.result, std::nullopt};
+        }
+
+        ++stats_.computations;
+        Reservation reservation{{}, std::promise<V>{}, next_id_++};
+        reservation.result = reservation.promise->get_future().share();
+
+        lru_.push_front(key);
+        entries_.emplace(key, Entry{reservation.result, lru_.begin(), reservation.id});
+        evict();
+
+        return reservation;
+    }
+
+    // the computation runs without the lock - other keys are served meanwhile
+    template <typename F>
+    void fulfill(const K& key, Reservation& reservation, F& compute)
+    {
+        try
+        {
+            reservation.promise->set_value(compute());
+        }
+        catch (...)
+        {
+            {
+                std::lock_guard lk{mtx_entries_};
+                ++stats_.failures;
+
+                // forgotten before the exception is published - callers already waiting see it, the next request starts over
+                if (config_.exceptions == ExceptionPolicy::retry)
+                    forget(key, reservation.id);
+            }
+            reservation.promise->set_exception(std::current_exception());
+        }
+    }
+
+    // least recently used completed entries go first - an entry in flight is kept, so its key is never computed twice
+    void evict()
+    {
+        for (auto position = lru_.end(); entries_.size() > config_.capacity && position != lru_.begin();)
+        {
+            --position;
+            auto it = entries_.find(*position);
+            if (!is_ready(it->second.result))
+                continue;
+
+            position = lru_.erase(position);
+            entries_.erase(it);
+            ++stats_.evictions;
+        }
+    }
+
+    // removes the entry of one computation - not a later one for the same key; mtx_entries_ must be held
+    void forget(const K& key, uint64_t id)
+    {
+        if (auto it = entries_.find(key); it != entries_.end() && it->second.id == id)
+            remove(it);
+    }
+
+    void remove(typename std::unordered_map<K, Entry, THash>::iterator it)
+    {
+        lru_.erase(it->second.lru_position);
+        entries_.erase(it);
+    }
+
+    static bool is_ready(const std::shared_future<V>& result)
+    {
+        return result.wait_for(std::chrono::seconds::zero()) == std::future_status::ready;
+    }
+};
+
+#endif // FUTURE_CACHE_HPP
@@ -0,0 +1,92 @@
+#ifndef LOOKUP_TABLE_HPP
+#define LOOKUP_TABLE_HPP
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+// Compile-time tables for hot paths: table[i] == f(i) for i in [0, N).
+// Generators run in a constant expression, so an overflow reported by a throw (see the
+// checked_* helpers) or a value that does not fit into the table's element type is a compile error,
+// never a silently wrapped entry.
+namespace LookupTable
+{
+    template <std::unsigned_integral T>
+    constexpr T checked_add(T a, T b)
+    {
+        if (a > std::numeric_limits<T>::max() - b)
+            throw std::overflow_error("lookup table: addition overflows");
+        return a + b;
+    }
+
+    template <std::unsigned_integral T>
+    constexpr T checked_mul(T a, T b)
+    {
+        if (a != 0 && b > std::numeric_limits<T>::max() / a)
+            throw std::overflow_error("lookup table: multiplication overflows");
+        return a * b;
+    }
+
+    template <std::unsigned_integral T>
+    constexpr T checked_shl(T value, unsigned shift)
+    {
+        if (shift >= std::numeric_limits<T>::digits || value > (std::numeric_limits<T>::max() >> shift))
+            throw std::overflow_error("lookup table: shift overflows");
+        return value << shift;
+    }
+
+    // floor(sqrt(value)) - std::sqrt is not constexpr
+    constexpr uint64_t isqrt(uint64_t value)
+    {
+        uint64_t result = 0;
+        for (uint64_t bit = uint64_t{1} << 62; bit != 0; bit >>= 2)
+        {
+            if (value >= result + bit)
+            {
+                value -= result + bit;
+                result = (result >> 1) + bit;
+            }
+            else
+            {
+                result >>= 1;
+            }
+        }
+        return result;
+    }
+
+    // T - element type; defaults to the generator's result, a narrower integral type is range-checked
+    template <size_t N, typename T = void, typename F>
+    consteval auto make_lookup_table(F f)
+    {
+        using TResult = std::invoke_result_t<F&, size_t>;
+        using TElement = std::conditional_t<std::is_void_v<T>, TResult, T>;
+
+        std::array<TElement, N> table{};
+        for (size_t i = 0; i < N; ++i)
+        {
+            const TResult value = f(i);
+
+            if constexpr (std::is_integral_v<TResult> && std::is_integral_v<TElement>)
+            {
+                if (!std::in_range<TElement>(value))
+                    throw std::overflow_error("lookup table: value does not fit into the element type");
+            }
+            else if constexpr (std::is_floating_point_v<TResult>)
+            {
+                if (value != value || value > std::numeric_limits<TResult>::max() || value < std::numeric_limits<TResult>::lowest())
+                    throw std::overflow_error("lookup table: value is not finite");
+            }
+
+            table[i] = static_cast<TElement>(value);
+        }
+
+        return table;
+    }
+} // namespace LookupTable
+
+#endif // LOOKUP_TABLE_HPP
@@ -1,19 +1,28 @@
-#include "thread_safe_queue.hpp"
-
+#include "console_sink.hpp"
+#include "elastic_thread_pool.hpp"
+#include "future_cache.hpp"
+#include "thread_pool.hpp"
+#include "trace_recorder.hpp"
+#include "worker_team.hpp"
+
+#include <algorithm>
 #include <cassert>
+#include <cmath>
 #include <chrono>
+#include <cstdlib>
+#include <expected>
 #include <functional>
 #include <iostream>
 #include <string>
 #include <thread>
 #include <vector>
 #include <random>
-#include <syncstream>
 #include <future>
 
-std::osyncstream sync_cout()
+// lines from many threads without a global lock - formatted per thread, written by the sink's writer thread
+ConsoleSink::Line sync_cout()
 {
-    return std::osyncstream{std::cout};
+    return ConsoleSink::console().line();
 }
 
 using namespace std::literals;
@@ -47,134 +56,119 @@ int calculate_square(int x)
     return x * x;
 }
 
-namespace ver_1
+void elastic_thread_pool_demo()
 {
-    using Task = std::function<void()>;
+    ElasticThreadPool thd_pool{{.min_threads = 2, .max_threads = 16}};
 
-    class ThreadPool
+    for (int i = 1; i <= 8; ++i)
     {
-    public:
-        explicit ThreadPool(size_t thread_count)
-            : threads_(thread_count)
-        {
-            for (auto& thd : threads_)
-                thd = std::thread{[this] { run(); }};
-        }
+        thd_pool.submit([&thd_pool, i] {
+            auto blocking = thd_pool.blocking_section(); // background_work sleeps most of the time
+            background_work(i, "ELASTIC", 50ms);
+        });
+    }
 
-        ThreadPool(const ThreadPool&) = delete;
-        ThreadPool& operator=(const ThreadPool&) = delete;
+    std::this_thread::sleep_for(100ms);
+    sync_cout() << "Elastic pool - threads: " << thd_pool.thread_count() << "; blocked: " << thd_pool.blocked_count() << "\n";
+}
 
-        ~ThreadPool()
-        {
-            for (size_t i = 0; i < threads_.size(); ++i)
-            {
-                // sending poisoning pill
-                tasks_.push(Task{});
-            }
+// repeated requests for one key share a single calculation
+void future_cache_demo()
+{
+    ThreadPool thd_pool(4);
+    FutureCache<int, int> squares{{.capacity = 16, .exceptions = ExceptionPolicy::retry}};
 
-            for (auto& thd : threads_)
-            {
-                if (thd.joinable())
-                    thd.join();
-            }
-        }
+    std::vector<std::tuple<int, std::shared_future<int>>> f_squares;
+    for (int n : {7, 8, 7, 9, 7, 8, 9})
+        f_squares.emplace_back(n, squares.get(n, thd_pool, [n] { return calculate_square(n); }));
 
-        void submit(Task task)
+    for (auto& [n, f_square] : f_squares)
+    {
+        try
         {
-            assert(task != nullptr && "Task cannot be empty");
-
-            tasks_.push(task);
+            int square = f_square.get();
+            sync_cout() << n << " * " << n << " = " << square << "\n";
         }
-
-    private:
-        ThreadSafeQueue<Task> tasks_;
-        std::vector<std::thread> threads_;
-
-        void run()
+        catch (const std::exception& e)
         {
-            while (true)
-            {
-                Task task;
-                tasks_.pop(task);
+            sync_cout() << "Exception for " << n << ": " << e.what() << "\n";
+        }
+    }
 
-                if (is_end_of_work(task))
-                    return;
+    // failed calculations are not cached - 9 is calculated again
+    squares.get(9, [] { return calculate_square(9); }).wait();
 
-                task(); // execution of task
-            }
-        }
+    const auto stats = squares.stats();
+    sync_cout() << "Square cache - requests: " << stats.requests() << "; calculations: " << stats.computations
+                << "; shared in flight: " << stats.joined << "; failures: " << stats.failures << "\n";
+}
 
-        bool is_end_of_work(Task task)
-        {
-            return task == nullptr;
-        }
-    };
-} // namespace ver_1
+// calculate_square reporting the failure as a value - nothing is thrown
+std::expected<int, std::string> try_calculate_square(int x)
+{
+    if (x % 3 == 0)
+        return std::unexpected("Error#3"s);
 
-inline namespace ver_2
+    return x * x;
+}
+
+void expected_results_demo()
 {
-    using Task = std::move_only_function<void()>; // since C++23
+    ThreadPool thd_pool(4);
 
-    class ThreadPool
-    {
-    public:
-        explicit ThreadPool(size_t thread_count)
-            : threads_(thread_count), end_of_work_{false}
-        {
-            for (auto& thd : threads_)
-                thd = std::thread{[this] { run(); }};
-        }
+    std::vector<std::tuple<int, std::future<std::expected<int, std::string>>>> f_squares;
+    for (int i = 10; i < 20; ++i)
+        f_squares.emplace_back(i, thd_pool.submit([i] { return try_calculate_square(i); }));
 
-        ThreadPool(const ThreadPool&) = delete;
-        ThreadPool& operator=(const ThreadPool&) = delete;
+    for (auto& [n, f_square] : f_squares)
+    {
+        auto square = f_square.get(); // failures are values - get() does not throw
+        if (square)
+            sync_cout() << n << " * " << n << " = " << *square << "\n";
+        else
+            sync_cout() << "Error for " << n << ": " << square.error() << "\n";
+    }
+}
 
-        ~ThreadPool()
+// heat spreading along a rod with hot ends - Jacobi iterations until no cell changes by more than epsilon
+void worker_team_demo()
+{
+    constexpr double epsilon = 1e-4;
+    std::vector<double> current(64, 0.0);
+    current.front() = current.back() = 100.0;
+    std::vector<double> next = current;
+
+    WorkerTeam team{4};
+    size_t iterations = 0;
+    const std::vector<double>* converged = &current; // buffers are swapped per iteration - the last one written
+    team.run([&](WorkerTeam::Member& member) {
+        const auto [first, last] = member.range(current.size());
+        auto* cur = &current;
+        auto* nxt = &next;
+        for (double delta = epsilon + 1; delta > epsilon; std::swap(cur, nxt))
         {
-            for (size_t i = 0; i < threads_.size(); ++i)
-            {
-                tasks_.push([this] { this->end_of_work_ = true; });
-            }
-
-            for (auto& thd : threads_)
+            double local_delta = 0.0;
+            for (size_t i = std::max<size_t>(first, 1); i < std::min(last, current.size() - 1); ++i)
             {
-                if (thd.joinable())
-                    thd.join();
+                (*nxt)[i] = ((*cur)[i - 1] + (*cur)[i + 1]) / 2;
+                local_delta = std::max(local_delta, std::abs((*nxt)[i] - (*cur)[i]));
             }
+            delta = member.reduce(local_delta, [](double a, double b) { return std::max(a, b); });
+            if (member.rank() == 0)
+                ++iterations;
         }
 
-        template <typename FunctionTask>        
-        auto submit(FunctionTask&& ftask)
-        {
-            using TResult = decltype(ftask());
-            std::packaged_task<TResult()> pt{std::move(ftask)};
-            std::future<TResult> f_result = pt.get_future();
-
-            auto task = [pt = std::move(pt)]() mutable { pt(); };
-            tasks_.push(std::move(task));
+        if (member.rank() == 0)
+            converged = cur; // swapped after the last iteration, too
+    });
 
-            return f_result;
-        }
-
-    private:
-        ThreadSafeQueue<Task> tasks_;
-        std::vector<std::thread> threads_;
-        std::atomic<bool> end_of_work_;
-
-        void run()
-        {
-            while (!end_of_work_)
-            {
-                Task task;
-                tasks_.pop(task);
-
-                task(); // execution of task
-            }
-        }
-    };
-} // namespace ver_1
+    sync_cout() << "Worker team - rod converged after " << iterations << " iterations; middle cell: " << (*converged)[converged->size() / 2] << "\n";
+}
 
 int main()
 {
+    Trace::Session trace{std::getenv("TRACE_FILE")}; // pool tasks & queue waits per worker
+
     std::cout << "Main thread starts..." << std::endl;
     const std::string text = "Hello Threads";
 
@@ -215,5 +209,14 @@ int main()
         }
     }
 
+    elastic_thread_pool_demo();
+
+    future_cache_demo();
+
+    worker_team_demo();
+
+    expected_results_demo();
+
+    ConsoleSink::console().flush(); // lines of the demos first
     std::cout << "Main thread ends..." << std::endl;
 }
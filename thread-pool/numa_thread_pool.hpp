@@ -0,0 +1,192 @@
+#ifndef NUMA_THREAD_POOL_HPP
+#define NUMA_THREAD_POOL_HPP
+
+#include "cache_line.hpp"
+#include "task_context.hpp"
+#include "thread_affinity.hpp"
+#include "thread_safe_queue.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <latch>
+#include <memory>
+#include <span>
+#include <thread>
+#include <utility>
+#include <vector>
+
+enum class WorkerPlacement
+{
+    unpinned, // OS scheduler decides - one shared queue
+    pinned    // worker bound to a core - one queue per NUMA node
+};
+
+class NumaThreadPool
+{
+public:
+    using Task = std::move_only_function<void()>;
+
+    static constexpr size_t default_scratch_size = 1024 * 1024;
+
+    explicit NumaThreadPool(size_t thread_count, WorkerPlacement placement = WorkerPlacement::pinned,
+        size_t scratch_size = default_scratch_size)
+        : NumaThreadPool(CpuTopology::detect(), thread_count, placement, scratch_size)
+    {
+    }
+
+    // returns when every worker is placed - pinned_count() is final
+    NumaThreadPool(CpuTopology topology, size_t thread_count, WorkerPlacement placement = WorkerPlacement::pinned,
+        size_t scratch_size = default_scratch_size)
+        : topology_{std::move(topology)}
+        , placement_{placement}
+        , workers_(thread_count)
+    {
+        assert(thread_count > 0);
+
+        // a node without workers gets no queue - nobody would pop its tasks
+        const size_t node_count = placement_ == WorkerPlacement::pinned ? std::min(topology_.node_count(), thread_count) : 1;
+        for (size_t node = 0; node < node_count; ++node)
+            queues_.push_back(make_queue(placement_ == WorkerPlacement::pinned ? topology_.node_cpus[node].front() : -1));
+
+        std::latch placed{static_cast<std::ptrdiff_t>(thread_count)};
+        for (size_t i = 0; i < workers_.size(); ++i)
+        {
+            Worker& worker = workers_[i];
+            worker.node = i % queues_.size();
+
+            const auto& cpus = topology_.node_cpus[worker.node];
+            worker.cpu = placement_ == WorkerPlacement::pinned ? cpus[(i / queues_.size()) % cpus.size()] : -1;
+
+            worker.thread = std::thread{[this, &worker, &placed, scratch_size] { run(worker, placed, scratch_size); }};
+        }
+        placed.wait();
+    }
+
+    NumaThreadPool(const NumaThreadPool&) = delete;
+    NumaThreadPool& operator=(const NumaThreadPool&) = delete;
+
+    ~NumaThreadPool()
+    {
+        for (const auto& worker : workers_)
+            queues_[worker.node]->push(Task{}); // poisoning pill for every worker of the node
+
+        for (auto& worker : workers_)
+        {
+            if (worker.thread.joinable())
+                worker.thread.join();
+        }
+    }
+
+    // tasks are spread round-robin over workers - a node gets a share proportional to its workers
+    template <typename FunctionTask>
+    auto submit(FunctionTask&& ftask)
+    {
+        const size_t worker = next_worker_.fetch_add(1, std::memory_order_relaxed) % workers_.size();
+        return submit(workers_[worker].node, std::forward<FunctionTask>(ftask));
+    }
+
+    template <typename FunctionTask>
+    auto submit(size_t node, FunctionTask&& ftask)
+    {
+        assert(node < queues_.size() && "Node has no workers - see node_count()");
+
+        using TResult = decltype(ftask());
+        std::packaged_task<TResult()> pt{std::forward<FunctionTask>(ftask)};
+        std::future<TResult> f_result = pt.get_future();
+
+        queues_[node]->push([pt = std::move(pt), context = TaskContext::capture()]() mutable {
+            ContextScope scope{std::move(context)};
+            pt();
+        });
+
+        return f_result;
+    }
+
+    // nodes with workers - at most thread_count
+    size_t node_count() const
+    {
+        return queues_.size();
+    }
+
+    // workers bound to their cpu - pinning may be refused (cgroups, offline cpus)
+    size_t pinned_count() const
+    {
+        return static_cast<size_t>(std::ranges::count_if(workers_, [](const Worker& worker) { return worker.cpu >= 0; }));
+    }
+
+    const CpuTopology& topology() const
+    {
+        return topology_;
+    }
+
+    // scratch memory of the calling worker - allocated and first touched on the worker's own node
+    static std::span<std::byte> worker_scratch()
+    {
+        assert(current_worker_ != nullptr && "Must be called from a pool task");
+        return {current_worker_->scratch.get(), current_worker_->scratch_size};
+    }
+
+private:
+    struct alignas(cache_line_size) Worker
+    {
+        std::thread thread;
+        size_t node = 0;
+        int cpu = -1;
+        std::unique_ptr<std::byte[]> scratch;
+        size_t scratch_size = 0;
+    };
+
+    CpuTopology topology_;
+    WorkerPlacement placement_;
+    std::vector<std::unique_ptr<ThreadSafeQueue<Task>>> queues_;
+    std::vector<Worker> workers_;
+    std::atomic<size_t> next_worker_{0};
+
+    inline static thread_local Worker* current_worker_ = nullptr;
+
+    // first-touch policy: pages are placed on the node of the thread that writes them first,
+    // so the queue and its lock are constructed by a thread running on the node
+    static std::unique_ptr<ThreadSafeQueue<Task>> make_queue(int cpu)
+    {
+        if (cpu < 0)
+            return std::make_unique<ThreadSafeQueue<Task>>();
+
+        std::unique_ptr<ThreadSafeQueue<Task>> queue;
+        std::thread{[&queue, cpu] {
+            pin_current_thread(cpu);
+            queue = std::make_unique<ThreadSafeQueue<Task>>();
+        }}.join();
+        return queue;
+    }
+
+    void run(Worker& worker, std::latch& placed, size_t scratch_size)
+    {
+        if (worker.cpu >= 0 && !pin_current_thread(worker.cpu))
+            worker.cpu = -1; // runs wherever the OS puts it - still serves the queue of its node
+
+        // first touch by the worker - on its own node
+        worker.scratch = std::make_unique<std::byte[]>(scratch_size);
+        worker.scratch_size = scratch_size;
+        current_worker_ = &worker;
+        placed.count_down();
+
+        ThreadSafeQueue<Task>& tasks = *queues_[worker.node];
+
+        while (true)
+        {
+            Task task;
+            tasks.pop(task);
+
+            if (task == nullptr)
+                return;
+
+            task(); // execution of task
+        }
+    }
+};
+
+#endif // NUMA_THREAD_POOL_HPP
@@ -0,0 +1,193 @@
+#ifndef ORDERED_LOCK_HPP
+#define ORDERED_LOCK_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// checks of the lock hierarchy - on in debug builds, can be forced with -DORDERED_LOCK_CHECKS=0/1
+#ifndef ORDERED_LOCK_CHECKS
+#ifdef NDEBUG
+#define ORDERED_LOCK_CHECKS 0
+#else
+#define ORDERED_LOCK_CHECKS 1
+#endif
+#endif
+
+// thrown (debug mode) when a thread locks a mutex with a rank not greater than a rank it already holds
+class LockOrderViolation : public std::logic_error
+{
+public:
+    using std::logic_error::logic_error;
+};
+
+namespace LockOrdering
+{
+    namespace details
+    {
+        struct HeldLock
+        {
+            const void* mutex;
+            uint64_t rank;
+        };
+
+        inline std::vector<HeldLock>& held_locks()
+        {
+            static thread_local std::vector<HeldLock> held;
+            return held;
+        }
+
+        inline bool is_held(const void* mutex)
+        {
+            return std::ranges::any_of(held_locks(), [mutex](const HeldLock& h) { return h.mutex == mutex; });
+        }
+
+        // before blocking - catches a wrong order even when it does not deadlock this time
+        inline void check_order(const void* mutex, uint64_t rank)
+        {
+            const auto& held = held_locks();
+            if (held.empty() || is_held(mutex)) // re-locking a recursive mutex is fine
+                return;
+
+            const uint64_t highest = std::ranges::max(held, {}, &HeldLock::rank).rank;
+            if (rank <= highest)
+                throw LockOrderViolation{"lock of rank " + std::to_string(rank) + " requested while holding rank " + std::to_string(highest)};
+        }
+
+        inline void on_locked(const void* mutex, uint64_t rank)
+        {
+            held_locks().push_back(HeldLock{mutex, rank});
+        }
+
+        inline void on_unlocked(const void* mutex)
+        {
+            auto& held = held_locks();
+            const auto it = std::find_if(held.rbegin(), held.rend(), [mutex](const HeldLock& h) { return h.mutex == mutex; });
+            if (it != held.rend())
+                held.erase(std::next(it).base());
+        }
+    } // namespace details
+} // namespace LockOrdering
+
+// Lockable with a rank in the global lock hierarchy (e.g. account id) - mutexes must be locked
+// in increasing rank order. OrderedLock does that for a set of mutexes.
+template <typename M = std::mutex>
+class RankedMutex
+{
+public:
+    explicit RankedMutex(uint64_t rank)
+        : rank_{rank}
+    {
+    }
+
+    RankedMutex(const RankedMutex&) = delete;
+    RankedMutex& operator=(const RankedMutex&) = delete;
+
+    uint64_t rank() const noexcept
+    {
+        return rank_;
+    }
+
+    void lock()
+    {
+#if ORDERED_LOCK_CHECKS
+        LockOrdering::details::check_order(this, rank_);
+#endif
+        mtx_.lock();
+#if ORDERED_LOCK_CHECKS
+        LockOrdering::details::on_locked(this, rank_);
+#endif
+    }
+
+    bool try_lock()
+    {
+        if (!mtx_.try_lock())
+            return false; // try_lock never deadlocks - any order is fine
+#if ORDERED_LOCK_CHECKS
+        LockOrdering::details::on_locked(this, rank_);
+#endif
+        return true;
+    }
+
+    void unlock()
+    {
+#if ORDERED_LOCK_CHECKS
+        LockOrdering::details::on_unlocked(this);
+#endif
+        mtx_.unlock();
+    }
+
+private:
+    M mtx_;
+    const uint64_t rank_;
+};
+
+// RAII - locks N ranked mutexes in increasing rank order, one after another: no try-and-back-off
+// rounds as in std::scoped_lock. Ranks of different mutexes must differ; the same mutex passed
+// twice (e.g. transfer to self) is locked once.
+template <typename TMutex, size_t N>
+class [[nodiscard]] OrderedLock
+{
+public:
+    template <typename... TMutexes>
+        requires(sizeof...(TMutexes) == N)
+    explicit OrderedLock(TMutexes&... mutexes)
+        : mutexes_{&mutexes...}
+    {
+        std::ranges::sort(mutexes_, [](TMutex* a, TMutex* b) {
+            return a->rank() != b->rank() ? a->rank() < b->rank() : std::less<>{}(a, b);
+        });
+
+        for (size_t i = 0; i < N; ++i)
+        {
+            if (is_duplicate(i))
+                continue;
+
+            try
+            {
+                mutexes_[i]->lock();
+            }
+            catch (...)
+            {
+                unlock_first(i);
+                throw;
+            }
+        }
+    }
+
+    OrderedLock(const OrderedLock&) = delete;
+    OrderedLock& operator=(const OrderedLock&) = delete;
+
+    ~OrderedLock()
+    {
+        unlock_first(N);
+    }
+
+private:
+    std::array<TMutex*, N> mutexes_;
+
+    bool is_duplicate(size_t i) const
+    {
+        return i > 0 && mutexes_[i] == mutexes_[i - 1];
+    }
+
+    // reverse order of locking
+    void unlock_first(size_t count)
+    {
+        for (size_t i = count; i-- > 0;)
+        {
+            if (!is_duplicate(i))
+                mutexes_[i]->unlock();
+        }
+    }
+};
+
+template <typename TMutex, typename... TMutexes>
+OrderedLock(TMutex&, TMutexes&...) -> OrderedLock<TMutex, 1 + sizeof...(TMutexes)>;
+
+#endif // ORDERED_LOCK_HPP
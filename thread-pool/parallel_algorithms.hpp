@@ -0,0 +1,200 @@
+#ifndef PARALLEL_ALGORITHMS_HPP
+#define PARALLEL_ALGORITHMS_HPP
+
+#include "spin_lock.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <iterator>
+#include <numeric>
+#include <ranges>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Parallel algorithms running on a thread pool (ThreadPool or any pool with
+// submit(), size() and try_run_pending_task()). Ranges are split recursively in halves
+// until they are not larger than grain_size; grain_size == 0 picks ~8 chunks per worker.
+// A thread waiting for its half of the work runs queued tasks meanwhile, so nested
+// calls from pool tasks do not deadlock.
+namespace parallel
+{
+    namespace details
+    {
+        template <typename TPool>
+        size_t grain_size_for(const TPool& pool, size_t size, size_t grain_size, size_t min_grain_size = 1)
+        {
+            if (grain_size == 0)
+                grain_size = size / (8 * std::max<size_t>(pool.size(), 1));
+
+            return std::max(grain_size, min_grain_size);
+        }
+
+        template <typename TPool, typename TFuture>
+        auto get_helping(TPool& pool, TFuture& future)
+        {
+            Backoff backoff; // short pauses first - the other half is often about to finish
+            while (future.wait_for(std::chrono::seconds{0}) != std::future_status::ready)
+            {
+                if (pool.try_run_pending_task())
+                    backoff.reset();
+                else
+                    backoff.pause();
+            }
+
+            return future.get(); // rethrows exception from the other half
+        }
+
+        // runs the right half on this thread; the left half (submitted before) uses the same callables and
+        // the caller's data, so it is waited for even when the right half throws - the first exception wins
+        template <typename TPool, typename TFuture, typename F>
+        decltype(auto) run_right_half(TPool& pool, TFuture& left_half, F&& right_half)
+        {
+            try
+            {
+                return std::forward<F>(right_half)();
+            }
+            catch (...)
+            {
+                try
+                {
+                    get_helping(pool, left_half);
+                }
+                catch (...)
+                {
+                }
+                throw;
+            }
+        }
+
+        template <typename TPool, typename It, typename F>
+        void for_each(TPool& pool, It first, It last, F& f, size_t grain_size)
+        {
+            const auto size = static_cast<size_t>(last - first);
+            if (size <= grain_size)
+            {
+                std::for_each(first, last, std::ref(f));
+                return;
+            }
+
+            const It middle = first + size / 2;
+            auto left_half = pool.submit([&pool, first, middle, &f, grain_size] { details::for_each(pool, first, middle, f, grain_size); });
+            run_right_half(pool, left_half, [&] { details::for_each(pool, middle, last, f, grain_size); });
+            get_helping(pool, left_half);
+        }
+
+        // non-empty range - result does not include init
+        template <typename T, typename TPool, typename It, typename TReduce, typename TTransform>
+        T transform_reduce(TPool& pool, It first, It last, TReduce& reduce, TTransform& transform, size_t grain_size)
+        {
+            const auto size = static_cast<size_t>(last - first);
+            if (size <= grain_size)
+            {
+                T result = transform(*first);
+                for (++first; first != last; ++first)
+                    result = reduce(std::move(result), transform(*first));
+                return result;
+            }
+
+            const It middle = first + size / 2;
+            auto left_half = pool.submit([&pool, first, middle, &reduce, &transform, grain_size] {
+                return details::transform_reduce<T>(pool, first, middle, reduce, transform, grain_size);
+            });
+            T right = run_right_half(pool, left_half, [&] { return details::transform_reduce<T>(pool, middle, last, reduce, transform, grain_size); });
+            T left = get_helping(pool, left_half);
+
+            return reduce(std::move(left), std::move(right));
+        }
+
+        template <typename TPool, typename It, typename TCompare>
+        void sort(TPool& pool, It first, It last, TCompare& comp, size_t grain_size)
+        {
+            const auto size = static_cast<size_t>(last - first);
+            if (size <= grain_size)
+            {
+                std::sort(first, last, std::ref(comp));
+                return;
+            }
+
+            const It middle = first + size / 2;
+            auto left_half = pool.submit([&pool, first, middle, &comp, grain_size] { details::sort(pool, first, middle, comp, grain_size); });
+            run_right_half(pool, left_half, [&] { details::sort(pool, middle, last, comp, grain_size); });
+            get_helping(pool, left_half);
+
+            std::inplace_merge(first, middle, last, std::ref(comp));
+        }
+    } // namespace details
+
+    template <typename TPool, std::random_access_iterator It, typename F>
+    void for_each(TPool& pool, It first, It last, F f, size_t grain_size = 0)
+    {
+        const auto size = static_cast<size_t>(last - first);
+        details::for_each(pool, first, last, f, details::grain_size_for(pool, size, grain_size));
+    }
+
+    template <typename TPool, std::random_access_iterator It, typename T, typename TReduce, typename TTransform>
+    T transform_reduce(TPool& pool, It first, It last, T init, TReduce reduce, TTransform transform, size_t grain_size = 0)
+    {
+        if (first == last)
+            return init;
+
+        const auto size = static_cast<size_t>(last - first);
+        T result = details::transform_reduce<T>(pool, first, last, reduce, transform, details::grain_size_for(pool, size, grain_size));
+
+        return reduce(std::move(init), std::move(result));
+    }
+
+    template <typename TPool, std::random_access_iterator It, typename T, typename TReduce = std::plus<>>
+    T reduce(TPool& pool, It first, It last, T init, TReduce op = {}, size_t grain_size = 0)
+    {
+        return parallel::transform_reduce(pool, first, last, std::move(init), op, std::identity{}, grain_size);
+    }
+
+    // three phases: scan of every chunk, serial scan of chunk totals, offsetting chunks 1..n-1
+    template <typename TPool, std::random_access_iterator It, std::random_access_iterator OutIt, typename TOp = std::plus<>>
+    OutIt inclusive_scan(TPool& pool, It first, It last, OutIt d_first, TOp op = {}, size_t grain_size = 0)
+    {
+        const auto size = static_cast<size_t>(last - first);
+        grain_size = details::grain_size_for(pool, size, grain_size);
+
+        if (size <= grain_size)
+            return std::inclusive_scan(first, last, d_first, op);
+
+        const size_t chunk_count = (size + grain_size - 1) / grain_size;
+        const auto chunks = std::views::iota(size_t{0}, chunk_count);
+
+        auto chunk_begin = [=](size_t chunk) { return chunk * grain_size; };
+        auto chunk_end = [=](size_t chunk) { return std::min(size, (chunk + 1) * grain_size); };
+
+        parallel::for_each(pool, chunks.begin(), chunks.end(), [&](size_t chunk) {
+            std::inclusive_scan(first + chunk_begin(chunk), first + chunk_end(chunk), d_first + chunk_begin(chunk), op);
+        }, 1);
+
+        using T = std::iter_value_t<OutIt>;
+        std::vector<T> offsets;
+        offsets.reserve(chunk_count - 1);
+        offsets.push_back(d_first[chunk_end(0) - 1]);
+        for (size_t chunk = 1; chunk + 1 < chunk_count; ++chunk)
+            offsets.push_back(op(offsets.back(), d_first[chunk_end(chunk) - 1]));
+
+        parallel::for_each(pool, chunks.begin() + 1, chunks.end(), [&](size_t chunk) {
+            const T& offset = offsets[chunk - 1];
+            for (auto it = d_first + chunk_begin(chunk); it != d_first + chunk_end(chunk); ++it)
+                *it = op(offset, *it);
+        }, 1);
+
+        return d_first + size;
+    }
+
+    // merge sort - halves are sorted in parallel and merged by the thread that split them
+    template <typename TPool, std::random_access_iterator It, typename TCompare = std::less<>>
+    void sort(TPool& pool, It first, It last, TCompare comp = {}, size_t grain_size = 0)
+    {
+        const auto size = static_cast<size_t>(last - first);
+        details::sort(pool, first, last, comp, details::grain_size_for(pool, size, grain_size, 1024));
+    }
+} // namespace parallel
+
+#endif // PARALLEL_ALGORITHMS_HPP
@@ -0,0 +1,668 @@
+#ifndef PIPELINE_HPP
+#define PIPELINE_HPP
+
+#include "bounded_queue.hpp"
+#include "trace_recorder.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <future>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Streaming pipelines: a source, any number of map/filter stages and a sink, connected by bounded queues.
+//
+//   auto report = Pipeline::source({.batch_size = 1024}, read_line)
+//                     .map({.name = "parse", .parallelism = 4}, parse)
+//                     .filter({.name = "filter"}, is_valid)
+//                     .sink({.name = "sum"}, [&](int x) { sum += x; })
+//                     .run(pool);
+//
+// Items travel in batches, so queue operations are amortized over batch_size items. Every worker of every
+// stage is a long-running pool task - the pool needs at least as many threads as the pipeline has workers.
+// A full queue blocks the stage feeding it, so a slow stage throttles everything upstream (backpressure).
+// Order::preserved stages deliver their outputs in the order of their inputs even with several workers;
+// Order::unordered stages pass batches on as soon as they are done.
+// Stage functions are called concurrently by the stage's workers (and must be const-callable);
+// an exception thrown by any of them aborts the pipeline and is rethrown by run().
+namespace Pipeline
+{
+    enum class Order
+    {
+        preserved,
+        unordered
+    };
+
+    struct SourceOptions
+    {
+        std::string name = "source";
+        size_t batch_size = 1024;
+    };
+
+    struct StageOptions
+    {
+        std::string name = "stage";
+        size_t parallelism = 1;
+        Order order = Order::preserved;
+        size_t queue_capacity = 16; // input queue, in batches
+    };
+
+    struct StageStats
+    {
+        std::string name;
+        size_t parallelism = 1;
+        uint64_t items_in = 0;
+        uint64_t items_out = 0;
+        std::chrono::nanoseconds busy{0};    // summed over the workers
+        std::chrono::nanoseconds blocked{0}; // waiting for room in the downstream queue - backpressure
+        size_t queue_capacity = 0;           // input queue (none for the source)
+        size_t max_queue_depth = 0;
+        double mean_queue_depth = 0;         // sampled at every push
+    };
+
+    struct Report
+    {
+        std::chrono::nanoseconds elapsed{0};
+        std::vector<StageStats> stages;
+    };
+
+    inline std::ostream& operator<<(std::ostream& out, const Report& report)
+    {
+        using namespace std::chrono;
+        const double seconds = duration<double>(report.elapsed).count();
+
+        out << "pipeline: " << duration_cast<milliseconds>(report.elapsed) << "\n";
+        for (const auto& stage : report.stages)
+        {
+            out << "  " << std::left << std::setw(10) << stage.name << std::right << " x" << stage.parallelism << ": in "
+                << stage.items_in << ", out " << stage.items_out << ", " << std::fixed << std::setprecision(1)
+                << std::max(stage.items_in, stage.items_out) / seconds / 1e6 << "M items/s, busy "
+                << 100.0 * duration<double>(stage.busy).count() / (seconds * stage.parallelism) << "%, blocked "
+                << duration_cast<milliseconds>(stage.blocked);
+            if (stage.queue_capacity > 0)
+                out << ", queue max " << stage.max_queue_depth << "/" << stage.queue_capacity << " mean " << stage.mean_queue_depth;
+            out << "\n";
+        }
+        return out;
+    }
+
+    namespace Details
+    {
+        using Clock = std::chrono::steady_clock;
+
+        template <typename T>
+        struct Batch
+        {
+            uint64_t sequence = 0;
+            std::vector<T> items;
+        };
+
+        // queue between two stages - closed when the last worker of the producing stage is done
+        template <typename T>
+        class Edge
+        {
+            BoundedQueue<Batch<T>> queue_;
+            std::atomic<size_t> producers_{1};
+            std::atomic<uint64_t> pushes_{0};
+            std::atomic<uint64_t> depth_sum_{0};
+            std::atomic<size_t> max_depth_{0};
+
+        public:
+            explicit Edge(size_t capacity)
+                : queue_{capacity}
+            {
+            }
+
+            void set_producers(size_t count)
+            {
+                producers_.store(count, std::memory_order_relaxed);
+            }
+
+            // false when the pipeline has been aborted
+            bool push(Batch<T>&& batch, std::chrono::nanoseconds& blocked)
+            {
+                if (!queue_.try_push(std::move(batch)))
+                {
+                    const auto start = Clock::now();
+                    if (!queue_.push(std::move(batch)))
+                        return false;
+                    blocked += Clock::now() - start;
+                }
+
+                const size_t depth = queue_.size();
+                pushes_.fetch_add(1, std::memory_order_relaxed);
+                depth_sum_.fetch_add(depth, std::memory_order_relaxed);
+                for (size_t max = max_depth_.load(std::memory_order_relaxed);
+                     depth > max && !max_depth_.compare_exchange_weak(max, depth, std::memory_order_relaxed);)
+                {
+                }
+                return true;
+            }
+
+            std::optional<Batch<T>> pop()
+            {
+                return queue_.pop();
+            }
+
+            void producer_done()
+            {
+                if (producers_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                    queue_.close();
+            }
+
+            void abort()
+            {
+                queue_.close();
+            }
+
+            void fill(StageStats& stats) const
+            {
+                const auto pushes = pushes_.load(std::memory_order_relaxed);
+                stats.queue_capacity = queue_.capacity();
+                stats.max_queue_depth = max_depth_.load(std::memory_order_relaxed);
+                stats.mean_queue_depth = pushes ? static_cast<double>(depth_sum_.load(std::memory_order_relaxed)) / pushes : 0.0;
+            }
+        };
+
+        // passes batches on in sequence order (preserved) or as they come (unordered)
+        template <typename T>
+        class Sequencer
+        {
+            const Order order_;
+            std::mutex mtx_;
+            uint64_t next_ = 0;
+            std::map<uint64_t, std::vector<T>> pending_; // finished out of order
+
+        public:
+            explicit Sequencer(Order order)
+                : order_{order}
+            {
+            }
+
+            // deliver(std::vector<T>&&) -> bool; false as soon as a delivery fails
+            template <typename F>
+            bool release(uint64_t sequence, std::vector<T>&& items, F&& deliver)
+            {
+                if (order_ == Order::unordered)
+                    return deliver(std::move(items));
+
+                std::lock_guard lk{mtx_};
+                if (sequence != next_)
+                {
+                    pending_.emplace(sequence, std::move(items));
+                    return true;
+                }
+
+                if (!deliver(std::move(items)))
+                    return false;
+                ++next_;
+
+                for (auto it = pending_.begin(); it != pending_.end() && it->first == next_; it = pending_.erase(it), ++next_)
+                {
+                    if (!deliver(std::move(it->second)))
+                        return false;
+                }
+                return true;
+            }
+        };
+
+        // output side of a stage - batch sequence numbers are dense on every edge (empty batches are dropped)
+        template <typename T>
+        class Emitter
+        {
+            Edge<T>* output_ = nullptr;
+            std::atomic<uint64_t> next_sequence_{0};
+
+        public:
+            void connect(Edge<T>& output, size_t producers)
+            {
+                output.set_producers(producers);
+                output_ = &output;
+            }
+
+            bool emit(std::vector<T>&& items, std::chrono::nanoseconds& blocked)
+            {
+                assert(output_ != nullptr && "pipeline has no sink");
+                if (items.empty())
+                    return true;
+                return output_->push(Batch<T>{next_sequence_.fetch_add(1, std::memory_order_relaxed), std::move(items)}, blocked);
+            }
+
+            void done()
+            {
+                output_->producer_done();
+            }
+        };
+
+        class StageBase
+        {
+        public:
+            explicit StageBase(std::string name, size_t parallelism)
+                : name_{std::move(name)}
+                , trace_name_{Trace::intern(name_)}
+                , parallelism_{std::max<size_t>(parallelism, 1)}
+            {
+            }
+
+            virtual ~StageBase() = default;
+
+            size_t parallelism() const
+            {
+                return parallelism_;
+            }
+
+            // one worker - returns when the input is drained or the pipeline is aborted
+            virtual void work(const std::atomic<bool>& aborted) = 0;
+
+            // unblocks workers waiting on the stage's input queue
+            virtual void abort() = 0;
+
+            virtual StageStats stats() const
+            {
+                StageStats stats;
+                stats.name = name_;
+                stats.parallelism = parallelism_;
+                stats.items_in = items_in_.load(std::memory_order_relaxed);
+                stats.items_out = items_out_.load(std::memory_order_relaxed);
+                stats.busy = std::chrono::nanoseconds{busy_ns_.load(std::memory_order_relaxed)};
+                stats.blocked = std::chrono::nanoseconds{blocked_ns_.load(std::memory_order_relaxed)};
+                return stats;
+            }
+
+        protected:
+            const std::string name_;
+            const char* const trace_name_; // outlives the stage - events are written when the trace session ends
+
+            void account(uint64_t items_in, uint64_t items_out, Clock::duration busy)
+            {
+                items_in_.fetch_add(items_in, std::memory_order_relaxed);
+                items_out_.fetch_add(items_out, std::memory_order_relaxed);
+                busy_ns_.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(busy).count(), std::memory_order_relaxed);
+            }
+
+            void account_blocked(std::chrono::nanoseconds blocked)
+            {
+                blocked_ns_.fetch_add(blocked.count(), std::memory_order_relaxed);
+            }
+
+        private:
+            const size_t parallelism_;
+            std::atomic<uint64_t> items_in_{0};
+            std::atomic<uint64_t> items_out_{0};
+            std::atomic<uint64_t> busy_ns_{0};
+            std::atomic<uint64_t> blocked_ns_{0};
+        };
+
+        template <typename T, typename TGenerator>
+        class SourceStage : public StageBase
+        {
+            TGenerator generate_;
+            const size_t batch_size_;
+            Emitter<T> emitter_;
+
+        public:
+            SourceStage(SourceOptions options, TGenerator generate)
+                : StageBase{std::move(options.name), 1}
+                , generate_{std::move(generate)}
+                , batch_size_{std::max<size_t>(options.batch_size, 1)}
+            {
+            }
+
+            Emitter<T>& emitter()
+            {
+                return emitter_;
+            }
+
+            void work(const std::atomic<bool>& aborted) override
+            {
+                std::chrono::nanoseconds blocked{0};
+                for (bool end_of_stream = false; !end_of_stream && !aborted.load(std::memory_order_relaxed);)
+                {
+                    Trace::Scope trace{trace_name_};
+                    const auto start = Clock::now();
+
+                    std::vector<T> batch;
+                    batch.reserve(batch_size_);
+                    while (batch.size() < batch_size_)
+                    {
+                        std::optional<T> item = generate_();
+                        if (!item)
+                        {
+                            end_of_stream = true;
+                            break;
+                        }
+                        batch.push_back(std::move(*item));
+                    }
+
+                    const size_t count = batch.size();
+                    account(0, count, Clock::now() - start);
+                    if (!emitter_.emit(std::move(batch), blocked))
+                        break;
+                }
+
+                account_blocked(blocked);
+                emitter_.done();
+            }
+
+            void abort() override
+            {
+            }
+        };
+
+        // TKernel(std::vector<In>&, std::vector<Out>&) - processes a whole batch
+        template <typename In, typename Out, typename TKernel>
+        class TransformStage : public StageBase
+        {
+            Edge<In> input_;
+            const TKernel kernel_;
+            Sequencer<Out> sequencer_;
+            Emitter<Out> emitter_;
+
+        public:
+            TransformStage(StageOptions options, TKernel kernel)
+                : StageBase{std::move(options.name), options.parallelism}
+                , input_{options.queue_capacity}
+                , kernel_{std::move(kernel)}
+                , sequencer_{options.order}
+            {
+            }
+
+            Edge<In>& input()
+            {
+                return input_;
+            }
+
+            Emitter<Out>& emitter()
+            {
+                return emitter_;
+            }
+
+            void work(const std::atomic<bool>& aborted) override
+            {
+                std::chrono::nanoseconds blocked{0};
+                while (!aborted.load(std::memory_order_relaxed))
+                {
+                    std::optional<Batch<In>> batch = input_.pop();
+                    if (!batch)
+                        break;
+
+                    std::vector<Out> results;
+                    {
+                        Trace::Scope trace{trace_name_};
+                        const auto start = Clock::now();
+                        results.reserve(batch->items.size());
+                        kernel_(batch->items, results);
+                        account(batch->items.size(), results.size(), Clock::now() - start);
+                    }
+
+                    const bool delivered = sequencer_.release(batch->sequence, std::move(results),
+                        [&](std::vector<Out>&& items) { return emitter_.emit(std::move(items), blocked); });
+                    if (!delivered)
+                        break;
+                }
+
+                account_blocked(blocked);
+                emitter_.done();
+            }
+
+            void abort() override
+            {
+                input_.abort();
+            }
+
+            StageStats stats() const override
+            {
+                StageStats stats = StageBase::stats();
+                input_.fill(stats);
+                return stats;
+            }
+        };
+
+        // TConsumer(In&&) - called in sequence order under a lock when the order is preserved
+        template <typename In, typename TConsumer>
+        class SinkStage : public StageBase
+        {
+            Edge<In> input_;
+            const TConsumer consume_;
+            Sequencer<In> sequencer_;
+
+        public:
+            SinkStage(StageOptions options, TConsumer consume)
+                : StageBase{std::move(options.name), options.parallelism}
+                , input_{options.queue_capacity}
+                , consume_{std::move(consume)}
+                , sequencer_{options.order}
+            {
+            }
+
+            Edge<In>& input()
+            {
+                return input_;
+            }
+
+            void work(const std::atomic<bool>& aborted) override
+            {
+                while (!aborted.load(std::memory_order_relaxed))
+                {
+                    std::optional<Batch<In>> batch = input_.pop();
+                    if (!batch)
+                        break;
+
+                    const size_t count = batch->items.size();
+                    Trace::Scope trace{trace_name_};
+                    const auto start = Clock::now();
+                    sequencer_.release(batch->sequence, std::move(batch->items), [this](std::vector<In>&& items) {
+                        for (auto& item : items)
+                            consume_(std::move(item));
+                        return true;
+                    });
+                    account(count, 0, Clock::now() - start);
+                }
+            }
+
+            void abort() override
+            {
+                input_.abort();
+            }
+
+            StageStats stats() const override
+            {
+                StageStats stats = StageBase::stats();
+                input_.fill(stats);
+                return stats;
+            }
+        };
+
+        class Graph
+        {
+        public:
+            std::vector<std::unique_ptr<StageBase>> stages;
+            std::atomic<bool> aborted{false};
+
+            void abort()
+            {
+                aborted.store(true, std::memory_order_relaxed);
+                for (auto& stage : stages)
+                    stage->abort();
+            }
+        };
+    } // namespace Details
+
+    class Runnable
+    {
+        std::unique_ptr<Details::Graph> graph_;
+        bool started_ = false;
+
+    public:
+        explicit Runnable(std::unique_ptr<Details::Graph> graph)
+            : graph_{std::move(graph)}
+        {
+        }
+
+        size_t worker_count() const
+        {
+            size_t count = 0;
+            for (const auto& stage : graph_->stages)
+                count += stage->parallelism();
+            return count;
+        }
+
+        // blocks until the sink has consumed the whole stream; TPool - submit(callable) returning std::future, size()
+        template <typename TPool>
+        Report run(TPool& pool)
+        {
+            assert(!started_ && "a pipeline runs only once");
+            started_ = true;
+
+            if (pool.size() < worker_count())
+                throw std::invalid_argument("pipeline needs " + std::to_string(worker_count()) + " pool threads, pool has "
+                    + std::to_string(pool.size()));
+
+            const auto start = Details::Clock::now();
+
+            std::vector<std::future<void>> workers;
+            for (auto& stage : graph_->stages)
+            {
+                for (size_t i = 0; i < stage->parallelism(); ++i)
+                {
+                    workers.push_back(pool.submit([graph = graph_.get(), stage = stage.get()] {
+                        try
+                        {
+                            stage->work(graph->aborted);
+                        }
+                        catch (...)
+                        {
+                            graph->abort();
+                            throw;
+                        }
+                    }));
+                }
+            }
+
+            std::exception_ptr error;
+            for (auto& worker : workers)
+            {
+                try
+                {
+                    worker.get();
+                }
+                catch (...)
+                {
+                    if (!error)
+                        error = std::current_exception();
+                }
+            }
+
+            if (error)
+                std::rethrow_exception(error);
+
+            Report report;
+            report.elapsed = Details::Clock::now() - start;
+            for (const auto& stage : graph_->stages)
+                report.stages.push_back(stage->stats());
+            return report;
+        }
+    };
+
+    // a pipeline under construction - its last stage produces T
+    template <typename T>
+    class Flow
+    {
+        std::unique_ptr<Details::Graph> graph_;
+        Details::Emitter<T>* tail_;
+        size_t tail_parallelism_;
+
+        template <typename U>
+        friend class Flow;
+
+        template <typename U, typename TGenerator>
+        friend Flow<U> make_source(SourceOptions, TGenerator);
+
+        Flow(std::unique_ptr<Details::Graph> graph, Details::Emitter<T>& tail, size_t tail_parallelism)
+            : graph_{std::move(graph)}
+            , tail_{&tail}
+            , tail_parallelism_{tail_parallelism}
+        {
+        }
+
+        template <typename Out, typename TKernel>
+        Flow<Out> add_transform(StageOptions options, TKernel kernel) &&
+        {
+            auto stage = std::make_unique<Details::TransformStage<T, Out, TKernel>>(std::move(options), std::move(kernel));
+            tail_->connect(stage->input(), tail_parallelism_);
+
+            auto& emitter = stage->emitter();
+            const size_t parallelism = stage->parallelism();
+            graph_->stages.push_back(std::move(stage));
+            return Flow<Out>{std::move(graph_), emitter, parallelism};
+        }
+
+    public:
+        // f(T&&) -> Out
+        template <typename F>
+        auto map(StageOptions options, F f) &&
+        {
+            using Out = std::remove_cvref_t<std::invoke_result_t<const F&, T&&>>;
+            return std::move(*this).template add_transform<Out>(std::move(options), [f = std::move(f)](std::vector<T>& in, std::vector<Out>& out) {
+                for (auto& item : in)
+                    out.push_back(f(std::move(item)));
+            });
+        }
+
+        // predicate(const T&) -> bool; drops the items failing it
+        template <typename F>
+        Flow<T> filter(StageOptions options, F predicate) &&
+        {
+            return std::move(*this).template add_transform<T>(std::move(options), [predicate = std::move(predicate)](std::vector<T>& in, std::vector<T>& out) {
+                for (auto& item : in)
+                {
+                    if (predicate(std::as_const(item)))
+                        out.push_back(std::move(item));
+                }
+            });
+        }
+
+        // consume(T&&) - with several unordered workers it must be thread-safe
+        template <typename F>
+        Runnable sink(StageOptions options, F consume) &&
+        {
+            auto stage = std::make_unique<Details::SinkStage<T, F>>(std::move(options), std::move(consume));
+            tail_->connect(stage->input(), tail_parallelism_);
+            graph_->stages.push_back(std::move(stage));
+            return Runnable{std::move(graph_)};
+        }
+    };
+
+    template <typename T, typename TGenerator>
+    Flow<T> make_source(SourceOptions options, TGenerator generate)
+    {
+        auto graph = std::make_unique<Details::Graph>();
+        auto stage = std::make_unique<Details::SourceStage<T, TGenerator>>(std::move(options), std::move(generate));
+        auto& emitter = stage->emitter();
+        graph->stages.push_back(std::move(stage));
+        return Flow<T>{std::move(graph), emitter, 1};
+    }
+
+    // generate() -> std::optional<T>; std::nullopt ends the stream. Runs on a single worker.
+    template <typename TGenerator>
+    auto source(SourceOptions options, TGenerator generate)
+    {
+        using T = typename std::invoke_result_t<TGenerator&>::value_type;
+        return make_source<T>(std::move(options), std::move(generate));
+    }
+} // namespace Pipeline
+
+#endif // PIPELINE_HPP
@@ -0,0 +1,333 @@
+#ifndef POOL_METRICS_HPP
+#define POOL_METRICS_HPP
+
+#include "cache_line.hpp"
+#include "lookup_table.hpp"
+#include "tsc_clock.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+namespace PoolMetrics
+{
+    // HDR-style log-linear histogram: exact below sub_bucket_count, then sub_bucket_count
+    // buckets per power of two (~12% relative error). record() has a single writer - the owning worker.
+    class LatencyHistogram
+    {
+    public:
+        static constexpr int sub_bucket_bits = 3;
+        static constexpr size_t sub_bucket_count = size_t{1} << sub_bucket_bits;
+        static constexpr int max_exponent = 48; // ~3 days in ns
+        static constexpr size_t bucket_count = (max_exponent - sub_bucket_bits + 1) * sub_bucket_count;
+
+        static constexpr size_t bucket_index(uint64_t value)
+        {
+            if (value < sub_bucket_count)
+                return value;
+
+            const int exponent = std::bit_width(value) - 1;
+            if (exponent >= max_exponent)
+                return bucket_count - 1;
+
+            const int shift = exponent - sub_bucket_bits;
+            return (shift + 1) * sub_bucket_count + ((value >> shift) & (sub_bucket_count - 1));
+        }
+
+        static constexpr uint64_t bucket_lower_bound(size_t index)
+        {
+            return bucket_lower_bounds[index];
+        }
+
+        void record(uint64_t value_ns)
+        {
+            auto& bucket = counts_[bucket_index(value_ns)];
+            bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            sum_ns_.store(sum_ns_.load(std::memory_order_relaxed) + value_ns, std::memory_order_relaxed);
+        }
+
+        // any number of writers - for rarely recorded values (sampled or slow-path only)
+        void record_concurrent(uint64_t value_ns)
+        {
+            counts_[bucket_index(value_ns)].fetch_add(1, std::memory_order_relaxed);
+            sum_ns_.fetch_add(value_ns, std::memory_order_relaxed);
+        }
+
+        uint64_t count(size_t index) const
+        {
+            return counts_[index].load(std::memory_order_relaxed);
+        }
+
+        uint64_t sum_ns() const
+        {
+            return sum_ns_.load(std::memory_order_relaxed);
+        }
+
+    private:
+        // percentile queries walk the buckets - bounds are precomputed, a max_exponent too large
+        // for 64-bit values fails to compile
+        static constexpr auto bucket_lower_bounds = LookupTable::make_lookup_table<bucket_count>([](size_t index) -> uint64_t {
+            if (index < sub_bucket_count)
+                return index;
+
+            const auto shift = static_cast<unsigned>(index / sub_bucket_count - 1);
+            return LookupTable::checked_shl(uint64_t{sub_bucket_count + index % sub_bucket_count}, shift);
+        });
+
+        std::array<std::atomic<uint64_t>, bucket_count> counts_{};
+        std::atomic<uint64_t> sum_ns_{0};
+    };
+
+    // merged, plain copy of one or more histograms
+    struct HistogramSnapshot
+    {
+        std::array<uint64_t, LatencyHistogram::bucket_count> counts{};
+        uint64_t sum_ns = 0;
+
+        void merge(const LatencyHistogram& histogram)
+        {
+            for (size_t i = 0; i < counts.size(); ++i)
+                counts[i] += histogram.count(i);
+            sum_ns += histogram.sum_ns();
+        }
+
+        uint64_t total() const
+        {
+            uint64_t result = 0;
+            for (auto c : counts)
+                result += c;
+            return result;
+        }
+
+        std::chrono::nanoseconds mean() const
+        {
+            const auto n = total();
+            return std::chrono::nanoseconds{n ? sum_ns / n : 0};
+        }
+
+        // percentile in [0, 100] - lower bound of the bucket holding the value
+        std::chrono::nanoseconds percentile(double p) const
+        {
+            const auto n = total();
+            if (n == 0)
+                return std::chrono::nanoseconds{0};
+
+            const auto rank = static_cast<uint64_t>(std::clamp(p, 0.0, 100.0) / 100.0 * (n - 1));
+            uint64_t seen = 0;
+            for (size_t i = 0; i < counts.size(); ++i)
+            {
+                seen += counts[i];
+                if (seen > rank)
+                    return std::chrono::nanoseconds{LatencyHistogram::bucket_lower_bound(i)};
+            }
+
+            return std::chrono::nanoseconds{LatencyHistogram::bucket_lower_bound(counts.size() - 1)};
+        }
+    };
+
+    struct WorkerSnapshot
+    {
+        uint64_t tasks_completed = 0;
+        std::chrono::nanoseconds busy_time{0};
+        std::chrono::nanoseconds idle_time{0};
+
+        double utilization() const
+        {
+            const auto total = busy_time + idle_time;
+            return total.count() ? static_cast<double>(busy_time.count()) / total.count() : 0.0;
+        }
+    };
+
+    struct Snapshot
+    {
+        uint64_t tasks_submitted = 0;
+        uint64_t tasks_started = 0;
+        uint64_t tasks_completed = 0;
+        std::vector<WorkerSnapshot> workers;
+        HistogramSnapshot queue_wait; // sampled tasks only
+        HistogramSnapshot execution;  // sampled tasks only
+
+        uint64_t queue_depth() const
+        {
+            return tasks_submitted > tasks_started ? tasks_submitted - tasks_started : 0;
+        }
+
+        double utilization() const
+        {
+            std::chrono::nanoseconds busy{0}, total{0};
+            for (const auto& w : workers)
+            {
+                busy += w.busy_time;
+                total += w.busy_time + w.idle_time;
+            }
+            return total.count() ? static_cast<double>(busy.count()) / total.count() : 0.0;
+        }
+    };
+
+    inline std::ostream& operator<<(std::ostream& out, const Snapshot& s)
+    {
+        out << "tasks: submitted=" << s.tasks_submitted << " completed=" << s.tasks_completed
+            << " queue_depth=" << s.queue_depth() << " utilization=" << s.utilization() * 100 << "%\n";
+        out << "queue wait: mean=" << s.queue_wait.mean() << " p50=" << s.queue_wait.percentile(50)
+            << " p99=" << s.queue_wait.percentile(99) << " p99.9=" << s.queue_wait.percentile(99.9) << "\n";
+        out << "execution:  mean=" << s.execution.mean() << " p50=" << s.execution.percentile(50)
+            << " p99=" << s.execution.percentile(99) << " p99.9=" << s.execution.percentile(99.9) << "\n";
+        for (size_t i = 0; i < s.workers.size(); ++i)
+            out << "  worker#" << i << ": tasks=" << s.workers[i].tasks_completed << " busy=" << s.workers[i].utilization() * 100 << "%\n";
+        return out;
+    }
+
+    // policy: metrics compiled out - every hook is an empty inline function
+    struct Disabled
+    {
+        static constexpr bool enabled = false;
+
+        explicit Disabled(size_t /*worker_count*/) { }
+
+        void on_worker_start(size_t /*worker_index*/) { }
+    };
+
+    // policy: per-worker counters written only by their owner, merged on demand by snapshot()
+    // Every task is counted; every SamplingPeriod-th task is timed (queue wait, execution) -
+    // busy time is extrapolated from the timed ones, which keeps overhead low for ~1us tasks.
+    // Tasks run by helping threads (try_run_pending_task - a waiting caller, a worker of another pool)
+    // are only counted, in shared pool-level counters.
+    template <uint64_t SamplingPeriod = 8>
+    class Enabled
+    {
+        static_assert(SamplingPeriod > 0);
+
+    public:
+        static constexpr bool enabled = true;
+
+        explicit Enabled(size_t worker_count)
+            : workers_(worker_count)
+        {
+            TscClock::ns_per_tick(); // calibrate before the first task
+        }
+
+        // returns enqueue timestamp for sampled tasks, 0 otherwise
+        uint64_t on_submit()
+        {
+            const uint64_t n = tasks_submitted_.fetch_add(1, std::memory_order_relaxed);
+            return n % SamplingPeriod == 0 ? TscClock::ticks() : 0;
+        }
+
+        void on_worker_start(size_t worker_index)
+        {
+            current_ = {this, &workers_[worker_index]};
+            current_.counters->start_ticks.store(TscClock::ticks(), std::memory_order_relaxed);
+        }
+
+        // runs task and records its queue wait & execution time - if the calling thread is one of this pool's workers
+        template <typename F>
+        void run_task(uint64_t enqueued_ticks, F& task)
+        {
+            if (current_.owner != this) // helping thread
+            {
+                helped_tasks_started_.fetch_add(1, std::memory_order_relaxed);
+                task();
+                helped_tasks_completed_.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+
+            WorkerCounters* counters = current_.counters;
+
+            counters->add(counters->tasks_started, 1);
+
+            if (enqueued_ticks == 0)
+            {
+                task();
+            }
+            else
+            {
+                const uint64_t start = TscClock::ticks();
+                counters->queue_wait.record(TscClock::to_ns(start - std::min(start, enqueued_ticks)));
+
+                task();
+
+                const uint64_t end = TscClock::ticks();
+                counters->add(counters->sampled_busy_ticks, end - start);
+                counters->add(counters->sampled_tasks, 1);
+                counters->execution.record(TscClock::to_ns(end - start));
+            }
+
+            counters->add(counters->tasks_completed, 1);
+        }
+
+        // merges counters without stopping workers - values are consistent per counter, not across them
+        Snapshot snapshot() const
+        {
+            Snapshot result;
+            result.tasks_submitted = tasks_submitted_.load(std::memory_order_relaxed);
+            result.tasks_started = helped_tasks_started_.load(std::memory_order_relaxed);
+            result.tasks_completed = helped_tasks_completed_.load(std::memory_order_relaxed);
+            result.workers.reserve(workers_.size());
+
+            const uint64_t now = TscClock::ticks();
+
+            for (const auto& w : workers_)
+            {
+                const uint64_t sampled = w.sampled_tasks.load(std::memory_order_relaxed);
+                const uint64_t sampled_busy = w.sampled_busy_ticks.load(std::memory_order_relaxed);
+                const uint64_t start = w.start_ticks.load(std::memory_order_relaxed);
+
+                WorkerSnapshot ws;
+                ws.tasks_completed = w.tasks_completed.load(std::memory_order_relaxed);
+
+                const uint64_t lifetime_ticks = start && now > start ? now - start : 0;
+                const double busy_ticks = sampled ? static_cast<double>(sampled_busy) * ws.tasks_completed / sampled : 0.0;
+                const uint64_t busy = std::min(lifetime_ticks, static_cast<uint64_t>(busy_ticks));
+                ws.busy_time = std::chrono::nanoseconds{TscClock::to_ns(busy)};
+                ws.idle_time = std::chrono::nanoseconds{TscClock::to_ns(lifetime_ticks - busy)};
+                result.workers.push_back(ws);
+
+                result.tasks_started += w.tasks_started.load(std::memory_order_relaxed);
+                result.tasks_completed += ws.tasks_completed;
+                result.queue_wait.merge(w.queue_wait);
+                result.execution.merge(w.execution);
+            }
+
+            return result;
+        }
+
+    private:
+        struct alignas(cache_line_size) WorkerCounters
+        {
+            std::atomic<uint64_t> start_ticks{0};
+            std::atomic<uint64_t> tasks_started{0};
+            std::atomic<uint64_t> tasks_completed{0};
+            std::atomic<uint64_t> sampled_tasks{0};
+            std::atomic<uint64_t> sampled_busy_ticks{0};
+            LatencyHistogram queue_wait;
+            LatencyHistogram execution;
+
+            // single writer - plain load/store instead of a locked read-modify-write
+            static void add(std::atomic<uint64_t>& counter, uint64_t value)
+            {
+                counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+            }
+        };
+
+        // a thread is a worker of at most one pool - owner tells it apart from the other pools using the same policy
+        struct CurrentWorker
+        {
+            const Enabled* owner = nullptr;
+            WorkerCounters* counters = nullptr;
+        };
+
+        std::vector<WorkerCounters> workers_;
+        alignas(cache_line_size) std::atomic<uint64_t> tasks_submitted_{0};
+        alignas(cache_line_size) std::atomic<uint64_t> helped_tasks_started_{0};
+        std::atomic<uint64_t> helped_tasks_completed_{0};
+
+        inline static thread_local CurrentWorker current_{};
+    };
+} // namespace PoolMetrics
+
+#endif // POOL_METRICS_HPP
@@ -0,0 +1,270 @@
+#ifndef PROFILED_MUTEX_HPP
+#define PROFILED_MUTEX_HPP
+
+#include "pool_metrics.hpp"
+#include "tsc_clock.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// string literal usable as a template argument: ProfiledMutex<std::mutex, "queue">
+template <size_t N>
+struct FixedString
+{
+    char value[N];
+
+    constexpr FixedString(const char (&text)[N])
+    {
+        std::copy_n(text, N, value);
+    }
+
+    constexpr const char* c_str() const
+    {
+        return value;
+    }
+};
+
+namespace LockProfiling
+{
+    // shared by all mutexes with the same name - whatever their lockable type and sampling period
+    struct LockStats
+    {
+        const std::string name;
+        std::atomic<uint64_t> acquisitions{0};
+        std::atomic<uint64_t> contended{0};
+        PoolMetrics::LatencyHistogram wait; // contended acquisitions only
+        PoolMetrics::LatencyHistogram hold; // sampled acquisitions
+
+        explicit LockStats(std::string name)
+            : name{std::move(name)}
+        {
+        }
+    };
+
+    struct LockReport
+    {
+        std::string name;
+        uint64_t acquisitions = 0; // published in batches of SamplingPeriod per mutex
+        uint64_t contended = 0;
+        PoolMetrics::HistogramSnapshot wait;
+        PoolMetrics::HistogramSnapshot hold;
+
+        double contention_ratio() const
+        {
+            return acquisitions ? static_cast<double>(contended) / acquisitions : 0.0;
+        }
+
+        std::chrono::nanoseconds total_wait() const
+        {
+            return std::chrono::nanoseconds{wait.sum_ns};
+        }
+
+        // extrapolated from the sampled acquisitions
+        std::chrono::nanoseconds total_hold() const
+        {
+            const uint64_t sampled = hold.total();
+            return std::chrono::nanoseconds{sampled ? static_cast<uint64_t>(static_cast<double>(hold.sum_ns) * acquisitions / sampled) : 0};
+        }
+    };
+
+    class Registry
+    {
+    public:
+        static Registry& instance()
+        {
+            static Registry registry;
+            return registry;
+        }
+
+        LockStats& find_or_add(std::string name)
+        {
+            std::lock_guard lk{mtx_};
+            if (auto it = std::ranges::find(stats_, name, &LockStats::name); it != stats_.end())
+                return *it;
+            return stats_.emplace_back(std::move(name));
+        }
+
+        // hottest locks (by total wait time) first
+        std::vector<LockReport> snapshot() const
+        {
+            std::vector<LockReport> result;
+            {
+                std::lock_guard lk{mtx_};
+                for (const auto& s : stats_)
+                {
+                    LockReport& r = result.emplace_back();
+                    r.name = s.name;
+                    r.acquisitions = s.acquisitions.load(std::memory_order_relaxed);
+                    r.contended = s.contended.load(std::memory_order_relaxed);
+                    r.wait.merge(s.wait);
+                    r.hold.merge(s.hold);
+                }
+            }
+
+            std::ranges::sort(result, std::greater{}, &LockReport::total_wait);
+            return result;
+        }
+
+    private:
+        mutable std::mutex mtx_;
+        std::deque<LockStats> stats_; // stable addresses
+
+        Registry()
+        {
+            TscClock::ns_per_tick(); // calibrate before the first contended lock
+        }
+    };
+
+    inline std::vector<LockReport> snapshot()
+    {
+        return Registry::instance().snapshot();
+    }
+
+    inline std::ostream& operator<<(std::ostream& out, const LockReport& r)
+    {
+        out << r.name << ": acquisitions=" << r.acquisitions << " contended=" << r.contended << " ("
+            << r.contention_ratio() * 100 << "%)\n";
+        out << "  wait: total=" << std::chrono::duration_cast<std::chrono::microseconds>(r.total_wait())
+            << " mean=" << r.wait.mean() << " p50=" << r.wait.percentile(50) << " p99=" << r.wait.percentile(99) << "\n";
+        out << "  hold: total~" << std::chrono::duration_cast<std::chrono::microseconds>(r.total_hold())
+            << " mean=" << r.hold.mean() << " p50=" << r.hold.percentile(50) << " p99=" << r.hold.percentile(99) << "\n";
+        return out;
+    }
+
+    inline void report(std::ostream& out)
+    {
+        for (const auto& r : snapshot())
+            out << r;
+    }
+} // namespace LockProfiling
+
+// Drop-in wrapper for any Lockable (std::mutex, std::recursive_mutex, std::timed_mutex, ...).
+// Contended acquisitions are always counted and timed - they are slow anyway; the uncontended
+// fast path costs one try_lock and a plain per-instance counter. Hold time is measured for
+// every SamplingPeriod-th acquisition. Report with LockProfiling::report(std::cout).
+// Lock wrappers other than std::mutex need std::condition_variable_any.
+template <typename M, FixedString Name, uint64_t SamplingPeriod = 16>
+class ProfiledMutex
+{
+    static_assert(SamplingPeriod > 0);
+
+public:
+    ProfiledMutex()
+    {
+        stats(); // register
+    }
+
+    ProfiledMutex(const ProfiledMutex&) = delete;
+    ProfiledMutex& operator=(const ProfiledMutex&) = delete;
+
+    ~ProfiledMutex()
+    {
+        stats().acquisitions.fetch_add(acquisitions_ % SamplingPeriod, std::memory_order_relaxed);
+    }
+
+    void lock()
+    {
+        if (mtx_.try_lock())
+        {
+            on_acquired();
+            return;
+        }
+
+        const uint64_t start = TscClock::ticks();
+        mtx_.lock();
+        on_contended(start);
+        on_acquired();
+    }
+
+    bool try_lock()
+    {
+        if (!mtx_.try_lock())
+            return false;
+
+        on_acquired();
+        return true;
+    }
+
+    template <typename Rep, typename Period>
+    bool try_lock_for(const std::chrono::duration<Rep, Period>& timeout)
+        requires requires(M& m) { m.try_lock_for(timeout); }
+    {
+        if (try_lock())
+            return true;
+
+        const uint64_t start = TscClock::ticks();
+        if (!mtx_.try_lock_for(timeout))
+            return false;
+
+        on_contended(start);
+        on_acquired();
+        return true;
+    }
+
+    template <typename Clock, typename Duration>
+    bool try_lock_until(const std::chrono::time_point<Clock, Duration>& deadline)
+        requires requires(M& m) { m.try_lock_until(deadline); }
+    {
+        if (try_lock())
+            return true;
+
+        const uint64_t start = TscClock::ticks();
+        if (!mtx_.try_lock_until(deadline))
+            return false;
+
+        on_contended(start);
+        on_acquired();
+        return true;
+    }
+
+    void unlock()
+    {
+        if (--depth_ == 0 && hold_start_ != 0)
+        {
+            stats().hold.record_concurrent(TscClock::to_ns(TscClock::ticks() - hold_start_));
+            hold_start_ = 0;
+        }
+
+        mtx_.unlock();
+    }
+
+private:
+    M mtx_;
+    // written only while mtx_ is held
+    uint64_t acquisitions_ = 0;
+    uint64_t hold_start_ = 0;
+    unsigned depth_ = 0; // > 1 only for recursive mutexes
+
+    static LockProfiling::LockStats& stats()
+    {
+        static LockProfiling::LockStats& stats = LockProfiling::Registry::instance().find_or_add(Name.c_str());
+        return stats;
+    }
+
+    void on_contended(uint64_t start)
+    {
+        stats().contended.fetch_add(1, std::memory_order_relaxed);
+        stats().wait.record_concurrent(TscClock::to_ns(TscClock::ticks() - start));
+    }
+
+    // mtx_ is held
+    void on_acquired()
+    {
+        ++depth_;
+        if (++acquisitions_ % SamplingPeriod != 0)
+            return;
+
+        stats().acquisitions.fetch_add(SamplingPeriod, std::memory_order_relaxed);
+        if (hold_start_ == 0) // recursive mutex - timed until the outermost unlock
+            hold_start_ = TscClock::ticks();
+    }
+};
+
+#endif // PROFILED_MUTEX_HPP
@@ -0,0 +1,147 @@
+#ifndef RCU_CELL_HPP
+#define RCU_CELL_HPP
+
+#include "reclamation.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+
+// Read-copy-update publication of a value that is read often and replaced as a whole:
+// the writer builds the new value off to the side and swaps it in with a single pointer exchange,
+// readers pin the current version without taking any lock and keep it alive for as long as they hold the snapshot.
+// Replaced versions are reclaimed by the epoch domain once no reader can still see them.
+//
+//   RcuCell<std::vector<int>> data;
+//   data.publish(std::move(new_data));    // writer
+//   auto snapshot = data.read();          // reader - snapshot->size(), (*snapshot)[0], ...
+template <typename T>
+class RcuCell
+{
+    struct Version
+    {
+        T value;
+        uint64_t number;
+    };
+
+    Reclamation::EpochDomain& domain_;
+    std::atomic<Version*> current_{nullptr};
+    std::atomic<uint64_t> latest_{0}; // number of the current version - waited on by wait_for_update
+    std::mutex mtx_writers_;
+
+public:
+    // pinned version - must not outlive the cell and should be short-lived (it delays reclamation)
+    class Snapshot
+    {
+        Reclamation::EpochDomain::Guard guard_;
+        const Version* version_;
+
+        friend class RcuCell;
+
+        Snapshot(Reclamation::EpochDomain::Guard guard, const Version* version)
+            : guard_{std::move(guard)}
+            , version_{version}
+        {
+        }
+
+    public:
+        // false until the first publication
+        explicit operator bool() const
+        {
+            return version_ != nullptr;
+        }
+
+        const T& operator*() const
+        {
+            return version_->value;
+        }
+
+        const T* operator->() const
+        {
+            return &version_->value;
+        }
+
+        // 0 when nothing has been published yet
+        uint64_t version() const
+        {
+            return version_ != nullptr ? version_->number : 0;
+        }
+    };
+
+    explicit RcuCell(Reclamation::EpochDomain& domain = Reclamation::EpochDomain::global())
+        : domain_{domain}
+    {
+    }
+
+    explicit RcuCell(T value, Reclamation::EpochDomain& domain = Reclamation::EpochDomain::global())
+        : RcuCell{domain}
+    {
+        publish(std::move(value));
+    }
+
+    RcuCell(const RcuCell&) = delete;
+    RcuCell& operator=(const RcuCell&) = delete;
+
+    // no snapshot may be alive
+    ~RcuCell()
+    {
+        delete current_.load(std::memory_order_acquire);
+    }
+
+    // lock-free - a pin and an acquire load
+    Snapshot read() const
+    {
+        auto guard = domain_.pin();
+        const Version* version = current_.load(std::memory_order_acquire);
+        return Snapshot{std::move(guard), version};
+    }
+
+    // writers are serialized (publication is rare - readers never wait for the lock);
+    // the replaced version is reclaimed once no reader pins it
+    void publish(T value)
+    {
+        std::lock_guard lk{mtx_writers_};
+        publish_locked(std::move(value));
+    }
+
+    // copy - modify - publish; concurrent updates are serialized, so none of them is lost
+    template <typename F>
+    void update(F modify)
+    {
+        std::lock_guard lk{mtx_writers_};
+        T value = [this] {
+            auto snapshot = read();
+            return snapshot ? *snapshot : T{};
+        }();
+        modify(value);
+        publish_locked(std::move(value));
+    }
+
+    uint64_t version() const
+    {
+        return latest_.load(std::memory_order_acquire);
+    }
+
+    // blocks until a version newer than seen is published; returns its number
+    uint64_t wait_for_update(uint64_t seen) const
+    {
+        latest_.wait(seen, std::memory_order_acquire);
+        return latest_.load(std::memory_order_acquire);
+    }
+
+private:
+    void publish_locked(T value)
+    {
+        const uint64_t number = latest_.load(std::memory_order_relaxed) + 1;
+        Version* previous = current_.exchange(new Version{std::move(value), number}, std::memory_order_acq_rel);
+
+        latest_.store(number, std::memory_order_release);
+        latest_.notify_all();
+
+        if (previous != nullptr)
+            domain_.retire(previous);
+    }
+};
+
+#endif // RCU_CELL_HPP
@@ -0,0 +1,77 @@
+#ifndef SPIN_LOCK_HPP
+#define SPIN_LOCK_HPP
+
+#include "cpu_relax.hpp"
+#include "lookup_table.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+// Exponential backoff for spin loops: 1, 2, 4, ... 64 pauses per step (a few microseconds in total)
+// from a compile-time schedule, then the thread yields to the scheduler on every call.
+class Backoff
+{
+public:
+    static constexpr size_t spin_steps = 7;
+
+    void pause()
+    {
+        if (step_ < spin_steps)
+        {
+            for (uint16_t i = 0; i < pause_schedule[step_]; ++i)
+                cpu_relax();
+            ++step_;
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    void reset()
+    {
+        step_ = 0;
+    }
+
+    static constexpr uint16_t pauses(size_t step)
+    {
+        return pause_schedule[step];
+    }
+
+private:
+    // 2^step - a schedule overflowing uint16_t fails to compile
+    static constexpr auto pause_schedule = LookupTable::make_lookup_table<spin_steps, uint16_t>(
+        [](size_t step) { return LookupTable::checked_shl(uint32_t{1}, static_cast<unsigned>(step)); });
+
+    size_t step_ = 0;
+};
+
+// test-and-test-and-set lock for very short critical sections
+class SpinLock
+{
+    std::atomic<bool> locked_{false};
+
+public:
+    void lock()
+    {
+        while (locked_.exchange(true, std::memory_order_acquire))
+        {
+            Backoff backoff;
+            while (locked_.load(std::memory_order_relaxed)) // spin on a shared cache line copy
+                backoff.pause();
+        }
+    }
+
+    bool try_lock()
+    {
+        return !locked_.load(std::memory_order_relaxed) && !locked_.exchange(true, std::memory_order_acquire);
+    }
+
+    void unlock()
+    {
+        locked_.store(false, std::memory_order_release);
+    }
+};
+
+#endif // SPIN_LOCK_HPP
@@ -0,0 +1,159 @@
+#ifndef TASK_CONTEXT_HPP
+#define TASK_CONTEXT_HPP
+
+#include <atomic>
+#include <string>
+#include <utility>
+
+class TaskContext;
+
+// intrusive refcounted pointer - one machine word, so a captured context fits into
+// move_only_function's small buffer next to a packaged_task
+class ContextPtr
+{
+    const TaskContext* ptr_ = nullptr;
+
+public:
+    ContextPtr() = default;
+
+    explicit ContextPtr(const TaskContext* ptr) noexcept;
+
+    ContextPtr(const ContextPtr& other) noexcept;
+    ContextPtr& operator=(const ContextPtr& other) noexcept;
+
+    ContextPtr(ContextPtr&& other) noexcept
+        : ptr_{std::exchange(other.ptr_, nullptr)}
+    {
+    }
+
+    ContextPtr& operator=(ContextPtr&& other) noexcept
+    {
+        if (this != &other)
+        {
+            ContextPtr temp{std::move(other)};
+            std::swap(ptr_, temp.ptr_);
+        }
+        return *this;
+    }
+
+    ~ContextPtr();
+
+    const TaskContext* get() const noexcept
+    {
+        return ptr_;
+    }
+
+    const TaskContext* operator->() const noexcept
+    {
+        return ptr_;
+    }
+
+    explicit operator bool() const noexcept
+    {
+        return ptr_ != nullptr;
+    }
+};
+
+// Immutable per-request context (replacement for thread_local std::string request_id).
+// Pool tasks capture the submitting thread's context and run with it installed,
+// so a hop onto a worker costs one refcount increment instead of a string copy.
+class TaskContext
+{
+    const std::string request_id_;
+    mutable std::atomic<unsigned> ref_count_{0};
+
+    friend class ContextPtr;
+
+public:
+    explicit TaskContext(std::string request_id)
+        : request_id_{std::move(request_id)}
+    {
+    }
+
+    TaskContext(const TaskContext&) = delete;
+    TaskContext& operator=(const TaskContext&) = delete;
+
+    const std::string& request_id() const noexcept
+    {
+        return request_id_;
+    }
+
+    static ContextPtr make(std::string request_id)
+    {
+        return ContextPtr{new TaskContext{std::move(request_id)}};
+    }
+
+    // context of the calling thread/task - nullptr when none is installed
+    static const TaskContext* current() noexcept
+    {
+        return current_slot().get();
+    }
+
+    static ContextPtr capture() noexcept
+    {
+        return current_slot();
+    }
+
+    static ContextPtr& current_slot() noexcept
+    {
+        static thread_local ContextPtr current;
+        return current;
+    }
+};
+
+inline ContextPtr::ContextPtr(const TaskContext* ptr) noexcept
+    : ptr_{ptr}
+{
+    if (ptr_)
+        ptr_->ref_count_.fetch_add(1, std::memory_order_relaxed);
+}
+
+inline ContextPtr::ContextPtr(const ContextPtr& other) noexcept
+    : ContextPtr{other.ptr_}
+{
+}
+
+inline ContextPtr& ContextPtr::operator=(const ContextPtr& other) noexcept
+{
+    ContextPtr temp{other};
+    std::swap(ptr_, temp.ptr_);
+    return *this;
+}
+
+inline ContextPtr::~ContextPtr()
+{
+    if (ptr_ && ptr_->ref_count_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        delete ptr_;
+}
+
+// RAII - installs context in the calling thread, restores the previous one on exit
+class ContextScope
+{
+    ContextPtr previous_;
+
+public:
+    explicit ContextScope(ContextPtr context) noexcept
+        : previous_{std::exchange(TaskContext::current_slot(), std::move(context))}
+    {
+    }
+
+    ContextScope(const ContextScope&) = delete;
+    ContextScope& operator=(const ContextScope&) = delete;
+
+    ~ContextScope()
+    {
+        TaskContext::current_slot() = std::move(previous_);
+    }
+};
+
+// for hops that do not go through ThreadPool::submit (std::async, std::jthread)
+template <typename F>
+auto with_current_context(F&& f)
+{
+    return [context = TaskContext::capture(), f = std::forward<F>(f)](auto&&... args) mutable -> decltype(auto) {
+        ContextScope scope{context};
+        return f(std::forward<decltype(args)>(args)...);
+    };
+}
+
+#endif // TASK_CONTEXT_HPP
@@ -0,0 +1,209 @@
+#ifndef TASK_GROUP_HPP
+#define TASK_GROUP_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <stop_token>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// thrown by TaskGroup::wait() - holds every exception thrown by tasks of the group
+class TaskGroupError : public std::exception
+{
+    std::vector<std::exception_ptr> exceptions_;
+    std::string message_;
+
+public:
+    explicit TaskGroupError(std::vector<std::exception_ptr> exceptions)
+        : exceptions_{std::move(exceptions)}
+        , message_{std::to_string(exceptions_.size()) + " task(s) failed"}
+    {
+    }
+
+    const std::vector<std::exception_ptr>& exceptions() const noexcept
+    {
+        return exceptions_;
+    }
+
+    const char* what() const noexcept override
+    {
+        return message_.c_str();
+    }
+};
+
+// stored in futures of tasks skipped because a sibling had failed; tasks that observe
+// their stop_token may throw it too
+class TaskCancelled : public std::exception
+{
+public:
+    const char* what() const noexcept override
+    {
+        return "task cancelled";
+    }
+};
+
+// Structured concurrency on a shared pool: all tasks started with run() finish before wait() returns.
+// First failure requests stop for the whole group - queued tasks are skipped, running tasks
+// taking std::stop_token can return early. Results are delivered through std::future<T>,
+// so T does not have to be default constructible. wait() re-arms the group - tasks run after it
+// are not affected by earlier failures or cancel().
+template <typename TPool>
+class TaskGroup
+{
+public:
+    explicit TaskGroup(TPool& pool)
+        : pool_{pool}
+    {
+    }
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    // tasks refer to the group - never leave it with work in flight
+    ~TaskGroup()
+    {
+        if (pending_count() > 0)
+        {
+            cancel();
+            wait_for_pending();
+        }
+    }
+
+    template <typename F>
+    auto run(F&& f)
+    {
+        std::stop_token token;
+        {
+            std::lock_guard lk{mtx_};
+            ++pending_;
+            token = stop_source_.get_token();
+        }
+
+        try
+        {
+            return pool_.submit([this, token, f = std::forward<F>(f)]() mutable {
+                FinishGuard finish{*this};
+
+                if (token.stop_requested())
+                    throw TaskCancelled{};
+
+                try
+                {
+                    if constexpr (std::is_invocable_v<F&, std::stop_token>)
+                        return f(token);
+                    else
+                        return f();
+                }
+                catch (const TaskCancelled&)
+                {
+                    throw; // task observed cancellation - not a failure
+                }
+                catch (...)
+                {
+                    record_exception(std::current_exception());
+                    throw; // also delivered through the task's future
+                }
+            });
+        }
+        catch (...)
+        {
+            finish_one(); // task was never queued
+            throw;
+        }
+    }
+
+    // waits for all tasks (running queued pool tasks meanwhile); throws TaskGroupError if any failed
+    void wait()
+    {
+        wait_for_pending();
+
+        std::vector<std::exception_ptr> exceptions;
+        {
+            std::lock_guard lk{mtx_};
+            exceptions = std::exchange(exceptions_, {});
+            if (stop_source_.stop_requested())
+                stop_source_ = std::stop_source{};
+        }
+
+        if (!exceptions.empty())
+            throw TaskGroupError{std::move(exceptions)};
+    }
+
+    void cancel()
+    {
+        std::stop_source source;
+        {
+            std::lock_guard lk{mtx_};
+            source = stop_source_;
+        }
+        source.request_stop(); // stop callbacks run outside of the lock
+    }
+
+    std::stop_token stop_token() const
+    {
+        std::lock_guard lk{mtx_};
+        return stop_source_.get_token();
+    }
+
+    size_t pending_count() const
+    {
+        std::lock_guard lk{mtx_};
+        return pending_;
+    }
+
+private:
+    TPool& pool_;
+    mutable std::mutex mtx_;
+    std::stop_source stop_source_; // replaced by wait() once stop was requested
+    std::condition_variable cv_finished_;
+    size_t pending_ = 0;
+    std::vector<std::exception_ptr> exceptions_;
+
+    struct FinishGuard
+    {
+        TaskGroup& group;
+
+        ~FinishGuard()
+        {
+            group.finish_one();
+        }
+    };
+
+    void finish_one()
+    {
+        std::lock_guard lk{mtx_};
+        if (--pending_ == 0)
+            cv_finished_.notify_all(); // under lock - the group may be destroyed right after
+    }
+
+    void record_exception(std::exception_ptr eptr)
+    {
+        {
+            std::lock_guard lk{mtx_};
+            exceptions_.push_back(std::move(eptr));
+        }
+        cancel(); // first failure cancels siblings
+    }
+
+    void wait_for_pending()
+    {
+        std::unique_lock lk{mtx_};
+        while (pending_ > 0)
+        {
+            lk.unlock();
+            const bool helped = pool_.try_run_pending_task();
+            lk.lock();
+
+            if (!helped)
+                cv_finished_.wait_for(lk, std::chrono::milliseconds{1}, [this] { return pending_ == 0; });
+        }
+    }
+};
+
+#endif // TASK_GROUP_HPP
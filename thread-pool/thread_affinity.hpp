@@ -0,0 +1,111 @@
+#ifndef THREAD_AFFINITY_HPP
+#define THREAD_AFFINITY_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+// CPUs grouped by NUMA node - read from sysfs, so no dependency on libnuma
+struct CpuTopology
+{
+    std::vector<std::vector<int>> node_cpus;
+
+    size_t node_count() const
+    {
+        return node_cpus.size();
+    }
+
+    size_t cpu_count() const
+    {
+        size_t count = 0;
+        for (const auto& cpus : node_cpus)
+            count += cpus.size();
+        return count;
+    }
+
+    static CpuTopology detect()
+    {
+        CpuTopology topology;
+
+#ifdef __linux__
+        cpu_set_t allowed;
+        CPU_ZERO(&allowed);
+        const bool has_mask = sched_getaffinity(0, sizeof(allowed), &allowed) == 0;
+
+        for (int node = 0;; ++node)
+        {
+            std::ifstream cpulist{"/sys/devices/system/node/node" + std::to_string(node) + "/cpulist"};
+            if (!cpulist)
+                break;
+
+            std::string line;
+            std::getline(cpulist, line);
+
+            std::vector<int> cpus = parse_cpu_list(line);
+            if (has_mask) // respect cgroup/taskset restrictions
+                std::erase_if(cpus, [&allowed](int cpu) { return !CPU_ISSET(cpu, &allowed); });
+
+            if (!cpus.empty())
+                topology.node_cpus.push_back(std::move(cpus));
+        }
+#endif
+
+        if (topology.node_cpus.empty()) // no sysfs - one node with all hardware threads
+        {
+            std::vector<int> cpus(std::max(1u, std::thread::hardware_concurrency()));
+            for (size_t i = 0; i < cpus.size(); ++i)
+                cpus[i] = static_cast<int>(i);
+            topology.node_cpus.push_back(std::move(cpus));
+        }
+
+        return topology;
+    }
+
+    // parses kernel cpulist format, e.g. "0-3,8-11,16"
+    static std::vector<int> parse_cpu_list(const std::string& text)
+    {
+        std::vector<int> cpus;
+        std::istringstream in{text};
+        std::string range;
+
+        while (std::getline(in, range, ','))
+        {
+            if (range.empty())
+                continue;
+
+            const auto dash = range.find('-');
+            const int first = std::stoi(range.substr(0, dash));
+            const int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+
+            for (int cpu = first; cpu <= last; ++cpu)
+                cpus.push_back(cpu);
+        }
+
+        return cpus;
+    }
+};
+
+// pins calling thread to a single CPU; returns false when not supported or refused
+inline bool pin_current_thread(int cpu)
+{
+#ifdef __linux__
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    CPU_SET(cpu, &cpu_set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set) == 0;
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
+#endif // THREAD_AFFINITY_HPP
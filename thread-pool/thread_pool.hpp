@@ -0,0 +1,337 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include "pool_metrics.hpp"
+#include "profiled_mutex.hpp"
+#include "task_context.hpp"
+#include "thread_safe_queue.hpp"
+#include "trace_recorder.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <exception>
+#include <expected>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ver_1
+{
+    using Task = std::function<void()>;
+
+    class ThreadPool
+    {
+    public:
+        explicit ThreadPool(size_t thread_count)
+            : threads_(thread_count)
+        {
+            for (auto& thd : threads_)
+                thd = std::thread{[this] { run(); }};
+        }
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        ~ThreadPool()
+        {
+            for (size_t i = 0; i < threads_.size(); ++i)
+            {
+                // sending poisoning pill
+                tasks_.push(Task{});
+            }
+
+            for (auto& thd : threads_)
+            {
+                if (thd.joinable())
+                    thd.join();
+            }
+        }
+
+        void submit(Task task)
+        {
+            assert(task != nullptr && "Task cannot be empty");
+
+            tasks_.push(task);
+        }
+
+    private:
+        ThreadSafeQueue<Task> tasks_;
+        std::vector<std::thread> threads_;
+
+        void run()
+        {
+            while (true)
+            {
+                Task task;
+                tasks_.pop(task);
+
+                if (is_end_of_work(task))
+                    return;
+
+                task(); // execution of task
+            }
+        }
+
+        bool is_end_of_work(Task task)
+        {
+            return task == nullptr;
+        }
+    };
+} // namespace ver_1
+
+inline namespace ver_2
+{
+    using Task = std::move_only_function<void()>; // since C++23
+
+    template <typename T>
+    inline constexpr bool is_expected_v = false;
+
+    template <typename T, typename E>
+    inline constexpr bool is_expected_v<std::expected<T, E>> = true;
+
+    // TMetrics - PoolMetrics::Disabled (compiled out) or PoolMetrics::Enabled<SamplingPeriod>
+    template <typename TMetrics = PoolMetrics::Disabled>
+    class BasicThreadPool
+    {
+    public:
+        explicit BasicThreadPool(size_t thread_count)
+            : threads_(thread_count), end_of_work_{false}, metrics_{thread_count}
+        {
+            for (size_t i = 0; i < threads_.size(); ++i)
+                threads_[i] = std::thread{[this, i] { run(i); }};
+        }
+
+        BasicThreadPool(const BasicThreadPool&) = delete;
+        BasicThreadPool& operator=(const BasicThreadPool&) = delete;
+
+        ~BasicThreadPool()
+        {
+            for (size_t i = 0; i < threads_.size(); ++i)
+            {
+                tasks_.push(make_queue_item([this] { this->end_of_work_ = true; }));
+            }
+
+            for (auto& thd : threads_)
+            {
+                if (thd.joinable())
+                    thd.join();
+            }
+        }
+
+        template <typename FunctionTask>        
+        auto submit(FunctionTask&& ftask)
+        {
+            return submit_packaged(std::forward<FunctionTask>(ftask));
+        }
+
+        // tasks returning std::expected<T, E> report failures as values - future.get() hands over the error
+        // without throw, exception_ptr and rethrow. When E can hold a std::exception_ptr, an exception
+        // escaping the task is stored as the error too, so get() never throws.
+        template <typename FunctionTask>
+            requires is_expected_v<std::invoke_result_t<FunctionTask&>>
+        auto submit(FunctionTask&& ftask)
+        {
+            using TResult = std::invoke_result_t<FunctionTask&>;
+            using TError = typename TResult::error_type;
+
+            if constexpr (std::is_constructible_v<TError, std::exception_ptr>)
+            {
+                return submit_packaged([ftask = std::forward<FunctionTask>(ftask)]() mutable -> TResult {
+                    try
+                    {
+                        return ftask();
+                    }
+                    catch (...)
+                    {
+                        return std::unexpected<TError>{TError{std::current_exception()}};
+                    }
+                });
+            }
+            else
+                return submit_packaged(std::forward<FunctionTask>(ftask));
+        }
+
+        // as submit(ftask), but the shared state and the task are allocated with alloc (e.g. ArenaAllocator)
+        // instead of operator new - what the queue stores is a pointer and the allocator
+        template <typename TAllocator, typename FunctionTask>
+        auto submit(std::allocator_arg_t, const TAllocator& alloc, FunctionTask&& ftask)
+        {
+            using TResult = decltype(ftask());
+            std::promise<TResult> promise{std::allocator_arg, alloc};
+            std::future<TResult> f_result = promise.get_future();
+
+            auto task = [promise = std::move(promise), ftask = std::forward<FunctionTask>(ftask), context = TaskContext::capture()]() mutable {
+                ContextScope scope{std::move(context)};
+                try
+                {
+                    if constexpr (std::is_void_v<TResult>)
+                    {
+                        ftask();
+                        promise.set_value();
+                    }
+                    else
+                        promise.set_value(ftask());
+                }
+                catch (...)
+                {
+                    promise.set_exception(std::current_exception());
+                }
+            };
+            tasks_.push(make_queue_item(AllocatedTask<TAllocator, decltype(task)>{alloc, std::move(task)}));
+
+            return f_result;
+        }
+
+        size_t size() const
+        {
+            return threads_.size();
+        }
+
+        // runs one queued task on the calling thread - lets a thread that waits
+        // for a result of a pool task help instead of blocking a worker
+        bool try_run_pending_task()
+        {
+            QueueItem task;
+            if (!tasks_.try_pop(task))
+                return false;
+
+            Trace::Scope trace{"task (helping)"};
+            execute(task);
+            return true;
+        }
+
+        // merged per-worker counters - workers are not stopped
+        PoolMetrics::Snapshot metrics() const
+            requires TMetrics::enabled
+        {
+            return metrics_.snapshot();
+        }
+
+    private:
+        // enqueue timestamp is kept next to the task - capturing it would not fit
+        // into move_only_function's small buffer and cost an allocation per task
+        struct TimedTask
+        {
+            Task task;
+            uint64_t enqueued_at;
+        };
+
+        // a callable living in memory from alloc - nothrow-movable and two pointers big,
+        // so move_only_function keeps it in its small buffer
+        template <typename TAllocator, typename F>
+        class AllocatedTask
+        {
+            using Alloc = typename std::allocator_traits<TAllocator>::template rebind_alloc<F>;
+            using AllocTraits = std::allocator_traits<Alloc>;
+
+            Alloc alloc_;
+            F* f_;
+
+        public:
+            AllocatedTask(const TAllocator& alloc, F&& f)
+                : alloc_{alloc}, f_{AllocTraits::allocate(alloc_, 1)}
+            {
+                try
+                {
+                    AllocTraits::construct(alloc_, f_, std::move(f));
+                }
+                catch (...)
+                {
+                    AllocTraits::deallocate(alloc_, f_, 1);
+                    throw;
+                }
+            }
+
+            AllocatedTask(AllocatedTask&& other) noexcept
+                : alloc_{other.alloc_}, f_{std::exchange(other.f_, nullptr)}
+            {
+            }
+
+            AllocatedTask& operator=(AllocatedTask&&) = delete;
+
+            ~AllocatedTask()
+            {
+                if (f_ == nullptr)
+                    return;
+                AllocTraits::destroy(alloc_, f_);
+                AllocTraits::deallocate(alloc_, f_, 1);
+            }
+
+            void operator()()
+            {
+                (*f_)();
+            }
+        };
+
+        using QueueItem = std::conditional_t<TMetrics::enabled, TimedTask, Task>;
+        using QueueMutex = std::conditional_t<TMetrics::enabled, ProfiledMutex<std::mutex, "ThreadPool::tasks_">, std::mutex>;
+
+        ThreadSafeQueue<QueueItem, QueueMutex> tasks_;
+        std::vector<std::thread> threads_;
+        std::atomic<bool> end_of_work_;
+        [[no_unique_address]] TMetrics metrics_;
+
+        template <typename FunctionTask>
+        auto submit_packaged(FunctionTask&& ftask)
+        {
+            using TResult = decltype(ftask());
+            std::packaged_task<TResult()> pt{std::move(ftask)};
+            std::future<TResult> f_result = pt.get_future();
+
+            // task runs with the submitter's context installed
+            auto task = [pt = std::move(pt), context = TaskContext::capture()]() mutable {
+                ContextScope scope{std::move(context)};
+                pt();
+            };
+            tasks_.push(make_queue_item(std::move(task)));
+
+            return f_result;
+        }
+
+        template <typename F>
+        QueueItem make_queue_item(F&& f)
+        {
+            if constexpr (TMetrics::enabled)
+                return TimedTask{Task{std::forward<F>(f)}, metrics_.on_submit()};
+            else
+                return Task{std::forward<F>(f)};
+        }
+
+        void execute(QueueItem& item)
+        {
+            if constexpr (TMetrics::enabled)
+                metrics_.run_task(item.enqueued_at, item.task);
+            else
+                item();
+        }
+
+        void run(size_t worker_index)
+        {
+            metrics_.on_worker_start(worker_index);
+            Trace::set_thread_name("pool worker #" + std::to_string(worker_index));
+
+            while (!end_of_work_)
+            {
+                QueueItem task;
+                {
+                    Trace::Scope trace{"queue wait"};
+                    tasks_.pop(task);
+                }
+
+                Trace::Scope trace{"task"};
+                execute(task);
+            }
+        }
+    };
+
+    using ThreadPool = BasicThreadPool<>;
+    using InstrumentedThreadPool = BasicThreadPool<PoolMetrics::Enabled<>>;
+} // namespace ver_2
+
+#endif // THREAD_POOL_HPP
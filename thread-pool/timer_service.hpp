@@ -0,0 +1,304 @@
+#ifndef TIMER_SERVICE_HPP
+#define TIMER_SERVICE_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// One timer thread serving any number of delayed and cancellable jobs.
+// Timers are kept in a hierarchical timing wheel (4 levels x 256 slots of tick resolution):
+// insert and cancel are O(1), timers of outer levels cascade inwards as time advances.
+// Callbacks run on the timer thread and must be short - hand longer work over to a pool
+// (see schedule_on()).
+class TimerService
+{
+public:
+    using Clock = std::chrono::steady_clock;
+    using Callback = std::move_only_function<void()>;
+    using TimerId = uint64_t;
+
+    explicit TimerService(std::chrono::microseconds tick = std::chrono::milliseconds{1})
+        : tick_{tick}
+        , start_{Clock::now()}
+    {
+        thd_timer_ = std::jthread{[this](std::stop_token stop_tkn) { run(stop_tkn); }};
+    }
+
+    TimerService(const TimerService&) = delete;
+    TimerService& operator=(const TimerService&) = delete;
+
+    ~TimerService()
+    {
+        thd_timer_.request_stop();
+        cv_timers_.notify_all();
+    }
+
+    // process-wide instance for code that has no service at hand
+    static TimerService& shared()
+    {
+        static TimerService timers;
+        return timers;
+    }
+
+    TimerId schedule_at(Clock::time_point deadline, Callback callback)
+    {
+        TimerId id;
+        bool earlier_than_planned;
+        {
+            std::lock_guard lk{mtx_};
+            if (timers_.empty()) // idle wheel is not advanced - catch up before inserting
+                current_tick_ = std::max(current_tick_, elapsed_ticks(Clock::now()));
+
+            id = next_id_++;
+            const uint64_t deadline_tick = to_tick(deadline);
+            timers_.emplace(id, Timer{std::move(callback), deadline_tick});
+            insert(id, deadline_tick);
+
+            earlier_than_planned = deadline_tick < wake_tick_;
+            if (earlier_than_planned)
+                wake_tick_ = deadline_tick; // the timer thread plans its sleep again
+        }
+        if (earlier_than_planned)
+            cv_timers_.notify_one();
+
+        return id;
+    }
+
+    TimerId schedule_after(Clock::duration delay, Callback callback)
+    {
+        return schedule_at(Clock::now() + delay, std::move(callback));
+    }
+
+    // returns false if the timer has already fired or was cancelled
+    bool cancel(TimerId id)
+    {
+        std::lock_guard lk{mtx_};
+        return timers_.erase(id) == 1; // slot entry is dropped lazily
+    }
+
+    // interruptible sleep - returns false when woken by stop request (within microseconds)
+    bool sleep_until(std::stop_token stop_tkn, Clock::time_point deadline)
+    {
+        // shared - the timer may fire while the sleeper is already gone
+        auto state = std::make_shared<std::atomic<int>>(waiting);
+
+        const TimerId id = schedule_at(deadline, [state] {
+            int expected = waiting;
+            if (state->compare_exchange_strong(expected, timed_out))
+                state->notify_one();
+        });
+
+        std::stop_callback on_stop{stop_tkn, [&state] {
+            int expected = waiting;
+            if (state->compare_exchange_strong(expected, stopped))
+                state->notify_one();
+        }};
+
+        state->wait(waiting);
+
+        if (state->load() == stopped)
+        {
+            cancel(id);
+            return false;
+        }
+
+        return true;
+    }
+
+    template <typename Rep, typename Period>
+    bool sleep_for(std::stop_token stop_tkn, std::chrono::duration<Rep, Period> delay)
+    {
+        return sleep_until(stop_tkn, Clock::now() + std::chrono::duration_cast<Clock::duration>(delay));
+    }
+
+    // runs task on the pool at deadline unless stop is requested first; the pool is referenced, not owned -
+    // it must outlive the timer (until it has fired or was cancelled)
+    template <typename TPool, typename F>
+    TimerId schedule_on(TPool& pool, Clock::time_point deadline, F task, std::stop_token stop_tkn = {})
+    {
+        return schedule_at(deadline, [&pool, task = std::move(task), stop_tkn]() mutable {
+            if (!stop_tkn.stop_requested())
+                pool.submit(std::move(task));
+        });
+    }
+
+    size_t pending_count() const
+    {
+        std::lock_guard lk{mtx_};
+        return timers_.size();
+    }
+
+private:
+    static constexpr int waiting = 0;
+    static constexpr int timed_out = 1;
+    static constexpr int stopped = 2;
+
+    static constexpr int level_bits = 8;
+    static constexpr size_t slot_count = size_t{1} << level_bits;
+    static constexpr int level_count = 4;
+    static constexpr uint64_t no_tick = UINT64_MAX;
+
+    struct Timer
+    {
+        Callback callback;
+        uint64_t deadline_tick;
+    };
+
+    using Slot = std::vector<TimerId>;
+
+    const std::chrono::microseconds tick_;
+    const Clock::time_point start_;
+    mutable std::mutex mtx_;
+    std::condition_variable_any cv_timers_;
+    std::unordered_map<TimerId, Timer> timers_;
+    std::array<std::array<Slot, slot_count>, level_count> wheel_;
+    uint64_t current_tick_ = 0;
+    uint64_t wake_tick_ = no_tick; // the timer thread sleeps until then
+    TimerId next_id_ = 1;
+    std::jthread thd_timer_;
+
+    // deadline rounded up - a timer never fires early
+    uint64_t to_tick(Clock::time_point deadline) const
+    {
+        if (deadline <= start_)
+            return 0;
+        return static_cast<uint64_t>((deadline - start_ + tick_ - Clock::duration{1}) / tick_);
+    }
+
+    // completed ticks - rounded down
+    uint64_t elapsed_ticks(Clock::time_point now) const
+    {
+        return now <= start_ ? 0 : static_cast<uint64_t>((now - start_) / tick_);
+    }
+
+    Clock::time_point to_time_point(uint64_t tick) const
+    {
+        return start_ + tick * tick_;
+    }
+
+    void insert(TimerId id, uint64_t deadline_tick) // mtx_ must be held
+    {
+        const uint64_t tick = std::max(deadline_tick, current_tick_ + 1);
+        const uint64_t delta = tick - current_tick_;
+
+        for (int level = 0; level < level_count; ++level)
+        {
+            if (delta < (uint64_t{1} << (level_bits * (level + 1))) || level == level_count - 1)
+            {
+                const size_t slot = (tick >> (level_bits * level)) & (slot_count - 1);
+                wheel_[level][slot].push_back(id);
+                return;
+            }
+        }
+    }
+
+    // first tick at which advance() has work - a level-0 slot with timers or a cascade of a non-empty slot;
+    // mtx_ must be held
+    uint64_t next_event_tick() const
+    {
+        if (timers_.empty())
+            return no_tick;
+
+        uint64_t next = no_tick;
+        for (int level = 0; level < level_count; ++level)
+        {
+            const int shift = level_bits * level;
+            uint64_t tick = ((current_tick_ >> shift) + 1) << shift; // slots of this level are handled every 2^shift ticks
+            for (size_t i = 0; i < slot_count && tick < next; ++i, tick += uint64_t{1} << shift)
+            {
+                if (!wheel_[level][(tick >> shift) & (slot_count - 1)].empty())
+                {
+                    next = tick;
+                    break;
+                }
+            }
+        }
+        return next;
+    }
+
+    // moves the wheel one tick forward and collects expired callbacks; mtx_ must be held
+    void advance(std::vector<Callback>& expired)
+    {
+        ++current_tick_;
+
+        // cascade: when a lower level wraps, the matching slot of the next level is redistributed
+        int top_level = 0;
+        while (top_level + 1 < level_count && (current_tick_ & ((uint64_t{1} << (level_bits * (top_level + 1))) - 1)) == 0)
+            ++top_level;
+
+        for (int level = top_level; level > 0; --level)
+        {
+            const size_t slot = (current_tick_ >> (level_bits * level)) & (slot_count - 1);
+            Slot cascading = std::exchange(wheel_[level][slot], {});
+            for (TimerId id : cascading)
+            {
+                if (auto it = timers_.find(id); it != timers_.end())
+                    insert(id, it->second.deadline_tick);
+            }
+        }
+
+        Slot due = std::exchange(wheel_[0][current_tick_ & (slot_count - 1)], {});
+        for (TimerId id : due)
+        {
+            auto it = timers_.find(id);
+            if (it == timers_.end()) // cancelled
+                continue;
+
+            if (it->second.deadline_tick > current_tick_) // outermost level wrapped around
+            {
+                insert(id, it->second.deadline_tick);
+                continue;
+            }
+
+            expired.push_back(std::move(it->second.callback));
+            timers_.erase(it);
+        }
+    }
+
+    void run(std::stop_token stop_tkn)
+    {
+        std::vector<Callback> expired;
+        std::unique_lock lk{mtx_};
+
+        while (!stop_tkn.stop_requested())
+        {
+            // sleeps until the wheel has work - not tick by tick; schedule_at() wakes it for an earlier timer
+            const uint64_t planned_tick = next_event_tick();
+            wake_tick_ = planned_tick;
+            if (planned_tick == no_tick)
+                cv_timers_.wait(lk, stop_tkn, [this] { return wake_tick_ != no_tick; });
+            else
+                cv_timers_.wait_until(lk, stop_tkn, to_time_point(planned_tick), [this, planned_tick] { return wake_tick_ != planned_tick; });
+
+            // jumps over ticks without work - after a long sleep the lock is held per event, not per tick
+            const uint64_t now_tick = elapsed_ticks(Clock::now());
+            while (current_tick_ < now_tick)
+            {
+                current_tick_ = std::min(next_event_tick(), now_tick) - 1;
+                advance(expired);
+            }
+
+            if (!expired.empty())
+            {
+                lk.unlock();
+                for (auto& callback : expired)
+                    callback();
+                expired.clear();
+                lk.lock();
+            }
+        }
+    }
+};
+
+#endif // TIMER_SERVICE_HPP
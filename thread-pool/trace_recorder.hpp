@@ -0,0 +1,372 @@
+#ifndef TRACE_RECORDER_HPP
+#define TRACE_RECORDER_HPP
+
+#include "tsc_clock.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <functional>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <set>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Low-overhead tracing of begin/end events - replacement for lifecycle messages printed to std::cout.
+// Every thread records into its own ring buffer (no locks, no allocation after the first event,
+// oldest events are overwritten); buffers outlive their threads and are written at the end of
+// a Trace::Session in Chrome trace-event format (chrome://tracing, ui.perfetto.dev) - after that,
+// buffers of exited threads are reused by new ones.
+// Event names must have static storage duration (string literals) - only the pointer is stored;
+// names built at run time are passed through Trace::intern().
+namespace Trace
+{
+    enum class Phase : char
+    {
+        begin = 'B',
+        end = 'E',
+        instant = 'i'
+    };
+
+    struct Event
+    {
+        uint64_t ticks;
+        const char* name;
+        Phase phase;
+    };
+
+    // single writer (owning thread); read when the session ends
+    class ThreadBuffer
+    {
+    public:
+        static constexpr size_t capacity = 16 * 1024; // power of two
+
+        ThreadBuffer(uint32_t tid, std::string thread_name)
+            : tid_{tid}
+            , thread_name_{std::move(thread_name)}
+        {
+        }
+
+        // hands a recycled buffer to a new thread - no writer is left
+        void reset(uint32_t tid, std::string thread_name)
+        {
+            head_.store(0, std::memory_order_relaxed);
+            exited_.store(false, std::memory_order_relaxed);
+            tid_ = tid;
+            thread_name_ = std::move(thread_name);
+        }
+
+        void record(Phase phase, const char* name)
+        {
+            const uint64_t head = head_.load(std::memory_order_relaxed);
+            events_[head & (capacity - 1)] = Event{TscClock::ticks(), name, phase};
+            head_.store(head + 1, std::memory_order_release);
+        }
+
+        // oldest to newest
+        std::vector<Event> events() const
+        {
+            const uint64_t head = head_.load(std::memory_order_acquire);
+            const uint64_t first = head > capacity ? head - capacity : 0;
+
+            std::vector<Event> result;
+            result.reserve(head - first);
+            for (uint64_t i = first; i < head; ++i)
+                result.push_back(events_[i & (capacity - 1)]);
+            return result;
+        }
+
+        uint32_t tid() const
+        {
+            return tid_;
+        }
+
+        const std::string& thread_name() const
+        {
+            return thread_name_;
+        }
+
+        void set_thread_name(std::string name)
+        {
+            thread_name_ = std::move(name);
+        }
+
+        bool has_exited() const
+        {
+            return exited_.load(std::memory_order_acquire);
+        }
+
+        void mark_exited()
+        {
+            exited_.store(true, std::memory_order_release);
+        }
+
+    private:
+        std::array<Event, capacity> events_;
+        std::atomic<uint64_t> head_{0};
+        std::atomic<bool> exited_{false};
+        uint32_t tid_;
+        std::string thread_name_;
+    };
+
+    class Recorder
+    {
+    public:
+        static Recorder& instance()
+        {
+            static Recorder recorder;
+            return recorder;
+        }
+
+        bool is_enabled() const
+        {
+            return enabled_.load(std::memory_order_relaxed);
+        }
+
+        void enable()
+        {
+            TscClock::ns_per_tick(); // calibrate outside of traced code
+            enabled_.store(true, std::memory_order_relaxed);
+        }
+
+        void disable()
+        {
+            enabled_.store(false, std::memory_order_relaxed);
+        }
+
+        void record(Phase phase, const char* name)
+        {
+            ThreadBuffer* buffer = current_buffer_;
+            if (buffer == nullptr)
+                buffer = register_thread();
+
+            buffer->record(phase, name);
+        }
+
+        // the same pointer for equal names - valid as long as the recorder
+        const char* intern(std::string_view name)
+        {
+            std::lock_guard lk{mtx_names_};
+            auto it = names_.find(name);
+            if (it == names_.end())
+                it = names_.emplace(name).first;
+            return it->c_str();
+        }
+
+        void set_thread_name(std::string name)
+        {
+            if (current_buffer_)
+                current_buffer_->set_thread_name(name);
+            current_thread_name_ = std::move(name);
+        }
+
+        // ring buffers allocated so far, in use or free
+        size_t buffer_count() const
+        {
+            std::lock_guard lk{mtx_buffers_};
+            return buffers_.size() + free_buffers_.size();
+        }
+
+        // call when traced threads are idle or joined - events written concurrently may be torn;
+        // buffers of exited threads are recycled once written
+        void write_chrome_json(std::ostream& out)
+        {
+            std::lock_guard lk{mtx_buffers_};
+
+            std::vector<std::vector<Event>> events;
+            uint64_t first_ticks = UINT64_MAX;
+            for (const auto& buffer : buffers_)
+            {
+                events.push_back(buffer->events());
+                if (!events.back().empty())
+                    first_ticks = std::min(first_ticks, events.back().front().ticks);
+            }
+
+            out << std::fixed << std::setprecision(3); // ts in us with ns resolution
+            out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+
+            const char* separator = "\n";
+            for (size_t i = 0; i < buffers_.size(); ++i)
+            {
+                const auto& buffer = *buffers_[i];
+                out << separator << R"({"name":"thread_name","ph":"M","pid":1,"tid":)" << buffer.tid()
+                    << R"(,"args":{"name":")" << escaped(buffer.thread_name()) << "\"}}";
+                separator = ",\n";
+
+                for (const Event& e : events[i])
+                {
+                    const double ts_us = static_cast<double>(TscClock::to_ns(e.ticks - first_ticks)) / 1000.0;
+                    out << separator << R"({"name":")" << escaped(e.name) << R"(","ph":")" << static_cast<char>(e.phase)
+                        << R"(","ts":)" << ts_us << R"(,"pid":1,"tid":)" << buffer.tid();
+                    if (e.phase == Phase::instant)
+                        out << R"(,"s":"t")";
+                    out << "}";
+                }
+            }
+
+            out << "\n]}\n";
+
+            auto exited = std::ranges::partition(buffers_, [](const auto& buffer) { return !buffer->has_exited(); });
+            std::ranges::move(exited, std::back_inserter(free_buffers_));
+            buffers_.erase(exited.begin(), exited.end());
+        }
+
+    private:
+        std::atomic<bool> enabled_{false};
+        mutable std::mutex mtx_buffers_;
+        std::vector<std::unique_ptr<ThreadBuffer>> buffers_; // kept after threads exit - until written
+        std::vector<std::unique_ptr<ThreadBuffer>> free_buffers_; // of exited threads, already written
+        std::mutex mtx_names_;
+        std::set<std::string, std::less<>> names_; // interned - nodes never move
+
+        // marks the thread's buffer as free for reuse once it is written
+        struct ThreadExit
+        {
+            ~ThreadExit()
+            {
+                if (current_buffer_)
+                    std::exchange(current_buffer_, nullptr)->mark_exited();
+            }
+        };
+
+        inline static thread_local ThreadBuffer* current_buffer_ = nullptr;
+        inline static thread_local std::string current_thread_name_;
+        inline static thread_local ThreadExit thread_exit_;
+
+        uint32_t next_tid_ = 1; // never reused - a recycled buffer is a new thread in the trace
+
+        Recorder() = default;
+
+        ThreadBuffer* register_thread()
+        {
+            std::lock_guard lk{mtx_buffers_};
+
+            const uint32_t tid = next_tid_++;
+            std::string name = current_thread_name_.empty() ? "thread #" + std::to_string(tid) : current_thread_name_;
+            if (free_buffers_.empty())
+            {
+                buffers_.push_back(std::make_unique<ThreadBuffer>(tid, std::move(name)));
+            }
+            else
+            {
+                buffers_.push_back(std::move(free_buffers_.back()));
+                free_buffers_.pop_back();
+                buffers_.back()->reset(tid, std::move(name));
+            }
+            current_buffer_ = buffers_.back().get();
+            (void)thread_exit_; // constructs the guard - destroyed when the thread exits
+
+            return current_buffer_;
+        }
+
+        static std::string escaped(std::string_view text)
+        {
+            std::string result;
+            for (char c : text)
+            {
+                if (c == '"' || c == '\\')
+                    result += '\\';
+                result += c;
+            }
+            return result;
+        }
+    };
+
+    inline bool is_enabled()
+    {
+        return Recorder::instance().is_enabled();
+    }
+
+    inline void begin(const char* name)
+    {
+        if (is_enabled())
+            Recorder::instance().record(Phase::begin, name);
+    }
+
+    inline void end(const char* name)
+    {
+        if (is_enabled())
+            Recorder::instance().record(Phase::end, name);
+    }
+
+    inline void instant(const char* name)
+    {
+        if (is_enabled())
+            Recorder::instance().record(Phase::instant, name);
+    }
+
+    // event name with static storage duration for a string built at run time (not for hot paths - takes a lock)
+    inline const char* intern(std::string_view name)
+    {
+        return Recorder::instance().intern(name);
+    }
+
+    // shown in the trace instead of "thread #n"
+    inline void set_thread_name(std::string name)
+    {
+        Recorder::instance().set_thread_name(std::move(name));
+    }
+
+    // RAII - begin/end pair; an end is recorded only if the begin was
+    class Scope
+    {
+        const char* name_;
+        bool recorded_;
+
+    public:
+        explicit Scope(const char* name)
+            : name_{name}
+            , recorded_{is_enabled()}
+        {
+            if (recorded_)
+                Recorder::instance().record(Phase::begin, name_);
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+        ~Scope()
+        {
+            if (recorded_)
+                Recorder::instance().record(Phase::end, name_);
+        }
+    };
+
+    // RAII - records while alive, writes the trace file on destruction;
+    // nullptr path (e.g. unset environment variable) disables tracing
+    class Session
+    {
+        std::string path_;
+
+    public:
+        explicit Session(const char* path)
+            : path_{path ? path : ""}
+        {
+            if (!path_.empty())
+                Recorder::instance().enable();
+        }
+
+        Session(const Session&) = delete;
+        Session& operator=(const Session&) = delete;
+
+        ~Session()
+        {
+            if (path_.empty())
+                return;
+
+            Recorder::instance().disable();
+            std::ofstream out{path_};
+            Recorder::instance().write_chrome_json(out);
+        }
+    };
+} // namespace Trace
+
+#endif // TRACE_RECORDER_HPP
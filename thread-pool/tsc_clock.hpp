@@ -0,0 +1,62 @@
+#ifndef TSC_CLOCK_HPP
+#define TSC_CLOCK_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define TSC_CLOCK_HAS_RDTSC 1
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#endif
+
+// Cheap timestamps for instrumentation - reads the time stamp counter (assumes invariant TSC),
+// falls back to steady_clock on other architectures. Ticks are converted to ns with a
+// ratio calibrated once against steady_clock.
+class TscClock
+{
+public:
+    static uint64_t ticks()
+    {
+#ifdef TSC_CLOCK_HAS_RDTSC
+        return __rdtsc();
+#else
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+    }
+
+    static uint64_t to_ns(uint64_t ticks)
+    {
+        return static_cast<uint64_t>(static_cast<double>(ticks) * ns_per_tick());
+    }
+
+    static double ns_per_tick()
+    {
+        static const double ratio = calibrate();
+        return ratio;
+    }
+
+private:
+    static double calibrate()
+    {
+#ifdef TSC_CLOCK_HAS_RDTSC
+        const auto start_time = std::chrono::steady_clock::now();
+        const uint64_t start_ticks = ticks();
+
+        std::this_thread::sleep_for(std::chrono::milliseconds{20});
+
+        const uint64_t elapsed_ticks = ticks() - start_ticks;
+        const auto elapsed_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_time).count();
+
+        return static_cast<double>(elapsed_ns) / static_cast<double>(elapsed_ticks);
+#else
+        return 1.0; // ticks are already nanoseconds
+#endif
+    }
+};
+
+#endif // TSC_CLOCK_HPP
@@ -0,0 +1,207 @@
+#ifndef WORKER_TEAM_HPP
+#define WORKER_TEAM_HPP
+
+#include "cache_line.hpp"
+
+#include <barrier>
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "trace_recorder.hpp"
+
+// Persistent team of threads for bulk-synchronous iterative algorithms (stencils, fixed-point solvers):
+// run(body) starts body(member) on every member at once - the calling thread is member 0 - and
+// the members step through the iterations together, separated by phases of one std::barrier.
+// Threads are started once, so an iteration costs a barrier instead of spawning and joining threads.
+//
+//   WorkerTeam team{4};
+//   team.run([&](WorkerTeam::Member& member) {
+//       auto [first, last] = member.range(cells.size());
+//       for (double delta = 1.0; delta > epsilon;)
+//       {
+//           double local = relax(first, last);
+//           delta = member.reduce(local, [](double a, double b) { return std::max(a, b); }); // ends the phase
+//       }
+//   });
+//
+// barrier(), single() and reduce() are collective: every member has to call them, in the same order.
+// body must not throw - a member leaving early would keep the others waiting at the barrier for ever.
+class WorkerTeam
+{
+    using PhaseStep = void (*)(WorkerTeam& team, void* arg);
+
+    // runs once per phase, after the last member has arrived and before any of them goes on
+    struct PhaseCompletion
+    {
+        WorkerTeam* team;
+
+        void operator()() noexcept
+        {
+            if (PhaseStep step = std::exchange(team->phase_step_, nullptr))
+                step(*team, team->phase_arg_);
+        }
+    };
+
+    struct alignas(cache_line_size) ReductionSlot
+    {
+        const void* value;
+        void* result;
+    };
+
+public:
+    class Member
+    {
+        WorkerTeam& team_;
+        const size_t rank_;
+
+    public:
+        Member(WorkerTeam& team, size_t rank)
+            : team_{team}
+            , rank_{rank}
+        {
+        }
+
+        size_t rank() const
+        {
+            return rank_;
+        }
+
+        size_t size() const
+        {
+            return team_.size();
+        }
+
+        // [first, last) - this member's share of [0, count); shares differ by at most one
+        std::pair<size_t, size_t> range(size_t count) const
+        {
+            const size_t share = count / size();
+            const size_t rest = count % size();
+            const size_t first = rank_ * share + std::min(rank_, rest);
+            return {first, first + share + (rank_ < rest ? 1 : 0)};
+        }
+
+        // ends the phase - writes of all members before it are visible to all members after it
+        void barrier()
+        {
+            team_.barrier_.arrive_and_wait();
+        }
+
+        // f() runs once (member 0's copy) between the phases - e.g. to swap shared buffers or check convergence
+        template <typename F>
+        void single(F f)
+        {
+            if (rank_ == 0)
+                team_.set_phase_step([](WorkerTeam&, void* f) { (*static_cast<F*>(f))(); }, &f);
+            barrier();
+        }
+
+        // op-fold of the values of all members, in rank order (member 0's op); every member gets the result
+        template <typename T, typename Op = std::plus<>>
+        T reduce(const T& value, Op op = {})
+        {
+            T result = value;
+            team_.slots_[rank_] = {&value, &result};
+            if (rank_ == 0)
+                team_.set_phase_step(&fold<T, Op>, &op);
+            barrier();
+            return result;
+        }
+
+    private:
+        template <typename T, typename Op>
+        static void fold(WorkerTeam& team, void* op)
+        {
+            T total = *static_cast<const T*>(team.slots_[0].value);
+            for (size_t i = 1; i < team.size(); ++i)
+                total = (*static_cast<Op*>(op))(std::move(total), *static_cast<const T*>(team.slots_[i].value));
+            for (size_t i = 0; i < team.size(); ++i)
+                *static_cast<T*>(team.slots_[i].result) = total;
+        }
+    };
+
+    explicit WorkerTeam(size_t size = std::thread::hardware_concurrency())
+        : size_{std::max<size_t>(size, 1)}
+        , barrier_{static_cast<std::ptrdiff_t>(size_), PhaseCompletion{this}}
+        , slots_{std::make_unique<ReductionSlot[]>(size_)}
+    {
+        threads_.reserve(size_ - 1);
+        for (size_t rank = 1; rank < size_; ++rank)
+            threads_.emplace_back([this, rank] { work(rank); });
+    }
+
+    WorkerTeam(const WorkerTeam&) = delete;
+    WorkerTeam& operator=(const WorkerTeam&) = delete;
+
+    ~WorkerTeam()
+    {
+        stopping_ = true;
+        barrier_.arrive_and_wait(); // workers wake up as for a run and leave
+    }
+
+    size_t size() const
+    {
+        return size_;
+    }
+
+    // body(Member&) on every member; returns when all of them have finished.
+    // Not reentrant - one run at a time, from one controlling thread.
+    template <typename F>
+    void run(F body)
+    {
+        body_ = [](void* body, Member& member) { (*static_cast<F*>(body))(member); };
+        body_arg_ = &body;
+
+        barrier_.arrive_and_wait(); // start
+        Member self{*this, 0};
+        invoke_body(self);
+        barrier_.arrive_and_wait(); // end - nobody uses body any more
+    }
+
+private:
+    const size_t size_;
+    std::barrier<PhaseCompletion> barrier_;
+    std::unique_ptr<ReductionSlot[]> slots_;
+
+    // published by the thread that arrives before the phase ends, read by all after it
+    PhaseStep phase_step_ = nullptr;
+    void* phase_arg_ = nullptr;
+    void (*body_)(void* body, Member& member) = nullptr;
+    void* body_arg_ = nullptr;
+    bool stopping_ = false;
+
+    std::vector<std::jthread> threads_;
+
+    void set_phase_step(PhaseStep step, void* arg)
+    {
+        assert(phase_step_ == nullptr && "Collective operation called by some of the members only");
+        phase_step_ = step;
+        phase_arg_ = arg;
+    }
+
+    void invoke_body(Member& member) noexcept
+    {
+        body_(body_arg_, member);
+    }
+
+    void work(size_t rank)
+    {
+        Trace::set_thread_name("team member #" + std::to_string(rank));
+        Member self{*this, rank};
+        while (true)
+        {
+            barrier_.arrive_and_wait(); // start
+            if (stopping_)
+                return;
+            invoke_body(self);
+            barrier_.arrive_and_wait(); // end
+        }
+    }
+};
+
+#endif // WORKER_TEAM_HPP
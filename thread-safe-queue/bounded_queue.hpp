@@ -0,0 +1,131 @@
+#ifndef BOUNDED_QUEUE_HPP
+#define BOUNDED_QUEUE_HPP
+
+#include "ring_buffer.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <queue>
+
+// Blocking MPMC queue with a fixed capacity - a full queue blocks its producers, which is how
+// backpressure travels upstream through a chain of queues.
+// close() ends the stream: pending and later pushes fail, pops drain the remaining items and then fail.
+template <typename T, typename TContainer = RingBuffer<T>>
+class BoundedQueue
+{
+    std::queue<T, TContainer> q_;
+    const size_t capacity_;
+    bool closed_ = false;
+    mutable std::mutex mtx_q_;
+    std::condition_variable cv_q_not_empty_;
+    std::condition_variable cv_q_not_full_;
+public:
+    explicit BoundedQueue(size_t capacity)
+        : capacity_{std::max<size_t>(capacity, 1)}
+    {
+    }
+
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+    size_t capacity() const
+    {
+        return capacity_;
+    }
+
+    size_t size() const
+    {
+        std::lock_guard lk{mtx_q_};
+        return q_.size();
+    }
+
+    bool empty() const
+    {
+        std::lock_guard lk{mtx_q_};
+        return q_.empty();
+    }
+
+    // blocks while the queue is full; false (and the item left untouched) when the queue is closed
+    bool push(T&& item)
+    {
+        {
+            std::unique_lock lk{mtx_q_};
+            cv_q_not_full_.wait(lk, [this] { return q_.size() < capacity_ || closed_; });
+            if (closed_)
+                return false;
+            q_.push(std::move(item));
+        }
+
+        cv_q_not_empty_.notify_one();
+        return true;
+    }
+
+    // false when the queue is full or closed - the item is moved from only on success
+    bool try_push(T&& item)
+    {
+        {
+            std::lock_guard lk{mtx_q_};
+            if (closed_ || q_.size() == capacity_)
+                return false;
+            q_.push(std::move(item));
+        }
+
+        cv_q_not_empty_.notify_one();
+        return true;
+    }
+
+    // blocks until an item is available; false only when the queue is closed and drained
+    bool pop(T& item)
+    {
+        {
+            std::unique_lock lk{mtx_q_};
+            cv_q_not_empty_.wait(lk, [this] { return !q_.empty() || closed_; });
+            if (q_.empty())
+                return false;
+
+            item = std::move(q_.front());
+            q_.pop();
+        }
+
+        cv_q_not_full_.notify_one();
+        return true;
+    }
+
+    std::optional<T> pop()
+    {
+        std::optional<T> item;
+        {
+            std::unique_lock lk{mtx_q_};
+            cv_q_not_empty_.wait(lk, [this] { return !q_.empty() || closed_; });
+            if (q_.empty())
+                return std::nullopt;
+
+            item.emplace(std::move(q_.front()));
+            q_.pop();
+        }
+
+        cv_q_not_full_.notify_one();
+        return item;
+    }
+
+    void close()
+    {
+        {
+            std::lock_guard lk{mtx_q_};
+            closed_ = true;
+        }
+
+        cv_q_not_empty_.notify_all();
+        cv_q_not_full_.notify_all();
+    }
+
+    bool is_closed() const
+    {
+        std::lock_guard lk{mtx_q_};
+        return closed_;
+    }
+};
+
+#endif // BOUNDED_QUEUE_HPP
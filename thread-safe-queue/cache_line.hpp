@@ -0,0 +1,10 @@
+#ifndef CACHE_LINE_HPP
+#define CACHE_LINE_HPP
+
+#include <cstddef>
+
+// alignment that keeps data written by different threads on separate cache lines
+// (std::hardware_destructive_interference_size is not ABI-stable - gcc warns when it is used in headers)
+inline constexpr size_t cache_line_size = 64;
+
+#endif // CACHE_LINE_HPP
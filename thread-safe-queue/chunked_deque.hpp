@@ -0,0 +1,215 @@
+#ifndef CHUNKED_DEQUE_HPP
+#define CHUNKED_DEQUE_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+
+// default: chunks of ~4KB, but never fewer than 8 items
+template <typename T>
+constexpr size_t default_chunk_size = std::max<size_t>(8, 4096 / sizeof(T));
+
+// FIFO storage for std::queue / ThreadSafeQueue: a singly linked list of fixed-size chunks.
+// Chunks drained by pop_front go to a node pool and are reused by push_back, so a queue
+// that stays within its high-water mark does not allocate at all.
+// Only the operations needed by std::queue are provided.
+template <typename T, size_t ChunkSize = default_chunk_size<T>, size_t MaxSpareChunks = 16>
+class ChunkedDeque
+{
+    static_assert(ChunkSize > 0);
+
+    struct Chunk
+    {
+        alignas(T) std::byte storage[sizeof(T) * ChunkSize];
+        Chunk* next = nullptr;
+
+        T* slot(size_t index)
+        {
+            return reinterpret_cast<T*>(storage) + index;
+        }
+    };
+
+    Chunk* head_ = nullptr; // front item lives here
+    Chunk* tail_ = nullptr; // back item lives here
+    size_t head_index_ = 0;
+    size_t tail_index_ = 0; // one past the back item
+    size_t size_ = 0;
+
+    Chunk* spare_ = nullptr; // node pool
+    size_t spare_count_ = 0;
+
+public:
+    using value_type = T;
+    using size_type = size_t;
+    using reference = T&;
+    using const_reference = const T&;
+
+    ChunkedDeque() = default;
+
+    ChunkedDeque(const ChunkedDeque&) = delete;
+    ChunkedDeque& operator=(const ChunkedDeque&) = delete;
+
+    ChunkedDeque(ChunkedDeque&& other) noexcept
+        : head_{std::exchange(other.head_, nullptr)}
+        , tail_{std::exchange(other.tail_, nullptr)}
+        , head_index_{std::exchange(other.head_index_, 0)}
+        , tail_index_{std::exchange(other.tail_index_, 0)}
+        , size_{std::exchange(other.size_, 0)}
+        , spare_{std::exchange(other.spare_, nullptr)}
+        , spare_count_{std::exchange(other.spare_count_, 0)}
+    {
+    }
+
+    ChunkedDeque& operator=(ChunkedDeque&& other) noexcept
+    {
+        if (this != &other)
+        {
+            ChunkedDeque temp{std::move(other)};
+            swap(temp);
+        }
+        return *this;
+    }
+
+    ~ChunkedDeque()
+    {
+        while (!empty())
+            pop_front();
+
+        delete_chunks(head_);
+        delete_chunks(spare_);
+    }
+
+    void swap(ChunkedDeque& other) noexcept
+    {
+        std::swap(head_, other.head_);
+        std::swap(tail_, other.tail_);
+        std::swap(head_index_, other.head_index_);
+        std::swap(tail_index_, other.tail_index_);
+        std::swap(size_, other.size_);
+        std::swap(spare_, other.spare_);
+        std::swap(spare_count_, other.spare_count_);
+    }
+
+    bool empty() const
+    {
+        return size_ == 0;
+    }
+
+    size_t size() const
+    {
+        return size_;
+    }
+
+    size_t spare_chunks() const
+    {
+        return spare_count_;
+    }
+
+    T& front()
+    {
+        assert(!empty());
+        return *std::launder(head_->slot(head_index_));
+    }
+
+    const T& front() const
+    {
+        return const_cast<ChunkedDeque&>(*this).front();
+    }
+
+    T& back()
+    {
+        assert(!empty());
+        return *std::launder(tail_->slot(tail_index_ - 1));
+    }
+
+    const T& back() const
+    {
+        return const_cast<ChunkedDeque&>(*this).back();
+    }
+
+    void push_back(const T& item)
+    {
+        emplace_back(item);
+    }
+
+    void push_back(T&& item)
+    {
+        emplace_back(std::move(item));
+    }
+
+    template <typename... TArgs>
+    T& emplace_back(TArgs&&... args)
+    {
+        if (tail_ == nullptr)
+        {
+            head_ = tail_ = acquire_chunk();
+        }
+        else if (tail_index_ == ChunkSize)
+        {
+            tail_->next = acquire_chunk();
+            tail_ = tail_->next;
+            tail_index_ = 0;
+        }
+
+        T* item = std::construct_at(tail_->slot(tail_index_), std::forward<TArgs>(args)...);
+        ++tail_index_;
+        ++size_;
+        return *item;
+    }
+
+    void pop_front()
+    {
+        assert(!empty());
+        std::destroy_at(std::launder(head_->slot(head_index_)));
+        ++head_index_;
+        --size_;
+
+        if (size_ == 0)
+        {
+            // head_ == tail_ - restart the chunk from the beginning, so a queue oscillating
+            // around empty never touches the node pool
+            head_index_ = tail_index_ = 0;
+        }
+        else if (head_index_ == ChunkSize)
+        {
+            release_chunk(std::exchange(head_, head_->next));
+            head_index_ = 0;
+        }
+    }
+
+private:
+    Chunk* acquire_chunk()
+    {
+        if (spare_ == nullptr)
+            return new Chunk; // storage left uninitialized
+
+        Chunk* chunk = std::exchange(spare_, spare_->next);
+        chunk->next = nullptr;
+        --spare_count_;
+        return chunk;
+    }
+
+    void release_chunk(Chunk* chunk)
+    {
+        if (spare_count_ == MaxSpareChunks)
+        {
+            delete chunk;
+            return;
+        }
+
+        chunk->next = spare_;
+        spare_ = chunk;
+        ++spare_count_;
+    }
+
+    static void delete_chunks(Chunk* chunk)
+    {
+        while (chunk != nullptr)
+            delete std::exchange(chunk, chunk->next);
+    }
+};
+
+#endif // CHUNKED_DEQUE_HPP
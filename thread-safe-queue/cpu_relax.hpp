@@ -0,0 +1,22 @@
+#ifndef CPU_RELAX_HPP
+#define CPU_RELAX_HPP
+
+#include <thread>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <immintrin.h>
+#endif
+
+// hint for the core that the thread is spinning (frees pipeline resources for the hyper-thread sibling)
+inline void cpu_relax()
+{
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    _mm_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#else
+    std::this_thread::yield();
+#endif
+}
+
+#endif // CPU_RELAX_HPP
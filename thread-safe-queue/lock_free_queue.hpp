@@ -0,0 +1,135 @@
+#ifndef LOCK_FREE_QUEUE_HPP
+#define LOCK_FREE_QUEUE_HPP
+
+#include "cache_line.hpp"
+#include "reclamation.hpp"
+
+#include <atomic>
+#include <optional>
+#include <utility>
+
+// Michael-Scott queue - MPMC, unbounded, lock-free push and pop.
+// head_ points at a dummy node: the item at the front lives in head_->next, and popping it turns that node
+// into the new dummy and retires the old one to the reclamation domain.
+// A stalled thread never blocks the others - a lagging tail_ is helped forward by whoever finds it behind.
+template <typename T, typename TDomain = Reclamation::EpochDomain>
+class LockFreeQueue
+{
+    struct Node
+    {
+        std::optional<T> value; // empty in the dummy
+        std::atomic<Node*> next{nullptr};
+    };
+
+    // producers and consumers work on opposite ends - keep them off each other's cache line
+    alignas(cache_line_size) std::atomic<Node*> head_;
+    alignas(cache_line_size) std::atomic<Node*> tail_;
+    TDomain& domain_;
+
+public:
+    explicit LockFreeQueue(TDomain& domain = TDomain::global())
+        : domain_{domain}
+    {
+        auto* dummy = new Node;
+        head_.store(dummy, std::memory_order_relaxed);
+        tail_.store(dummy, std::memory_order_relaxed);
+    }
+
+    LockFreeQueue(const LockFreeQueue&) = delete;
+    LockFreeQueue& operator=(const LockFreeQueue&) = delete;
+
+    // no other thread may use the queue any more
+    ~LockFreeQueue()
+    {
+        for (Node* node = head_.load(std::memory_order_acquire); node != nullptr;)
+            delete std::exchange(node, node->next.load(std::memory_order_relaxed));
+    }
+
+    // a snapshot
+    bool empty() const
+    {
+        auto guard = domain_.pin();
+        return guard.protect(head_)->next.load(std::memory_order_acquire) == nullptr;
+    }
+
+    void push(const T& item)
+    {
+        emplace(item);
+    }
+
+    void push(T&& item)
+    {
+        emplace(std::move(item));
+    }
+
+    template <typename... TArgs>
+    void emplace(TArgs&&... args)
+    {
+        auto* node = new Node;
+        node->value.emplace(std::forward<TArgs>(args)...);
+
+        auto guard = domain_.pin();
+        while (true)
+        {
+            Node* tail = guard.protect(tail_);
+            Node* next = tail->next.load(std::memory_order_acquire);
+            if (next != nullptr)
+            {
+                tail_.compare_exchange_weak(tail, next, std::memory_order_release, std::memory_order_relaxed); // help a lagging tail
+                continue;
+            }
+
+            if (tail->next.compare_exchange_weak(next, node, std::memory_order_release, std::memory_order_relaxed))
+            {
+                tail_.compare_exchange_strong(tail, node, std::memory_order_release, std::memory_order_relaxed);
+                return;
+            }
+        }
+    }
+
+    std::optional<T> try_pop()
+    {
+        std::optional<T> item;
+        {
+            auto head_guard = domain_.pin();
+            auto next_guard = domain_.pin();
+            while (true)
+            {
+                Node* head = head_guard.protect(head_);
+                Node* next = next_guard.protect(head->next);
+                if (head != head_.load(std::memory_order_acquire))
+                    continue; // head was popped (and may be retired) while next was read
+
+                if (next == nullptr)
+                    return std::nullopt;
+
+                Node* tail = tail_.load(std::memory_order_acquire);
+                if (head == tail)
+                {
+                    tail_.compare_exchange_weak(tail, next, std::memory_order_release, std::memory_order_relaxed); // help a lagging tail
+                    continue;
+                }
+
+                if (head_.compare_exchange_weak(head, next, std::memory_order_acq_rel, std::memory_order_relaxed))
+                {
+                    item = std::move(next->value); // next is the new dummy - only the winner touches its value
+                    next->value.reset();
+                    domain_.retire(head);
+                    break;
+                }
+            }
+        }
+        return item;
+    }
+
+    bool try_pop(T& item)
+    {
+        auto popped = try_pop();
+        if (!popped)
+            return false;
+        item = std::move(*popped);
+        return true;
+    }
+};
+
+#endif // LOCK_FREE_QUEUE_HPP
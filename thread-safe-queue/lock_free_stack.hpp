@@ -0,0 +1,96 @@
+#ifndef LOCK_FREE_STACK_HPP
+#define LOCK_FREE_STACK_HPP
+
+#include "reclamation.hpp"
+
+#include <atomic>
+#include <optional>
+#include <utility>
+
+// Treiber stack - MPMC, lock-free push and pop.
+// Popped nodes are retired to the reclamation domain, so a popping thread never reads a freed node
+// and a node address cannot be reused while another thread still compares against it (no ABA).
+template <typename T, typename TDomain = Reclamation::EpochDomain>
+class LockFreeStack
+{
+    struct Node
+    {
+        T value;
+        Node* next = nullptr;
+    };
+
+    std::atomic<Node*> head_{nullptr};
+    TDomain& domain_;
+
+public:
+    explicit LockFreeStack(TDomain& domain = TDomain::global())
+        : domain_{domain}
+    {
+    }
+
+    LockFreeStack(const LockFreeStack&) = delete;
+    LockFreeStack& operator=(const LockFreeStack&) = delete;
+
+    // no other thread may use the stack any more
+    ~LockFreeStack()
+    {
+        for (Node* node = head_.load(std::memory_order_acquire); node != nullptr;)
+            delete std::exchange(node, node->next);
+    }
+
+    // a snapshot
+    bool empty() const
+    {
+        return head_.load(std::memory_order_acquire) == nullptr;
+    }
+
+    void push(const T& item)
+    {
+        emplace(item);
+    }
+
+    void push(T&& item)
+    {
+        emplace(std::move(item));
+    }
+
+    template <typename... TArgs>
+    void emplace(TArgs&&... args)
+    {
+        auto* node = new Node{T(std::forward<TArgs>(args)...)};
+        node->next = head_.load(std::memory_order_relaxed);
+        while (!head_.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    std::optional<T> try_pop()
+    {
+        std::optional<T> item;
+        {
+            auto guard = domain_.pin();
+            Node* head;
+            do
+            {
+                head = guard.protect(head_);
+                if (head == nullptr)
+                    return std::nullopt;
+            } while (!head_.compare_exchange_weak(head, head->next, std::memory_order_acquire, std::memory_order_relaxed));
+
+            item.emplace(std::move(head->value)); // the node is ours now - others only read its next
+            domain_.retire(head);
+        }
+        return item;
+    }
+
+    bool try_pop(T& item)
+    {
+        auto popped = try_pop();
+        if (!popped)
+            return false;
+        item = std::move(*popped);
+        return true;
+    }
+};
+
+#endif // LOCK_FREE_STACK_HPP
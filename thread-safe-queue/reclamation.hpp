@@ -0,0 +1,440 @@
+#ifndef RECLAMATION_HPP
+#define RECLAMATION_HPP
+
+#include "thread_slots.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// Safe memory reclamation for lock-free structures: memory unlinked from a structure is retired instead of
+// deleted and freed once no thread can still hold a pointer to it. Both domains share one interface:
+//
+//   auto guard = domain.pin();
+//   Node* node = guard.protect(head);     // readers - the node stays alive while the guard does
+//   ...
+//   domain.retire(unlinked_node);         // writers - deleted when no guard can see it any more
+//
+// EpochDomain - a guard protects everything reachable while it lives: a pin is a store and a fence,
+//   protect() a plain load. A thread stalled inside a pin blocks reclamation for everybody (memory grows
+//   without bound until it unpins) - keep guards short.
+// HazardDomain - a guard protects the single pointer it was last given: protect() publishes the pointer
+//   and re-validates it, which costs a fence per pointer, but unreclaimed memory stays bounded - a thread holds
+//   back at most max(64, 2 * hazards in use) objects, no matter what the other threads do.
+//
+// A domain must outlive the guards taken on it; threads may exit before or after the domain dies (see ThreadSlots).
+namespace Reclamation
+{
+    namespace Detail
+    {
+        struct Retired
+        {
+            void* ptr;
+            void (*deleter)(void*);
+            uint64_t epoch; // epoch domain only
+        };
+
+        inline constexpr size_t collect_threshold = 64; // retired objects per thread before it tries to reclaim
+
+        inline void free_all(std::vector<Retired>& retired)
+        {
+            for (const auto& r : retired)
+                r.deleter(r.ptr);
+            retired.clear();
+        }
+
+        struct RecordBase : ThreadSlot
+        {
+            std::vector<Retired> retired;          // owner only
+            size_t collect_at = collect_threshold; // owner only - retired size that triggers the next collect
+
+            ~RecordBase()
+            {
+                free_all(retired);
+            }
+        };
+
+        // per-thread records of a domain and what threads leave behind when they exit;
+        // TRecord derives from RecordBase and resets its own state in reset()
+        template <typename TRecord>
+        class Records
+        {
+            std::atomic<size_t> retired_count_{0};
+            std::mutex mtx_orphans_;
+            std::vector<Retired> orphans_; // left behind by exited threads
+            ThreadSlots<TRecord> slots_{[this](TRecord& record) { release(record); }};
+
+            void release(TRecord& record)
+            {
+                {
+                    std::lock_guard lk{mtx_orphans_};
+                    orphans_.insert(orphans_.end(), record.retired.begin(), record.retired.end());
+                }
+                record.retired.clear();
+                record.collect_at = collect_threshold;
+                record.reset();
+            }
+
+        public:
+            Records() = default;
+            Records(const Records&) = delete;
+            Records& operator=(const Records&) = delete;
+
+            // no guard may be alive - everything still retired is freed (records with slots_)
+            ~Records()
+            {
+                slots_.close(); // exiting threads no longer move their retired lists to orphans_
+                free_all(orphans_);
+            }
+
+            TRecord& local()
+            {
+                return slots_.local();
+            }
+
+            // all records ever created, including released ones
+            template <typename F>
+            void for_each(F f) const
+            {
+                slots_.for_each(f);
+            }
+
+            // true when the thread should collect
+            bool add_retired(TRecord& record, Retired retired)
+            {
+                record.retired.push_back(retired);
+                retired_count_.fetch_add(1, std::memory_order_relaxed);
+                return record.retired.size() >= record.collect_at;
+            }
+
+            // frees the entries of this thread (and of exited threads, unless another thread is at it) that are not is_protected
+            template <typename F>
+            void free_unprotected(TRecord& record, F is_protected)
+            {
+                size_t freed = free_if(record.retired, is_protected);
+
+                std::unique_lock lk{mtx_orphans_, std::try_to_lock};
+                if (lk.owns_lock() && !orphans_.empty())
+                    freed += free_if(orphans_, is_protected);
+
+                retired_count_.fetch_sub(freed, std::memory_order_relaxed);
+            }
+
+            size_t retired_count() const
+            {
+                return retired_count_.load(std::memory_order_relaxed);
+            }
+
+        private:
+            template <typename F>
+            static size_t free_if(std::vector<Retired>& retired, F is_protected)
+            {
+                auto unprotected = std::partition(retired.begin(), retired.end(), is_protected);
+                const auto freed = static_cast<size_t>(retired.end() - unprotected);
+                for (auto it = unprotected; it != retired.end(); ++it)
+                    it->deleter(it->ptr);
+                retired.erase(unprotected, retired.end());
+                return freed;
+            }
+        };
+    } // namespace Detail
+
+    class EpochDomain
+    {
+        static constexpr uint64_t inactive = ~uint64_t{0};
+
+        struct ThreadRecord : Detail::RecordBase
+        {
+            std::atomic<uint64_t> epoch{inactive}; // observed global epoch while pinned
+            size_t nesting = 0;                    // owner only
+            uint64_t collected_epoch = 0;          // owner only - global epoch at the last scan of retired
+
+            void reset()
+            {
+                nesting = 0;
+                collected_epoch = 0;
+                epoch.store(inactive, std::memory_order_release);
+            }
+        };
+
+    public:
+        class Guard
+        {
+            EpochDomain* domain_;
+            ThreadRecord* record_;
+
+            friend class EpochDomain;
+
+            Guard(EpochDomain& domain, ThreadRecord& record)
+                : domain_{&domain}
+                , record_{&record}
+            {
+            }
+
+        public:
+            Guard(Guard&& other) noexcept
+                : domain_{std::exchange(other.domain_, nullptr)}
+                , record_{std::exchange(other.record_, nullptr)}
+            {
+            }
+
+            Guard(const Guard&) = delete;
+            Guard& operator=(const Guard&) = delete;
+            Guard& operator=(Guard&&) = delete;
+
+            ~Guard()
+            {
+                if (record_ != nullptr)
+                    domain_->unpin(*record_);
+            }
+
+            // the pin already protects everything - a plain load
+            template <typename T>
+            T* protect(const std::atomic<T*>& src)
+            {
+                return src.load(std::memory_order_acquire);
+            }
+        };
+
+        EpochDomain() = default;
+        EpochDomain(const EpochDomain&) = delete;
+        EpochDomain& operator=(const EpochDomain&) = delete;
+
+        static EpochDomain& global()
+        {
+            static EpochDomain domain;
+            return domain;
+        }
+
+        // reentrant - nested guards of a thread share the outermost pin
+        [[nodiscard]] Guard pin()
+        {
+            ThreadRecord& record = records_.local();
+            if (record.nesting++ == 0)
+            {
+                record.epoch.store(global_epoch_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst); // the epoch is visible before any pointer is read
+            }
+            return Guard{*this, record};
+        }
+
+        template <typename T>
+        void retire(T* ptr)
+        {
+            retire(static_cast<void*>(ptr), [](void* p) { delete static_cast<T*>(p); });
+        }
+
+        // ptr must already be unreachable for threads pinning from now on
+        void retire(void* ptr, void (*deleter)(void*))
+        {
+            ThreadRecord& record = records_.local();
+            if (records_.add_retired(record, Detail::Retired{ptr, deleter, global_epoch_.load(std::memory_order_seq_cst)}))
+                collect(record);
+        }
+
+        // advances the epoch if possible and frees what became safe on this thread
+        void collect()
+        {
+            collect(records_.local());
+        }
+
+        uint64_t epoch() const
+        {
+            return global_epoch_.load(std::memory_order_relaxed);
+        }
+
+        // retired and not yet freed, all threads - a snapshot
+        size_t retired_count() const
+        {
+            return records_.retired_count();
+        }
+
+    private:
+        std::atomic<uint64_t> global_epoch_{0};
+        Detail::Records<ThreadRecord> records_;
+
+        void unpin(ThreadRecord& record)
+        {
+            if (--record.nesting == 0)
+                record.epoch.store(inactive, std::memory_order_release);
+        }
+
+        bool try_advance()
+        {
+            uint64_t epoch = global_epoch_.load(std::memory_order_seq_cst);
+            bool all_observed = true;
+            records_.for_each([epoch, &all_observed](const ThreadRecord& record) {
+                const uint64_t observed = record.epoch.load(std::memory_order_seq_cst);
+                all_observed = all_observed && (observed == inactive || observed == epoch); // else a reader still lives in the previous epoch
+            });
+            return all_observed && global_epoch_.compare_exchange_strong(epoch, epoch + 1, std::memory_order_acq_rel);
+        }
+
+        // retired in epoch e - safe once the global epoch reaches e + 2;
+        // nothing new can be freed until the epoch moves, so a stalled reader costs a record walk, not a scan
+        void collect(ThreadRecord& record)
+        {
+            try_advance();
+            const uint64_t global = global_epoch_.load(std::memory_order_acquire);
+            if (global != record.collected_epoch)
+            {
+                records_.free_unprotected(record, [global](const Detail::Retired& r) { return r.epoch + 2 > global; });
+                record.collected_epoch = global;
+            }
+            record.collect_at = record.retired.size() + Detail::collect_threshold;
+        }
+    };
+
+    class HazardDomain
+    {
+    public:
+        static constexpr size_t slots_per_thread = 4; // guards a thread may hold at the same time
+
+    private:
+        struct ThreadRecord : Detail::RecordBase
+        {
+            std::array<std::atomic<void*>, slots_per_thread> hazards{};
+            unsigned used_slots = 0; // owner only - bit per slot
+
+            void reset()
+            {
+                used_slots = 0;
+                for (auto& hazard : hazards)
+                    hazard.store(nullptr, std::memory_order_release);
+            }
+        };
+
+    public:
+        class Guard
+        {
+            ThreadRecord* record_;
+            size_t slot_;
+
+            friend class HazardDomain;
+
+            Guard(ThreadRecord& record, size_t slot)
+                : record_{&record}
+                , slot_{slot}
+            {
+            }
+
+        public:
+            Guard(Guard&& other) noexcept
+                : record_{std::exchange(other.record_, nullptr)}
+                , slot_{other.slot_}
+            {
+            }
+
+            Guard(const Guard&) = delete;
+            Guard& operator=(const Guard&) = delete;
+            Guard& operator=(Guard&&) = delete;
+
+            ~Guard()
+            {
+                if (record_ != nullptr)
+                {
+                    record_->hazards[slot_].store(nullptr, std::memory_order_release);
+                    record_->used_slots &= ~(1u << slot_);
+                }
+            }
+
+            // publishes the pointer and re-reads src until both agree - the result stays alive until the
+            // guard protects something else or dies; the previously protected pointer is released
+            template <typename T>
+            T* protect(const std::atomic<T*>& src)
+            {
+                T* ptr = src.load(std::memory_order_relaxed);
+                while (true)
+                {
+                    record_->hazards[slot_].store(ptr, std::memory_order_seq_cst);
+                    T* current = src.load(std::memory_order_seq_cst);
+                    if (current == ptr)
+                        return ptr;
+                    ptr = current;
+                }
+            }
+        };
+
+        HazardDomain() = default;
+        HazardDomain(const HazardDomain&) = delete;
+        HazardDomain& operator=(const HazardDomain&) = delete;
+
+        static HazardDomain& global()
+        {
+            static HazardDomain domain;
+            return domain;
+        }
+
+        // takes one of the thread's hazard slots; throws std::length_error when all of them are in use
+        [[nodiscard]] Guard pin()
+        {
+            ThreadRecord& record = records_.local();
+            for (size_t slot = 0; slot < slots_per_thread; ++slot)
+            {
+                if ((record.used_slots & (1u << slot)) == 0)
+                {
+                    record.used_slots |= 1u << slot;
+                    return Guard{record, slot};
+                }
+            }
+            throw std::length_error("HazardDomain: too many guards held by one thread");
+        }
+
+        template <typename T>
+        void retire(T* ptr)
+        {
+            retire(static_cast<void*>(ptr), [](void* p) { delete static_cast<T*>(p); });
+        }
+
+        // ptr must already be unreachable for guards protecting from now on
+        void retire(void* ptr, void (*deleter)(void*))
+        {
+            ThreadRecord& record = records_.local();
+            if (records_.add_retired(record, Detail::Retired{ptr, deleter, 0}))
+                collect(record);
+        }
+
+        // frees what this thread retired that no guard protects
+        void collect()
+        {
+            collect(records_.local());
+        }
+
+        size_t retired_count() const
+        {
+            return records_.retired_count();
+        }
+
+    private:
+        Detail::Records<ThreadRecord> records_;
+
+        void collect(ThreadRecord& record)
+        {
+            std::atomic_thread_fence(std::memory_order_seq_cst); // unlinking happens before reading the hazards
+
+            std::vector<void*> hazards;
+            records_.for_each([&hazards](const ThreadRecord& r) {
+                for (const auto& hazard : r.hazards)
+                {
+                    if (void* ptr = hazard.load(std::memory_order_seq_cst); ptr != nullptr)
+                        hazards.push_back(ptr);
+                }
+            });
+            std::sort(hazards.begin(), hazards.end());
+
+            records_.free_unprotected(record,
+                [&hazards](const Detail::Retired& r) { return std::binary_search(hazards.begin(), hazards.end(), r.ptr); });
+
+            // what is still protected waits for as many new retirements - hazards in use must not turn every retire into a scan
+            record.collect_at = std::max(Detail::collect_threshold, 2 * record.retired.size());
+        }
+    };
+} // namespace Reclamation
+
+#endif // RECLAMATION_HPP
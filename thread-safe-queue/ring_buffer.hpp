@@ -0,0 +1,182 @@
+#ifndef RING_BUFFER_HPP
+#define RING_BUFFER_HPP
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+// FIFO storage for std::queue / ThreadSafeQueue: a power-of-two ring that doubles when full and
+// never shrinks, so once the queue has seen its high-water mark push/pop do not allocate.
+// Items stay contiguous - better locality than chunks, but growing moves every item.
+// Only the operations needed by std::queue are provided.
+template <typename T>
+class RingBuffer
+{
+    static constexpr size_t min_capacity = 16;
+
+    T* buffer_ = nullptr;
+    size_t capacity_ = 0; // 0 or a power of two
+    size_t head_ = 0;
+    size_t size_ = 0;
+
+public:
+    using value_type = T;
+    using size_type = size_t;
+    using reference = T&;
+    using const_reference = const T&;
+
+    RingBuffer() = default;
+
+    explicit RingBuffer(size_t initial_capacity)
+    {
+        reserve(initial_capacity);
+    }
+
+    RingBuffer(const RingBuffer&) = delete;
+    RingBuffer& operator=(const RingBuffer&) = delete;
+
+    RingBuffer(RingBuffer&& other) noexcept
+        : buffer_{std::exchange(other.buffer_, nullptr)}
+        , capacity_{std::exchange(other.capacity_, 0)}
+        , head_{std::exchange(other.head_, 0)}
+        , size_{std::exchange(other.size_, 0)}
+    {
+    }
+
+    RingBuffer& operator=(RingBuffer&& other) noexcept
+    {
+        if (this != &other)
+        {
+            RingBuffer temp{std::move(other)};
+            swap(temp);
+        }
+        return *this;
+    }
+
+    ~RingBuffer()
+    {
+        while (!empty())
+            pop_front();
+        if (buffer_ != nullptr)
+            std::allocator<T>{}.deallocate(buffer_, capacity_);
+    }
+
+    void swap(RingBuffer& other) noexcept
+    {
+        std::swap(buffer_, other.buffer_);
+        std::swap(capacity_, other.capacity_);
+        std::swap(head_, other.head_);
+        std::swap(size_, other.size_);
+    }
+
+    bool empty() const
+    {
+        return size_ == 0;
+    }
+
+    size_t size() const
+    {
+        return size_;
+    }
+
+    size_t capacity() const
+    {
+        return capacity_;
+    }
+
+    T& front()
+    {
+        assert(!empty());
+        return buffer_[head_];
+    }
+
+    const T& front() const
+    {
+        assert(!empty());
+        return buffer_[head_];
+    }
+
+    T& back()
+    {
+        assert(!empty());
+        return buffer_[slot(size_ - 1)];
+    }
+
+    const T& back() const
+    {
+        assert(!empty());
+        return buffer_[slot(size_ - 1)];
+    }
+
+    void push_back(const T& item)
+    {
+        emplace_back(item);
+    }
+
+    void push_back(T&& item)
+    {
+        emplace_back(std::move(item));
+    }
+
+    template <typename... TArgs>
+    T& emplace_back(TArgs&&... args)
+    {
+        if (size_ == capacity_)
+            reserve(std::max(min_capacity, 2 * capacity_));
+
+        T* item = std::construct_at(buffer_ + slot(size_), std::forward<TArgs>(args)...);
+        ++size_;
+        return *item;
+    }
+
+    void pop_front()
+    {
+        assert(!empty());
+        std::destroy_at(buffer_ + head_);
+        head_ = slot(1);
+        --size_;
+    }
+
+    // unwraps the items into a new buffer of at least new_capacity slots
+    void reserve(size_t new_capacity)
+    {
+        if (new_capacity <= capacity_)
+            return;
+        new_capacity = std::bit_ceil(new_capacity);
+
+        std::allocator<T> allocator;
+        T* new_buffer = allocator.allocate(new_capacity);
+        size_t moved = 0;
+        try
+        {
+            for (; moved < size_; ++moved)
+                std::construct_at(new_buffer + moved, std::move_if_noexcept(buffer_[slot(moved)]));
+        }
+        catch (...)
+        {
+            std::destroy_n(new_buffer, moved);
+            allocator.deallocate(new_buffer, new_capacity);
+            throw;
+        }
+
+        for (size_t i = 0; i < size_; ++i)
+            std::destroy_at(buffer_ + slot(i));
+        if (buffer_ != nullptr)
+            allocator.deallocate(buffer_, capacity_);
+
+        buffer_ = new_buffer;
+        capacity_ = new_capacity;
+        head_ = 0;
+    }
+
+private:
+    size_t slot(size_t offset) const
+    {
+        return (head_ + offset) & (capacity_ - 1);
+    }
+};
+
+#endif // RING_BUFFER_HPP
@@ -0,0 +1,419 @@
+#ifndef SPSC_QUEUE_HPP
+#define SPSC_QUEUE_HPP
+
+#include "cache_line.hpp"
+
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <utility>
+
+// Bounded single-producer/single-consumer ring - wait-free, no locks, no allocations after construction.
+// Exactly one thread may push and exactly one thread may pop.
+//
+// Indices grow monotonically and are masked into the buffer. Each side keeps a private copy of the other
+// side's index and re-reads the shared one only when the copy says full/empty, so in a steady stream the
+// cache line owned by the other thread is touched once per wrap instead of once per item.
+// Batch operations publish many items with a single release store.
+template <typename T>
+class SpscQueue
+{
+public:
+    explicit SpscQueue(size_t capacity)
+        : capacity_{std::bit_ceil(std::max<size_t>(capacity, 2))}
+        , mask_{capacity_ - 1}
+        , buffer_{std::allocator<T>{}.allocate(capacity_)}
+    {
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    ~SpscQueue()
+    {
+        const size_t tail = producer_.tail.load(std::memory_order_acquire);
+        for (size_t head = consumer_.head.load(std::memory_order_relaxed); head != tail; ++head)
+            std::destroy_at(slot(head));
+        std::allocator<T>{}.deallocate(buffer_, capacity_);
+    }
+
+    size_t capacity() const
+    {
+        return capacity_;
+    }
+
+    // a snapshot - exact only when called by one of the two sides and the other one is idle
+    size_t size_approx() const
+    {
+        const size_t head = consumer_.head.load(std::memory_order_acquire);
+        const size_t tail = producer_.tail.load(std::memory_order_acquire);
+        return tail - head;
+    }
+
+    bool empty_approx() const
+    {
+        return size_approx() == 0;
+    }
+
+    ////////////////////////////////////////////////////////////////////////
+    // producer side
+
+    template <typename... TArgs>
+    bool try_emplace(TArgs&&... args)
+    {
+        const size_t tail = producer_.tail.load(std::memory_order_relaxed);
+        if (free_slots(tail) == 0)
+            return false;
+
+        std::construct_at(slot(tail), std::forward<TArgs>(args)...);
+        producer_.tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool try_push(const T& item)
+    {
+        return try_emplace(item);
+    }
+
+    bool try_push(T&& item)
+    {
+        return try_emplace(std::move(item));
+    }
+
+    // moves as many items as fit and publishes them at once; returns the first item not pushed
+    template <std::input_iterator TIterator, std::sentinel_for<TIterator> TSentinel>
+    TIterator try_push_batch(TIterator first, TSentinel last)
+    {
+        const size_t tail = producer_.tail.load(std::memory_order_relaxed);
+        const size_t available = free_slots(tail);
+
+        size_t pushed = 0;
+        for (; pushed < available && first != last; ++pushed, ++first)
+            std::construct_at(slot(tail + pushed), std::move(*first));
+
+        if (pushed > 0)
+            producer_.tail.store(tail + pushed, std::memory_order_release);
+        return first;
+    }
+
+    ////////////////////////////////////////////////////////////////////////
+    // consumer side
+
+    bool try_pop(T& item)
+    {
+        const size_t head = consumer_.head.load(std::memory_order_relaxed);
+        if (ready_items(head) == 0)
+            return false;
+
+        T* source = slot(head);
+        item = std::move(*source);
+        std::destroy_at(source);
+        consumer_.head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    std::optional<T> try_pop()
+    {
+        const size_t head = consumer_.head.load(std::memory_order_relaxed);
+        if (ready_items(head) == 0)
+            return std::nullopt;
+
+        T* source = slot(head);
+        std::optional<T> item{std::move(*source)};
+        std::destroy_at(source);
+        consumer_.head.store(head + 1, std::memory_order_release);
+        return item;
+    }
+
+    // moves up to max_count items to out and frees their slots at once; returns the number of items popped
+    template <std::output_iterator<T> TOutput>
+    size_t try_pop_batch(TOutput out, size_t max_count)
+    {
+        const size_t head = consumer_.head.load(std::memory_order_relaxed);
+        const size_t count = std::min(max_count, ready_items(head));
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            T* source = slot(head + i);
+            *out++ = std::move(*source);
+            std::destroy_at(source);
+        }
+
+        if (count > 0)
+            consumer_.head.store(head + count, std::memory_order_release);
+        return count;
+    }
+
+protected:
+    // for BlockingSpscQueue - the index the other side waits for changes of
+    size_t published_tail() const
+    {
+        return producer_.tail.load(std::memory_order_seq_cst);
+    }
+
+    size_t published_head() const
+    {
+        return consumer_.head.load(std::memory_order_seq_cst);
+    }
+
+    size_t consumer_head() const
+    {
+        return consumer_.head.load(std::memory_order_relaxed);
+    }
+
+    size_t producer_tail() const
+    {
+        return producer_.tail.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct alignas(cache_line_size) ProducerSide
+    {
+        std::atomic<size_t> tail{0};
+        size_t cached_head = 0;
+    };
+
+    struct alignas(cache_line_size) ConsumerSide
+    {
+        std::atomic<size_t> head{0};
+        size_t cached_tail = 0;
+    };
+
+    const size_t capacity_;
+    const size_t mask_;
+    T* const buffer_;
+    ProducerSide producer_;
+    ConsumerSide consumer_;
+
+    T* slot(size_t index) const
+    {
+        return buffer_ + (index & mask_);
+    }
+
+    size_t free_slots(size_t tail)
+    {
+        if (tail - producer_.cached_head == capacity_)
+            producer_.cached_head = consumer_.head.load(std::memory_order_acquire);
+        return capacity_ - (tail - producer_.cached_head);
+    }
+
+    size_t ready_items(size_t head)
+    {
+        if (consumer_.cached_tail == head)
+            consumer_.cached_tail = producer_.tail.load(std::memory_order_acquire);
+        return consumer_.cached_tail - head;
+    }
+};
+
+// SpscQueue with blocking push/pop on top of the non-blocking fast path.
+// A side that finds the ring full/empty announces itself and sleeps in std::atomic::wait;
+// the other side pays for notify_one only when somebody is actually asleep, once per sleep.
+// close() ends the stream - pop() returns std::nullopt once the ring is drained.
+template <typename T>
+class BlockingSpscQueue : private SpscQueue<T>
+{
+    using Base = SpscQueue<T>;
+
+    std::atomic<bool> closed_{false};
+    std::atomic<bool> consumer_waiting_{false};
+    std::atomic<bool> producer_waiting_{false};
+    std::atomic<uint32_t> items_signal_{0}; // bumped when items arrive for a sleeping consumer
+    std::atomic<uint32_t> space_signal_{0}; // bumped when slots are freed for a sleeping producer
+
+public:
+    using Base::Base;
+    using Base::capacity;
+    using Base::empty_approx;
+    using Base::size_approx;
+
+    template <typename... TArgs>
+    bool try_emplace(TArgs&&... args)
+    {
+        if (!Base::try_emplace(std::forward<TArgs>(args)...))
+            return false;
+        wake(consumer_waiting_, items_signal_);
+        return true;
+    }
+
+    bool try_push(const T& item)
+    {
+        return try_emplace(item);
+    }
+
+    bool try_push(T&& item)
+    {
+        return try_emplace(std::move(item));
+    }
+
+    template <typename... TArgs>
+    void emplace(TArgs&&... args)
+    {
+        assert(!closed_.load(std::memory_order_relaxed) && "push to a closed queue");
+
+        while (!Base::try_emplace(std::forward<TArgs>(args)...))
+            sleep(producer_waiting_, space_signal_, [this] { return Base::published_head() != Base::producer_tail() - Base::capacity(); });
+
+        wake(consumer_waiting_, items_signal_);
+    }
+
+    void push(const T& item)
+    {
+        emplace(item);
+    }
+
+    void push(T&& item)
+    {
+        emplace(std::move(item));
+    }
+
+    // blocks while the ring is full; items are published chunk by chunk
+    template <std::input_iterator TIterator, std::sentinel_for<TIterator> TSentinel>
+    void push_batch(TIterator first, TSentinel last)
+    {
+        while (first != last)
+        {
+            auto rest = Base::try_push_batch(first, last);
+            if (rest == first)
+                sleep(producer_waiting_, space_signal_, [this] { return Base::published_head() != Base::producer_tail() - Base::capacity(); });
+            else
+                wake(consumer_waiting_, items_signal_);
+            first = rest;
+        }
+    }
+
+    bool try_pop(T& item)
+    {
+        if (!Base::try_pop(item))
+            return false;
+        wake_producer();
+        return true;
+    }
+
+    std::optional<T> try_pop()
+    {
+        auto item = Base::try_pop();
+        if (item)
+            wake_producer();
+        return item;
+    }
+
+    template <std::output_iterator<T> TOutput>
+    size_t try_pop_batch(TOutput out, size_t max_count)
+    {
+        const size_t count = Base::try_pop_batch(out, max_count);
+        if (count > 0)
+            wake_producer();
+        return count;
+    }
+
+    bool pop(T& item)
+    {
+        while (!Base::try_pop(item))
+        {
+            if (!sleep(consumer_waiting_, items_signal_, [this] { return Base::published_tail() != Base::consumer_head(); }))
+                return Base::try_pop(item); // closed - the producer may have pushed right before closing
+        }
+
+        wake_producer();
+        return true;
+    }
+
+    std::optional<T> pop()
+    {
+        for (;;)
+        {
+            if (auto item = Base::try_pop())
+            {
+                wake_producer();
+                return item;
+            }
+
+            if (!sleep(consumer_waiting_, items_signal_, [this] { return Base::published_tail() != Base::consumer_head(); }))
+                return Base::try_pop();
+        }
+    }
+
+    // blocks until at least one item is available (or the queue is closed and drained)
+    template <std::output_iterator<T> TOutput>
+    size_t pop_batch(TOutput out, size_t max_count)
+    {
+        for (;;)
+        {
+            if (const size_t count = Base::try_pop_batch(out, max_count); count > 0)
+            {
+                wake_producer();
+                return count;
+            }
+
+            if (!sleep(consumer_waiting_, items_signal_, [this] { return Base::published_tail() != Base::consumer_head(); }))
+                return Base::try_pop_batch(out, max_count);
+        }
+    }
+
+    void close()
+    {
+        closed_.store(true, std::memory_order_seq_cst);
+        items_signal_.fetch_add(1, std::memory_order_release);
+        items_signal_.notify_all();
+    }
+
+    bool is_closed() const
+    {
+        return closed_.load(std::memory_order_acquire);
+    }
+
+private:
+    // Dekker-style handshake: the sleeper raises its flag and re-checks the ring, the waker publishes and then
+    // checks the flag - with sequentially consistent ordering on both sides at least one of them sees the other.
+    // Returns false when the queue is closed.
+    template <typename TReady>
+    bool sleep(std::atomic<bool>& waiting, std::atomic<uint32_t>& signal, TReady is_ready)
+    {
+        const uint32_t observed = signal.load(std::memory_order_acquire);
+        waiting.store(true, std::memory_order_seq_cst);
+
+        if (!is_ready())
+        {
+            if (closed_.load(std::memory_order_seq_cst))
+            {
+                waiting.store(false, std::memory_order_relaxed);
+                return false;
+            }
+            signal.wait(observed, std::memory_order_acquire);
+        }
+
+        waiting.store(false, std::memory_order_relaxed);
+        return true;
+    }
+
+    // a producer blocked on a full ring is woken once half of it has drained - waking it for every freed slot
+    // makes the two threads trade places after each item when they share a core
+    void wake_producer()
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (producer_waiting_.load(std::memory_order_relaxed) && Base::size_approx() <= Base::capacity() / 2
+            && producer_waiting_.exchange(false, std::memory_order_relaxed))
+        {
+            space_signal_.fetch_add(1, std::memory_order_release);
+            space_signal_.notify_one();
+        }
+    }
+
+    void wake(std::atomic<bool>& waiting, std::atomic<uint32_t>& signal)
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        // the first waker takes the flag - later ones skip the syscall until the sleeper raises it again
+        if (waiting.load(std::memory_order_relaxed) && waiting.exchange(false, std::memory_order_relaxed))
+        {
+            signal.fetch_add(1, std::memory_order_release);
+            signal.notify_one();
+        }
+    }
+};
+
+#endif // SPSC_QUEUE_HPP
@@ -0,0 +1,242 @@
+#ifndef THREAD_SAFE_QUEUE_HPP
+#define THREAD_SAFE_QUEUE_HPP
+
+#include "chunked_deque.hpp"
+#include "cpu_relax.hpp"
+#include "ring_buffer.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <thread>
+#include <type_traits>
+
+// std::condition_variable works with std::mutex only - other lockables need std::condition_variable_any
+template <typename TMutex>
+using QueueConditionVariable = std::conditional_t<std::is_same_v<TMutex, std::mutex>, std::condition_variable, std::condition_variable_any>;
+
+// TMutex - any Lockable, e.g. ProfiledMutex<std::mutex, "name"> to find out whether the queue is a hot lock
+// TContainer - FIFO storage for std::queue: std::deque<T> allocates and frees a block every few hundred bytes
+//              of traffic; ChunkedDeque<T> and RingBuffer<T> recycle their memory - no allocations in a steady state
+// TConditionVariable - consumers sleep on it (wait(std::unique_lock<TMutex>&)), producers notify it; the tests
+//                      inject one that counts the calls
+//
+// Items are moved in and out - move-only types (std::unique_ptr, std::packaged_task, ...) are fine.
+// close() ends the stream: blocked consumers wake up and pop() returns std::nullopt once the queue is drained.
+//
+// Wakeups: producers notify only consumers that sleep and have not been notified yet (both counted
+// under the lock), so a busy queue does not pay for notifications nobody waits for. A consumer finding the queue empty spins for
+// spin_count pauses before it sleeps - on multi-core machines the next item often comes sooner than
+// a sleep and a wakeup would take.
+template <typename T, typename TMutex = std::mutex, typename TContainer = std::deque<T>, typename TConditionVariable = QueueConditionVariable<TMutex>>
+class ThreadSafeQueue
+{
+    std::queue<T, TContainer> q_;
+    bool closed_ = false;
+    size_t sleeping_ = 0;                 // consumers waiting on cv_q_not_empty_
+    size_t wakeups_pending_ = 0;          // of them notified, but not running yet
+    std::atomic<bool> has_items_{false};  // written under the lock, read by spinning consumers without it
+    const size_t spin_count_;
+    mutable TMutex mtx_q_;
+    TConditionVariable cv_q_not_empty_;
+public:
+    // no spinning on a single core - the producer cannot run while the consumer spins
+    static size_t default_spin_count()
+    {
+        return std::thread::hardware_concurrency() > 1 ? 256 : 0;
+    }
+
+    ThreadSafeQueue()
+        : ThreadSafeQueue(default_spin_count())
+    {
+    }
+
+    // spin_count - pauses a consumer spins for on an empty queue before it sleeps (0 - sleeps at once)
+    explicit ThreadSafeQueue(size_t spin_count)
+        : spin_count_{spin_count}
+    {
+    }
+
+    ThreadSafeQueue(const ThreadSafeQueue&) = delete;
+    ThreadSafeQueue& operator=(const ThreadSafeQueue&) = delete;
+
+    bool empty() const
+    {
+        std::lock_guard lk{mtx_q_};
+        return q_.empty();
+    }
+
+    size_t size() const
+    {
+        std::lock_guard lk{mtx_q_};
+        return q_.size();
+    }
+
+    void push(const T& item)
+    {
+        emplace(item);
+    }
+
+    void push(T&& item)
+    {
+        emplace(std::move(item));
+    }
+
+    // wakes as many sleeping consumers as there are new items - not all of them
+    void push(std::initializer_list<T> items)
+    {
+        size_t wakeups;
+        bool wake_all;
+        {
+            std::lock_guard lk{mtx_q_};
+            assert(!closed_ && "push to a closed queue");
+            for(const auto& item : items)
+                q_.push(item);
+            has_items_.store(!q_.empty(), std::memory_order_relaxed);
+            wake_all = items.size() >= sleeping_ - wakeups_pending_;
+            wakeups = claim_wakeups(items.size());
+        }
+
+        if (wakeups == 0)
+            return;
+        if (wake_all)
+            cv_q_not_empty_.notify_all(); // one call wakes them all
+        else
+            for (size_t i = 0; i < wakeups; ++i)
+                cv_q_not_empty_.notify_one();
+    }
+
+    // constructs the item in place - under the lock, so keep the constructor cheap
+    template <typename... TArgs>
+    void emplace(TArgs&&... args)
+    {
+        bool wake;
+        {
+            std::lock_guard lk{mtx_q_};
+            assert(!closed_ && "push to a closed queue");
+            q_.emplace(std::forward<TArgs>(args)...);
+            has_items_.store(true, std::memory_order_relaxed);
+            wake = claim_wakeups(1) > 0;
+        }
+
+        if (wake)
+            cv_q_not_empty_.notify_one();
+    }
+
+    // blocks until an item is available; false only when the queue is closed and drained
+    bool pop(T& item)
+    {
+        std::unique_lock lk{mtx_q_};
+        wait_for_item(lk);
+        if (q_.empty())
+            return false;
+
+        item = std::move(q_.front());
+        pop_front();
+        return true;
+    }
+
+    std::optional<T> pop()
+    {
+        std::unique_lock lk{mtx_q_};
+        wait_for_item(lk);
+        return take_front();
+    }
+
+    // non-blocking - gives up on a contended lock as well as on an empty queue
+    bool try_pop(T& item)
+    {
+        std::unique_lock lk{mtx_q_, std::try_to_lock};
+        if (!lk.owns_lock() || q_.empty())
+            return false;
+        item = std::move(q_.front());
+        pop_front();
+        return true;
+    }
+
+    std::optional<T> try_pop()
+    {
+        std::unique_lock lk{mtx_q_, std::try_to_lock};
+        if (!lk.owns_lock())
+            return std::nullopt;
+        return take_front();
+    }
+
+    void close()
+    {
+        {
+            std::lock_guard lk{mtx_q_};
+            closed_ = true;
+        }
+
+        cv_q_not_empty_.notify_all();
+    }
+
+    bool is_closed() const
+    {
+        std::lock_guard lk{mtx_q_};
+        return closed_;
+    }
+
+private:
+    // returns with the lock held - the queue is not empty or it is closed
+    void wait_for_item(std::unique_lock<TMutex>& lk)
+    {
+        if (!q_.empty() || closed_)
+            return;
+
+        if (spin_count_ > 0)
+        {
+            lk.unlock();
+            for (size_t i = 0; i < spin_count_ && !has_items_.load(std::memory_order_relaxed); ++i)
+                cpu_relax();
+            lk.lock();
+        }
+
+        while (q_.empty() && !closed_)
+        {
+            ++sleeping_;
+            cv_q_not_empty_.wait(lk);
+            --sleeping_;
+            if (wakeups_pending_ > 0) // a spurious wakeup may take another one's - producers then just notify again
+                --wakeups_pending_;
+        }
+    }
+
+    // under the lock - consumers to notify about count new items
+    size_t claim_wakeups(size_t count)
+    {
+        const size_t wakeups = std::min(count, sleeping_ - wakeups_pending_);
+        wakeups_pending_ += wakeups;
+        return wakeups;
+    }
+
+    void pop_front()
+    {
+        q_.pop();
+        has_items_.store(!q_.empty(), std::memory_order_relaxed);
+    }
+
+    std::optional<T> take_front()
+    {
+        if (q_.empty())
+            return std::nullopt;
+
+        std::optional<T> item{std::move(q_.front())};
+        pop_front();
+        return item;
+    }
+};
+
+template <typename T, typename TMutex = std::mutex>
+using ChunkedThreadSafeQueue = ThreadSafeQueue<T, TMutex, ChunkedDeque<T>>;
+
+template <typename T, typename TMutex = std::mutex>
+using RingThreadSafeQueue = ThreadSafeQueue<T, TMutex, RingBuffer<T>>;
+
+#endif // THREAD_SAFE_QUEUE_HPP
@@ -0,0 +1,165 @@
+#ifndef THREAD_SLOTS_HPP
+#define THREAD_SLOTS_HPP
+
+#include "cache_line.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+// Per-thread state of a shared object (a reclamation domain, an allocator, ...): a thread gets its own slot
+// on first use and hands it back when it exits - the next new thread takes it over. Slots are never unlinked,
+// so for_each() walks them without locks; they are deleted together with the ThreadSlots.
+//
+// TSlot derives from ThreadSlot. on_release runs on the exiting thread before its slot is free for reuse;
+// owners whose on_release touches their own members call close() first thing in their destructor.
+// Threads may exit before or after the owner dies.
+struct alignas(cache_line_size) ThreadSlot
+{
+    std::atomic<bool> in_use{true};
+    ThreadSlot* next = nullptr; // immutable once the slot is published
+};
+
+template <typename TSlot>
+class ThreadSlots
+{
+public:
+    using OnRelease = std::function<void(TSlot&)>;
+
+    explicit ThreadSlots(OnRelease on_release = {})
+        : id_{register_owner()}
+        , on_release_{std::move(on_release)}
+    {
+    }
+
+    ThreadSlots(const ThreadSlots&) = delete;
+    ThreadSlots& operator=(const ThreadSlots&) = delete;
+
+    ~ThreadSlots()
+    {
+        close();
+        for (ThreadSlot* slot = head_.load(std::memory_order_acquire); slot != nullptr;)
+            delete static_cast<TSlot*>(std::exchange(slot, slot->next));
+    }
+
+    // exiting threads stop handing their slots back - on_release is not called any more
+    void close()
+    {
+        auto& registry = live_owners();
+        std::lock_guard lk{registry.mtx};
+        registry.ids.erase(id_);
+    }
+
+    TSlot& local()
+    {
+        thread_local ThreadCache cache;
+        for (const auto& entry : cache.entries)
+        {
+            if (entry.slots == this && entry.id == id_)
+                return *entry.slot;
+        }
+
+        TSlot& slot = acquire();
+        cache.erase_dead_owners();
+        cache.entries.push_back({this, id_, &slot});
+        return slot;
+    }
+
+    // all slots ever created, including released ones
+    template <typename F>
+    void for_each(F f) const
+    {
+        for (ThreadSlot* slot = head_.load(std::memory_order_acquire); slot != nullptr; slot = slot->next)
+            f(static_cast<const TSlot&>(*slot));
+    }
+
+private:
+    // ids tell a dead owner from a new one at the same address
+    struct LiveOwners
+    {
+        std::mutex mtx;
+        std::unordered_set<uint64_t> ids;
+        uint64_t next_id = 0;
+    };
+
+    // this thread's slot per owner - handed back when the thread exits. Entries of dead owners
+    // are dropped on every miss, so the scan in local() stays as short as the owners the thread uses.
+    struct ThreadCache
+    {
+        struct Entry
+        {
+            ThreadSlots* slots;
+            uint64_t id;
+            TSlot* slot;
+        };
+
+        std::vector<Entry> entries;
+
+        void erase_dead_owners()
+        {
+            auto& registry = live_owners();
+            std::lock_guard lk{registry.mtx};
+            std::erase_if(entries, [&registry](const Entry& entry) { return !registry.ids.contains(entry.id); });
+        }
+
+        ~ThreadCache()
+        {
+            auto& registry = live_owners();
+            std::lock_guard lk{registry.mtx};
+            for (const auto& entry : entries)
+            {
+                if (registry.ids.contains(entry.id))
+                    entry.slots->release(*entry.slot);
+            }
+        }
+    };
+
+    const uint64_t id_;
+    const OnRelease on_release_;
+    std::atomic<ThreadSlot*> head_{nullptr};
+
+    static LiveOwners& live_owners()
+    {
+        static LiveOwners registry;
+        return registry;
+    }
+
+    static uint64_t register_owner()
+    {
+        auto& registry = live_owners();
+        std::lock_guard lk{registry.mtx};
+        const uint64_t id = registry.next_id++;
+        registry.ids.insert(id);
+        return id;
+    }
+
+    TSlot& acquire()
+    {
+        for (ThreadSlot* slot = head_.load(std::memory_order_acquire); slot != nullptr; slot = slot->next)
+        {
+            bool expected = false;
+            if (!slot->in_use.load(std::memory_order_relaxed) && slot->in_use.compare_exchange_strong(expected, true, std::memory_order_acquire))
+                return static_cast<TSlot&>(*slot);
+        }
+
+        auto* slot = new TSlot;
+        slot->next = head_.load(std::memory_order_relaxed);
+        while (!head_.compare_exchange_weak(slot->next, slot, std::memory_order_release, std::memory_order_relaxed))
+        {
+        }
+        return *slot;
+    }
+
+    void release(TSlot& slot) // registry lock is held - the owner is alive
+    {
+        if (on_release_)
+            on_release_(slot);
+        slot.in_use.store(false, std::memory_order_release);
+    }
+};
+
+#endif // THREAD_SLOTS_HPP
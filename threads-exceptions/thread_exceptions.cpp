@@ -1,63 +1,39 @@
+#include "task_group.hpp"
+#include "thread_pool.hpp"
+
 #include <cassert>
 #include <chrono>
 #include <functional>
 #include <iostream>
 #include <string>
+#include <syncstream>
 #include <thread>
 #include <vector>
 
 using namespace std::literals;
 
-template <typename T>
-class Result
+char background_work(size_t id, const std::string& text, std::stop_token stop_tkn)
 {
-    T value_;
-    std::exception_ptr exception_;
-public:
-    template <typename TValue>
-    void set_value(TValue&& value)
-    {
-        value_ = std::forward<TValue>(value);
-    }
-
-    void set_exception(std::exception_ptr eptr)
-    {
-        exception_ = eptr;
-    }
+    std::osyncstream(std::cout) << "bw#" << id << " has started..." << std::endl;
 
-    T get()
+    for (const auto& c : text)
     {
-        if (exception_)
+        if (stop_tkn.stop_requested())
         {
-            std::rethrow_exception(exception_);
+            std::osyncstream(std::cout) << "bw#" << id << " cancelled..." << std::endl;
+            throw TaskCancelled{};
         }
 
-        return value_;
-    }
-};
-
-void background_work(size_t id, const std::string& text, 
-                     Result<char>& result)
-{
-    try
-    {
-        std::cout << "bw#" << id << " has started..." << std::endl;
+        std::osyncstream(std::cout) << "bw#" << id << ": " << c << std::endl;
 
-        for (const auto& c : text)
-        {
-            std::cout << "bw#" << id << ": " << c << std::endl;
+        std::this_thread::sleep_for(100ms);
+    }
 
-            std::this_thread::sleep_for(100ms);
-        }
+    char result = text.at(5); // potential exception
 
-        result.set_value(text.at(5)); // potential exception
+    std::osyncstream(std::cout) << "bw#" << id << " is finished..." << std::endl;
 
-        std::cout << "bw#" << id << " is finished..." << std::endl;
-    }
-    catch(...)
-    {
-        result.set_exception(std::current_exception());
-    }   
+    return result;
 }
 
 int main()
@@ -65,27 +41,42 @@ int main()
     std::cout << "No of cores: " << std::thread::hardware_concurrency() << std::endl;
 
     std::cout << "Main thread starts..." << std::endl;
-    const std::string text = "Hello";
-    
+
     const size_t thread_count = 4;
 
     std::vector<std::string> arguments = {"Hello", "Concurrent", "Multithreading", ""};
-    std::vector<std::jthread> threads(thread_count);
-    std::vector<Result<char>> results(thread_count);
 
-    for(size_t i = 0; i < threads.size(); ++i)
+    ThreadPool pool(thread_count);
+    TaskGroup group{pool};
+
+    std::vector<std::future<char>> results;
+    for (size_t i = 0; i < arguments.size(); ++i)
     {
-        threads[i] = std::jthread{background_work, i, std::cref(arguments[i]), std::ref(results[i]) };
+        results.push_back(group.run([i, &arguments](std::stop_token stop_tkn) { return background_work(i, arguments[i], stop_tkn); }));
     }
 
-    // explicit join
-    for(auto& thd : threads)
+    try
+    {
+        group.wait(); // first failure cancels siblings
+    }
+    catch (const TaskGroupError& e)
     {
-        if (thd.joinable())
-            thd.join();
+        std::cout << "TaskGroup: " << e.what() << "\n";
+
+        for (const auto& eptr : e.exceptions())
+        {
+            try
+            {
+                std::rethrow_exception(eptr);
+            }
+            catch (const std::exception& e)
+            {
+                std::cout << "Caught an exception: " << e.what() << "\n";
+            }
+        }
     }
 
-    for(auto& r : results)
+    for (auto& r : results)
     {
         try
         {
@@ -93,9 +84,9 @@ int main()
 
             std::cout << "Result: " << result << "\n";
         }
-        catch(const std::exception& e)
+        catch (const std::exception& e)
         {
-            std::cout << "Caught an exception: " << e.what() << "\n";
+            std::cout << "No result: " << e.what() << "\n";
         }
     }
 
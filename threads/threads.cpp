@@ -1,8 +1,14 @@
+#include "task_context.hpp"
+#include "thread_pool.hpp"
+#include "timer_service.hpp"
+
 #include <cassert>
 #include <chrono>
 #include <functional>
+#include <future>
 #include <iostream>
 #include <string>
+#include <syncstream>
 #include <thread>
 #include <vector>
 
@@ -135,7 +141,12 @@ void cancellable_background_work(std::stop_token stop_tkn, int id, const std::st
 
             std::cout << "BW#" << id << ": " << c << std::endl;
 
-            std::this_thread::sleep_for(delay);
+            // wakes up as soon as stop is requested - plain sleep_for() delayed it by up to delay
+            if (!TimerService::shared().sleep_for(stop_tkn, delay))
+            {
+                std::cout << "Stop requested..." << std::endl;
+                break;
+            }
         }
 
         std::cout << "BW#" << id << " is finished..." << std::endl;
@@ -164,24 +175,33 @@ void jthread_demo()
 } // joining all jthreads
 
 
-thread_local std::string request_id;
-
-void log(const std::string& message) {
-    std::cout << "[Request " << request_id << "] " << message << "\n";
+// context follows the request across pool tasks and futures - thread_local std::string
+// request_id was lost as soon as the work hopped onto another thread
+void log(const std::string& message)
+{
+    const TaskContext* context = TaskContext::current();
+    std::osyncstream(std::cout) << "[Request " << (context ? context->request_id() : "?") << "] " << message << "\n";
 }
 
-void handle_request(const std::string& id) 
+void handle_request(ThreadPool& pool, const std::string& id)
 {
-    request_id = id;  // Set thread-local context
+    ContextScope context{TaskContext::make(id)}; // set context for this request
     log("Processing started");
-    // ... more work ...
+
+    auto f_step_1 = pool.submit([] { log("Step #1 on a pool worker"); });
+    auto f_step_2 = std::async(std::launch::async, with_current_context([] { log("Step #2 in std::async"); }));
+    f_step_1.get();
+    f_step_2.get();
+
     log("Processing finished");
 }
 
-void thread_local_storage_demo() 
+void thread_local_storage_demo()
 {
-    std::thread t1(handle_request, "abc123");
-    std::thread t2(handle_request, "xyz789");
+    ThreadPool pool(2);
+
+    std::thread t1(handle_request, std::ref(pool), "abc123");
+    std::thread t2(handle_request, std::ref(pool), "xyz789");
 
     t1.join();
     t2.join();